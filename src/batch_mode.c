@@ -6,14 +6,128 @@
  * @date 24.04.2020
  */
 
+/** _POSIX_C_SOURCE - wymagane, aby time.h definiowało funkcję clock_gettime */
+#define _POSIX_C_SOURCE 199309L
+
 #include "gamma.h"
+#include "batch_mode.h"
+#include "huge_pages.h"
+#include "json_writer.h"
 #include "text_input_handler.h"
-#include <inttypes.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 /** Wszystkie identyfikatory komend dozwolonych w trybie wsadowym */
-#define BATCH_COMMAND_IDENTIFIERS "mgbfqp"
+#define BATCH_COMMAND_IDENTIFIERS "mgbfqpsa"
+
+/** Liczba liczników operacji wewnętrznych silnika wypisywanych przez polecenie s. */
+#define ENGINE_STATS_COUNT 7
+/** Nazwy liczników operacji wewnętrznych silnika w formacie tekstowym. */
+static const char *const engine_stats_text_names[ENGINE_STATS_COUNT] = {
+    "FIND_CALLS",    "FIND_PATH_LENGTH",      "UNION_MERGES",
+    "REINDEX_CALLS", "REINDEX_VISITED_FIELDS", "GOLDEN_MOVE_ROLLBACKS",
+    "GOLDEN_POSSIBLE_CANDIDATES"};
+/** Nazwy liczników operacji wewnętrznych silnika w formacie NDJSON. */
+static const char *const engine_stats_json_names[ENGINE_STATS_COUNT] = {
+    "find_calls",    "find_path_length",       "union_merges",
+    "reindex_calls", "reindex_visited_fields", "golden_move_rollbacks",
+    "golden_possible_candidates"};
+
+/** Liczba kwantyli opóźnień wypisywanych przez @ref batch_report_latency. */
+#define LATENCY_QUANTILES_COUNT 3
+/** Rzędy kwantyli opóźnień wypisywanych przez @ref batch_report_latency. */
+static const double latency_quantiles[LATENCY_QUANTILES_COUNT] = {0.5, 0.99, 0.999};
+/** Nazwy kwantyli opóźnień w formacie NDJSON. */
+static const char *const latency_quantile_names[LATENCY_QUANTILES_COUNT] = {
+    "p50_ns", "p99_ns", "p999_ns"};
+
+/** Liczba kosztownych ścieżek wykonania silnika, zob. @ref gamma_path_t. */
+#define ENGINE_PATHS_COUNT 3
+/** Nazwy kosztownych ścieżek wykonania silnika w kolejności bitów flag. */
+static const char *const engine_path_names[ENGINE_PATHS_COUNT] = {
+    "reindex", "rollback", "attack_scan"};
+
+/** Największa liczba graczy, których liczby obszarów zapisywane są w jednym wpisie
+ * dziennika wolnych poleceń. */
+#define SLOW_LOG_PLAYERS_LIMIT 256
+
+/** Ograniczenie górne długości znakowej reprezentacji jednego pola planszy
+ * wraz z kończącym znakiem \0; 15 > ceil(log10(UINT32_MAX)) + 1 = 11 */
+#define FIELD_WIDTH_UPPER_BOUND 15
+
+/** @brief Zwraca wskazanie zegara monotonicznego.
+ * @return Czas w nanosekundach liczony od nieokreślonego momentu w przeszłości.
+ */
+static inline uint64_t monotonic_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/** @brief Rozpoczyna zdarzenie śladu wykonania obejmujące przedział czasu.
+ * Zapisuje wspólne pola zdarzenia oraz numer aktualnego wiersza; obiekt
+ * argumentów zdarzenia pozostaje otwarty.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z zapisywanym śladem,
+ * @param[in] name        – wskaźnik na znaki nazwy zdarzenia,
+ * @param[in] name_size   – liczba znaków nazwy zdarzenia,
+ * @param[in] category    – kategoria zdarzenia,
+ * @param[in] start       – początek przedziału w nanosekundach,
+ * @param[in] end         – koniec przedziału w nanosekundach.
+ */
+static void begin_trace_event(batch_session_t *session, const char *name,
+                              size_t name_size, const char *category, uint64_t start,
+                              uint64_t end) {
+    json_writer_t *writer = &session->trace_writer;
+    json_begin_object(writer);
+    json_key(writer, "name");
+    json_string(writer, name, name_size);
+    json_key(writer, "cat");
+    json_string(writer, category, strlen(category));
+    json_key(writer, "ph");
+    json_string(writer, "X", 1);
+    // Znaczniki czasu zapisywane są w mikrosekundach.
+    json_key(writer, "ts");
+    json_decimal(writer, start - session->trace_origin_ns, 3);
+    json_key(writer, "dur");
+    json_decimal(writer, end - start, 3);
+    json_key(writer, "pid");
+    json_uint(writer, 1);
+    json_key(writer, "tid");
+    json_uint(writer, 1);
+    json_key(writer, "args");
+    json_begin_object(writer);
+    json_key(writer, "line");
+    json_uint(writer, session->line);
+}
+
+/** @brief Kończy zdarzenie rozpoczęte przez @ref begin_trace_event.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z zapisywanym śladem.
+ */
+static void end_trace_event(batch_session_t *session) {
+    json_end_object(&session->trace_writer);
+    json_end_object(&session->trace_writer);
+    output_buffer_write_char(session->trace, '\n');
+}
+
+/** @brief Opróżnia bufor wyjścia, zapisując zdarzenie w śladzie wykonania.
+ * @param[in,out] session – wskaźnik na stan rozgrywki,
+ * @param[in,out] out     – wskaźnik na opróżniany bufor.
+ */
+static void flush_traced(batch_session_t *session, output_buffer_t *out) {
+    if (session->trace == NULL || out->length == 0) {
+        output_buffer_flush(out);
+        return;
+    }
+    const uint64_t bytes = out->length;
+    const uint64_t start = monotonic_time_ns();
+    output_buffer_flush(out);
+    begin_trace_event(session, "flush", strlen("flush"), "io", start,
+                      monotonic_time_ns());
+    json_key(&session->trace_writer, "bytes");
+    json_uint(&session->trace_writer, bytes);
+    end_trace_event(session);
+}
 
 /** @brief Wykonuje gamma_move lub gamma_golden_move.
  * @param[in,out] g       – wskaźnik na strukturę przechowującą stan gry,
@@ -21,16 +135,16 @@
  * @param[in] player      – numer gracza,
  * @param[in] x           – numer kolumny,
  * @param[in] y           – numer wiersza.
+ * @return Wartość @p true, jeżeli ruch został wykonany, @p false w przeciwnym
+ * przypadku.
  */
-static void run_move_or_golden_move(gamma_t *g, char command, uint32_t player,
+static bool run_move_or_golden_move(gamma_t *g, char command, uint32_t player,
                                     uint32_t x, uint32_t y) {
-    bool move_performed;
     if (command == 'm') {
-        move_performed = gamma_move(g, player, x, y);
+        return gamma_move(g, player, x, y);
     } else {
-        move_performed = gamma_golden_move(g, player, x, y);
+        return gamma_golden_move(g, player, x, y);
     }
-    printf("%u\n", (unsigned)move_performed);
 }
 
 /** @brief Wykonuje gamma_free_fields, gamma_busy_fields lub gamma_golden_possible.
@@ -38,66 +152,733 @@ static void run_move_or_golden_move(gamma_t *g, char command, uint32_t player,
  * @param[in,out] g       – wskaźnik na strukturę przechowującą stan gry,
  * @param[in] command     – znak oznaczający typ komendy, (b, f lub q),
  * @param[in] player      – numer identyfikujący gracza.
+ * @return Wynik wykonanej komendy.
  */
-static void run_one_argument_command(gamma_t *g, char command, uint32_t player) {
-    uint64_t result;
+static uint64_t run_one_argument_command(gamma_t *g, char command, uint32_t player) {
     if (command == 'b') {
-        result = gamma_busy_fields(g, player);
+        return gamma_busy_fields(g, player);
     } else if (command == 'f') {
-        result = gamma_free_fields(g, player);
+        return gamma_free_fields(g, player);
     } else /* command == 'q' */ {
-        result = (uint64_t)gamma_golden_possible(g, player);
+        return (uint64_t)gamma_golden_possible(g, player);
+    }
+}
+
+/** @brief Zwraca liczbę argumentów polecenia trybu wsadowego.
+ * @param[in] command     – znak oznaczający typ komendy.
+ * @return Liczba argumentów.
+ */
+static inline unsigned command_arguments_count(char command) {
+    if (command == 'm' || command == 'g') {
+        return 3;
+    } else if (command == 'p' || command == 's' || command == 'a') {
+        return 0;
+    }
+    return 1;
+}
+
+/** @brief Rozpoczyna obiekt NDJSON opisujący wykonane polecenie.
+ * Zapisuje numer wiersza, polecenie i jego argumenty; obiekt pozostaje otwarty.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu,
+ * @param[in] line        – numer wiersza,
+ * @param[in] command     – znak oznaczający typ komendy,
+ * @param[in] args        – argumenty komendy.
+ */
+static void begin_ndjson_command(json_writer_t *writer, unsigned long line,
+                                 char command, const uint32_t *args) {
+    json_begin_object(writer);
+    json_key(writer, "line");
+    json_uint(writer, line);
+    json_key(writer, "command");
+    json_string(writer, &command, 1);
+    json_key(writer, "args");
+    json_begin_array(writer);
+    for (unsigned i = 0; i < command_arguments_count(command); i++) {
+        json_uint(writer, args[i]);
     }
+    json_end_array(writer);
+}
 
-    printf("%" PRIu64 "\n", result);
+/** @brief Kończy obiekt NDJSON opisujący wykonane polecenie.
+ * @param[in,out] session – wskaźnik na stan rozgrywki,
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu,
+ * @param[in] elapsed_ns  – czas wykonania polecenia w nanosekundach.
+ */
+static void end_ndjson_command(batch_session_t *session, json_writer_t *writer,
+                               uint64_t elapsed_ns) {
+    if (session->options.timing) {
+        json_key(writer, "time_ns");
+        json_uint(writer, elapsed_ns);
+    }
+    json_end_object(writer);
+    output_buffer_write_char(session->out, '\n');
+}
+
+/** @brief Zapisuje planszę jako tablicę napisów - po jednym na wiersz planszy.
+ * Pola renderowane są bezpośrednio do bufora wyjścia, tak samo jak w
+ * @ref gamma_board.
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie lub kod błędu
+ * @ref output_buffer_reserve, jeżeli nie udało się zarezerwować miejsca na pole.
+ */
+static io_error_t write_ndjson_board(const gamma_t *g, json_writer_t *writer) {
+    unsigned field_width, first_column_width;
+    gamma_rendered_fields_width(g, &first_column_width, &field_width);
+    output_buffer_t *out = writer->out;
+
+    json_begin_array(writer);
+    for (uint32_t y = gamma_board_height(g); y-- > 0;) {
+        json_begin_raw_string(writer);
+        for (uint32_t x = 0; x < gamma_board_width(g); x++) {
+            int written_chars;
+            const io_error_t error = output_buffer_reserve(out, FIELD_WIDTH_UPPER_BOUND);
+            if (error != NO_ERROR) {
+                return error;
+            }
+            gamma_render_field(g, out->data + out->length, x, y,
+                               x == 0 ? first_column_width : field_width,
+                               &written_chars, NULL);
+            out->length += (unsigned)written_chars;
+        }
+        json_end_raw_string(writer);
+    }
+    json_end_array(writer);
+    return NO_ERROR;
+}
+
+/** @brief Wykonuje zadane polecenie i zapisuje wynik w formacie NDJSON.
+ * @param[in,out] session – wskaźnik na stan rozgrywki,
+ * @param[in] command     – znak oznaczający typ komendy, (m, g, f, b, q lub p),
+ * @param[in] args        – argumenty komendy.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie lub kod błędu
+ * zapisu planszy.
+ */
+static io_error_t run_ndjson_command(batch_session_t *session, char command,
+                                     const uint32_t *args) {
+    json_writer_t writer;
+    json_writer_init(&writer, session->out);
+    uint64_t start = session->options.timing ? monotonic_time_ns() : 0;
+
+    begin_ndjson_command(&writer, session->line, command, args);
+    json_key(&writer, "result");
+    if (command == 'm' || command == 'g') {
+        json_bool(&writer, run_move_or_golden_move(session->game, command, args[0],
+                                                   args[1], args[2]));
+    } else if (command == 'q') {
+        json_bool(&writer, run_one_argument_command(session->game, command, args[0]));
+    } else if (command == 'b' || command == 'f') {
+        json_uint(&writer, run_one_argument_command(session->game, command, args[0]));
+    } else {
+        const io_error_t error = write_ndjson_board(session->game, &writer);
+        if (error != NO_ERROR) {
+            return error;
+        }
+    }
+
+    uint64_t end = session->options.timing ? monotonic_time_ns() : 0;
+    end_ndjson_command(session, &writer, end - start);
+    return NO_ERROR;
+}
+
+/** @brief Wykonuje zadane polecenie bez wypisywania wyniku.
+ * Zlicza wykonane ruchy; polecenie @p p jest pomijane, ponieważ nie zmienia
+ * stanu gry.
+ * @param[in,out] session – wskaźnik na stan rozgrywki,
+ * @param[in] command     – znak oznaczający typ komendy, (m, g, f, b, q lub p),
+ * @param[in] args        – argumenty komendy.
+ */
+static void run_quiet_command(batch_session_t *session, char command,
+                              const uint32_t *args) {
+    batch_statistics_t *statistics = &session->statistics;
+    if (command == 'm' || command == 'g') {
+        bool move_performed = run_move_or_golden_move(session->game, command, args[0],
+                                                      args[1], args[2]);
+        if (command == 'm') {
+            statistics->moves++;
+            statistics->successful_moves += move_performed;
+        } else {
+            statistics->golden_moves++;
+            statistics->successful_golden_moves += move_performed;
+        }
+    } else if (command != 'p') {
+        run_one_argument_command(session->game, command, args[0]);
+    }
+}
+
+/** @brief Podaje liczbę graczy wypisywanych w podsumowaniu rozgrywki.
+ * W grze o liczbie graczy większej niż @ref GAMMA_DENSE_PLAYERS_LIMIT wypisywani
+ * są tylko gracze aktywni, aby podsumowanie nie zajmowało gigabajtów.
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry.
+ * @return Liczba graczy.
+ */
+static uint32_t summary_players_count(const gamma_t *g) {
+    const uint32_t players = gamma_players_number(g);
+    return players <= GAMMA_DENSE_PLAYERS_LIMIT ? players
+                                                : gamma_active_players_number(g);
+}
+
+/** @brief Podaje numer gracza wypisywanego w podsumowaniu rozgrywki.
+ * Gracze aktywni wypisywani są w kolejności pierwszego ruchu, a wszyscy gracze -
+ * w kolejności numerów.
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] index       – indeks mniejszy niż @ref summary_players_count.
+ * @return Numer gracza.
+ */
+static uint32_t summary_player(const gamma_t *g, uint32_t index) {
+    return gamma_players_number(g) <= GAMMA_DENSE_PLAYERS_LIMIT
+               ? index + 1
+               : gamma_active_player(g, index);
+}
+
+/** @brief Zapisuje podsumowanie rozgrywki w formacie NDJSON.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z utworzoną grą.
+ */
+static void write_ndjson_summary(batch_session_t *session) {
+    const batch_statistics_t *statistics = &session->statistics;
+    json_writer_t writer;
+    json_writer_init(&writer, session->out);
+
+    json_begin_object(&writer);
+    json_key(&writer, "lines");
+    json_uint(&writer, session->line);
+    json_key(&writer, "moves");
+    json_uint(&writer, statistics->moves);
+    json_key(&writer, "successful_moves");
+    json_uint(&writer, statistics->successful_moves);
+    json_key(&writer, "golden_moves");
+    json_uint(&writer, statistics->golden_moves);
+    json_key(&writer, "successful_golden_moves");
+    json_uint(&writer, statistics->successful_golden_moves);
+    json_key(&writer, "errors");
+    json_uint(&writer, statistics->errors);
+    json_key(&writer, "players");
+    json_begin_array(&writer);
+    for (uint32_t i = 0; i < summary_players_count(session->game); i++) {
+        const uint32_t player = summary_player(session->game, i);
+        json_begin_object(&writer);
+        json_key(&writer, "player");
+        json_uint(&writer, player);
+        json_key(&writer, "busy");
+        json_uint(&writer, gamma_busy_fields(session->game, player));
+        json_key(&writer, "free");
+        json_uint(&writer, gamma_free_fields(session->game, player));
+        json_end_object(&writer);
+    }
+    json_end_array(&writer);
+    json_end_object(&writer);
+    output_buffer_write_char(session->out, '\n');
+}
+
+/** @brief Wypisuje wiersz podsumowania postaci "nazwa wartość wartość".
+ * @param[in,out] out     – wskaźnik na bufor wyjścia,
+ * @param[in] name        – nazwa wiersza,
+ * @param[in] first       – pierwsza wartość,
+ * @param[in] second      – druga wartość.
+ */
+static void write_summary_line(output_buffer_t *out, const char *name, uint64_t first,
+                               uint64_t second) {
+    output_buffer_write_string(out, name);
+    output_buffer_write_char(out, ' ');
+    output_buffer_write_uint64(out, first);
+    output_buffer_write_char(out, ' ');
+    output_buffer_write_uint64(out, second);
+    output_buffer_write_char(out, '\n');
+}
+
+/** @brief Wykonuje polecenie s wypisujące liczniki operacji wewnętrznych silnika.
+ * W trybie z opcją @p quiet liczniki nie są wypisywane.
+ * @param[in,out] session – wskaźnik na stan rozgrywki.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p INVALID_VALUE,
+ * jeżeli silnik został skompilowany bez liczników.
+ */
+static io_error_t run_stats_command(batch_session_t *session) {
+    const uint64_t start = session->options.timing ? monotonic_time_ns() : 0;
+    gamma_stats_t stats;
+    if (!gamma_stats(session->game, &stats)) {
+        return INVALID_VALUE;
+    }
+    if (session->options.quiet) {
+        return NO_ERROR;
+    }
+
+    const uint64_t values[ENGINE_STATS_COUNT] = {
+        stats.find_calls,          stats.find_path_length,
+        stats.union_merges,        stats.reindex_calls,
+        stats.reindex_visited_fields, stats.golden_move_rollbacks,
+        stats.golden_possible_candidates};
+    if (session->options.format == BATCH_FORMAT_NDJSON) {
+        json_writer_t writer;
+        json_writer_init(&writer, session->out);
+        begin_ndjson_command(&writer, session->line, 's', NULL);
+        json_key(&writer, "result");
+        json_begin_object(&writer);
+        for (unsigned i = 0; i < ENGINE_STATS_COUNT; i++) {
+            json_key(&writer, engine_stats_json_names[i]);
+            json_uint(&writer, values[i]);
+        }
+        json_end_object(&writer);
+        const uint64_t end = session->options.timing ? monotonic_time_ns() : 0;
+        end_ndjson_command(session, &writer, end - start);
+        return NO_ERROR;
+    }
+
+    for (unsigned i = 0; i < ENGINE_STATS_COUNT; i++) {
+        output_buffer_write_string(session->out, engine_stats_text_names[i]);
+        output_buffer_write_char(session->out, ' ');
+        output_buffer_write_uint64(session->out, values[i]);
+        output_buffer_write_char(session->out, '\n');
+    }
+    return NO_ERROR;
+}
+
+/** @brief Wykonuje polecenie a wypisujące wyniki gamma_golden_possible wszystkich
+ * graczy.
+ * Wyniki wyznaczane są jednym wywołaniem @ref gamma_golden_possible_all
+ * i wypisywane w jednym wierszu, oddzielone spacjami, lub jako tablica w formacie
+ * NDJSON. W trybie z opcją @p quiet wyniki nie są wypisywane.
+ * @param[in,out] session – wskaźnik na stan rozgrywki.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p INVALID_VALUE,
+ * jeżeli graczy jest więcej niż @ref GAMMA_DENSE_PLAYERS_LIMIT lub nie udało się
+ * zaalokować pamięci.
+ */
+static io_error_t run_golden_possible_all_command(batch_session_t *session) {
+    const uint64_t start = session->options.timing ? monotonic_time_ns() : 0;
+    const uint32_t players = gamma_players_number(session->game);
+    // Wynik każdego gracza gry z rzadką tablicą graczy mógłby zająć gigabajty.
+    if (players > GAMMA_DENSE_PLAYERS_LIMIT) {
+        return INVALID_VALUE;
+    }
+    bool *possible = malloc((size_t)players * sizeof(bool));
+    if (possible == NULL || !gamma_golden_possible_all(session->game, possible)) {
+        free(possible);
+        return INVALID_VALUE;
+    }
+    if (session->options.quiet) {
+        free(possible);
+        return NO_ERROR;
+    }
+
+    if (session->options.format == BATCH_FORMAT_NDJSON) {
+        json_writer_t writer;
+        json_writer_init(&writer, session->out);
+        begin_ndjson_command(&writer, session->line, 'a', NULL);
+        json_key(&writer, "result");
+        json_begin_array(&writer);
+        for (uint32_t i = 0; i < players; i++) {
+            json_bool(&writer, possible[i]);
+        }
+        json_end_array(&writer);
+        const uint64_t end = session->options.timing ? monotonic_time_ns() : 0;
+        end_ndjson_command(session, &writer, end - start);
+    } else {
+        for (uint32_t i = 0; i < players; i++) {
+            if (i > 0) {
+                output_buffer_write_char(session->out, ' ');
+            }
+            output_buffer_write_char(session->out, possible[i] ? '1' : '0');
+        }
+        output_buffer_write_char(session->out, '\n');
+    }
+    free(possible);
+    return NO_ERROR;
 }
 
 /** @brief Wykonuje zadane polecenie.
  * Poza argumentem @p command identyfikującym typ komendy przyjmuje 3 argumenty.
  * Jeżeli dana komenda przyjmuje mniej niż 3 argumenty, dodatkowe argumenty nie są
  * używane.
- * @param[in,out] g       – wskaźnik na strukturę przechowującą stan gry,
- * @param[in] command     – znak oznaczający typ komendy, (m, g, f, b, q lub p),
+ * @param[in,out] session – wskaźnik na stan rozgrywki,
+ * @param[in] command     – znak oznaczający typ komendy, (m, g, f, b, q, p, s
+ *                          lub a),
  * @param[in] args        – argumenty komendy.
  * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p INVALID_VALUE,
  * jeżeli któryś z argumentów jest nieprawidłowy lub operacja się nie powiedzie,
- * jednak błąd jest niekrytyczny.
+ * jednak błąd jest niekrytyczny, lub kod błędu krytycznego, np. @p MEMORY_ERROR,
+ * jeżeli nie udało się zapisać wyniku.
  */
-static io_error_t run_command(gamma_t *g, char command, uint32_t args[3]) {
+static io_error_t run_command(batch_session_t *session, char command, uint32_t args[3]) {
+    if (command == 's') {
+        return run_stats_command(session);
+    }
+    if (command == 'a') {
+        return run_golden_possible_all_command(session);
+    }
+    if (session->options.quiet) {
+        run_quiet_command(session, command, args);
+        return NO_ERROR;
+    }
+    if (session->options.format == BATCH_FORMAT_NDJSON) {
+        return run_ndjson_command(session, command, args);
+    }
+
+    gamma_t *g = session->game;
+    output_buffer_t *out = session->out;
     if (command == 'm' || command == 'g') {
-        run_move_or_golden_move(g, command, args[0], args[1], args[2]);
+        bool move_performed =
+            run_move_or_golden_move(g, command, args[0], args[1], args[2]);
+        output_buffer_write_char(out, move_performed ? '1' : '0');
+        output_buffer_write_char(out, '\n');
     } else if (command == 'b' || command == 'f' || command == 'q') {
-        run_one_argument_command(g, command, args[0]);
+        output_buffer_write_uint64(out, run_one_argument_command(g, command, args[0]));
+        output_buffer_write_char(out, '\n');
     } else {
         char *rendered_board = gamma_board(g);
         if (rendered_board == NULL) {
             return INVALID_VALUE;
         } else {
-            printf("%s", rendered_board);
-            free(rendered_board);
+            output_buffer_write_string(out, rendered_board);
+            gamma_board_free(g, rendered_board);
         }
     }
 
     return NO_ERROR;
 }
 
-void batch_run_mode(gamma_t *g, unsigned long *line) {
-    printf("OK %lu\n", *line); // Gra rozpoczęta prawidłowo.
+io_error_t batch_session_init(batch_session_t *session, input_buffer_t *in,
+                              output_buffer_t *out, output_buffer_t *err,
+                              const batch_options_t *options) {
+    session->game = NULL;
+    session->line = 0;
+    session->in = in;
+    session->out = out;
+    session->err = err;
+    session->report = err;
+    session->options = *options;
+    session->statistics = (batch_statistics_t){0};
+    session->latencies = NULL;
+    session->trace = NULL;
+    session->trace_origin_ns = 0;
+    session->slow_log = NULL;
+    if (options->latency) {
+        session->latencies = calloc(BATCH_COMMANDS_COUNT, sizeof(latency_histogram_t));
+        if (session->latencies == NULL) {
+            return MEMORY_ERROR;
+        }
+    }
+    return NO_ERROR;
+}
+
+void batch_session_free(batch_session_t *session) {
+    free(session->latencies);
+    session->latencies = NULL;
+}
+
+void batch_trace_begin(batch_session_t *session, output_buffer_t *trace) {
+    session->trace = trace;
+    session->trace_origin_ns = monotonic_time_ns();
+    json_writer_init(&session->trace_writer, trace);
+    json_begin_object(&session->trace_writer);
+    json_key(&session->trace_writer, "traceEvents");
+    json_begin_array(&session->trace_writer);
+    output_buffer_write_char(trace, '\n');
+}
+
+void batch_trace_end(batch_session_t *session) {
+    if (session->trace == NULL) {
+        return;
+    }
+    json_end_array(&session->trace_writer);
+    json_key(&session->trace_writer, "displayTimeUnit");
+    json_string(&session->trace_writer, "ns", 2);
+    json_end_object(&session->trace_writer);
+    output_buffer_write_char(session->trace, '\n');
+    output_buffer_flush(session->trace);
+    session->trace = NULL;
+}
+
+void batch_slow_log_begin(batch_session_t *session, output_buffer_t *slow_log) {
+    session->slow_log = slow_log;
+}
+
+/** @brief Zapisuje polecenie w dzienniku wolnych poleceń.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z zapisywanym dziennikiem,
+ * @param[in] command     – znak oznaczający typ komendy,
+ * @param[in] args        – argumenty komendy,
+ * @param[in] elapsed_ns  – czas wykonania polecenia w nanosekundach,
+ * @param[in] paths       – flagi @ref gamma_path_t ścieżek wykonanych przez silnik.
+ */
+static void write_slow_command(batch_session_t *session, char command,
+                               const uint32_t *args, uint64_t elapsed_ns,
+                               unsigned paths) {
+    const gamma_t *g = session->game;
+    json_writer_t writer;
+    json_writer_init(&writer, session->slow_log);
+
+    begin_ndjson_command(&writer, session->line, command, args);
+    json_key(&writer, "time_ns");
+    json_uint(&writer, elapsed_ns);
+    json_key(&writer, "width");
+    json_uint(&writer, gamma_board_width(g));
+    json_key(&writer, "height");
+    json_uint(&writer, gamma_board_height(g));
+    // Wypisanie wszystkich graczy spowalniałoby gry z wieloma graczami.
+    json_key(&writer, "players_with_fields");
+    json_uint(&writer, gamma_players_with_fields(g));
+    json_key(&writer, "areas");
+    json_begin_array(&writer);
+    uint32_t listed = 0;
+    for (uint32_t i = 0;
+         i < gamma_active_players_number(g) && listed < SLOW_LOG_PLAYERS_LIMIT; i++) {
+        const uint32_t player = gamma_active_player(g, i);
+        const uint32_t areas = gamma_player_areas(g, player);
+        if (areas == 0) {
+            continue;
+        }
+        json_begin_object(&writer);
+        json_key(&writer, "player");
+        json_uint(&writer, player);
+        json_key(&writer, "areas");
+        json_uint(&writer, areas);
+        json_end_object(&writer);
+        listed++;
+    }
+    json_end_array(&writer);
+    json_key(&writer, "paths");
+    json_begin_array(&writer);
+    for (unsigned i = 0; i < ENGINE_PATHS_COUNT; i++) {
+        if (paths & (1u << i)) {
+            json_string(&writer, engine_path_names[i], strlen(engine_path_names[i]));
+        }
+    }
+    json_end_array(&writer);
+    json_end_object(&writer);
+    output_buffer_write_char(session->slow_log, '\n');
+    output_buffer_flush(session->slow_log);
+}
+
+io_error_t batch_create_game(batch_session_t *session, const uint32_t *args) {
+    if (!gamma_game_new_arguments_valid(args[0], args[1], args[2], args[3])) {
+        return INVALID_VALUE;
+    }
+    if (session->options.max_memory != 0 &&
+        gamma_estimate_memory(args[0], args[1], args[2], args[3]) >
+            session->options.max_memory) {
+        return INVALID_VALUE;
+    }
+    session->game = gamma_new_ex(args[0], args[1], args[2], args[3],
+                                 session->options.huge_pages ? &huge_page_allocator
+                                                             : NULL);
+    if (session->game == NULL) {
+        return MEMORY_ERROR;
+    }
+    gamma_set_memory_limit(session->game, session->options.max_memory);
+    return NO_ERROR;
+}
+
+void batch_report_error(batch_session_t *session) {
+    session->statistics.errors++;
+    if (session->options.quiet) {
+        return;
+    }
+    if (session->options.format == BATCH_FORMAT_NDJSON) {
+        json_writer_t writer;
+        json_writer_init(&writer, session->out);
+        json_begin_object(&writer);
+        json_key(&writer, "line");
+        json_uint(&writer, session->line);
+        json_key(&writer, "error");
+        json_bool(&writer, true);
+        json_end_object(&writer);
+        output_buffer_write_char(session->out, '\n');
+        return;
+    }
+
+    output_buffer_write_string(session->err, "ERROR ");
+    output_buffer_write_uint64(session->err, session->line);
+    output_buffer_write_char(session->err, '\n');
+    flush_traced(session, session->err);
+}
+
+void batch_report_game_started(batch_session_t *session) {
+    if (session->options.quiet) {
+        return;
+    }
+    if (session->options.format == BATCH_FORMAT_NDJSON) {
+        json_writer_t writer;
+        json_writer_init(&writer, session->out);
+        json_begin_object(&writer);
+        json_key(&writer, "line");
+        json_uint(&writer, session->line);
+        json_key(&writer, "command");
+        json_string(&writer, "B", 1);
+        json_key(&writer, "args");
+        json_begin_array(&writer);
+        json_uint(&writer, gamma_board_width(session->game));
+        json_uint(&writer, gamma_board_height(session->game));
+        json_uint(&writer, gamma_players_number(session->game));
+        json_uint(&writer, gamma_max_areas(session->game));
+        json_end_array(&writer);
+        json_key(&writer, "result");
+        json_bool(&writer, true);
+        json_end_object(&writer);
+        output_buffer_write_char(session->out, '\n');
+        return;
+    }
+
+    output_buffer_write_string(session->out, "OK ");
+    output_buffer_write_uint64(session->out, session->line);
+    output_buffer_write_char(session->out, '\n');
+}
 
+io_error_t batch_run_next_command(batch_session_t *session) {
     char command;
     uint32_t args[COMMAND_ARGUMENTS_UPPER_BOUND];
-    io_error_t error;
 
-    do {
-        (*line)++;
-        error = text_input_read_next_command(&command, args, BATCH_COMMAND_IDENTIFIERS);
-        if (error == NO_ERROR) {
-            error = run_command(g, command, args);
-            if (error != NO_ERROR) {
-                fprintf(stderr, "ERROR %lu\n", *line);
+    session->line++;
+    const bool timed = session->latencies != NULL || session->trace != NULL ||
+                       session->slow_log != NULL;
+    input_buffer_t *in = session->in;
+    if (session->trace != NULL && in->tied_output != NULL &&
+        in->position == in->length) {
+        // Wczytanie kolejnych danych opróżni powiązane wyjście; opróżniamy je
+        // wcześniej, aby w śladzie było widoczne jako osobne zdarzenie.
+        flush_traced(session, in->tied_output);
+    }
+    const uint64_t parse_start = session->trace != NULL ? monotonic_time_ns() : 0;
+    io_error_t error =
+        text_input_read_next_command(in, &command, args, BATCH_COMMAND_IDENTIFIERS);
+    if (session->trace != NULL && error != ENCOUNTERED_EOF) {
+        begin_trace_event(session, "parse", strlen("parse"), "io", parse_start,
+                          monotonic_time_ns());
+        end_trace_event(session);
+    }
+
+    if (error == ENCOUNTERED_EOF) {
+        // Po ostatnim wierszu nie ma już kolejnego.
+        session->line--;
+    } else if (error == NO_ERROR) {
+        const uint64_t start = timed ? monotonic_time_ns() : 0;
+        error = run_command(session, command, args);
+        const uint64_t end = timed ? monotonic_time_ns() : 0;
+        if (session->latencies != NULL) {
+            latency_histogram_t *histogram =
+                &session->latencies[strchr(BATCH_COMMAND_IDENTIFIERS, command) -
+                                    BATCH_COMMAND_IDENTIFIERS];
+            latency_histogram_record(histogram, end - start);
+        }
+        if (session->slow_log != NULL) {
+            const unsigned paths = gamma_take_paths(session->game);
+            if (end - start >= session->options.slow_threshold_ns) {
+                write_slow_command(session, command, args, end - start, paths);
             }
-        } else if (error == INVALID_VALUE) {
-            fprintf(stderr, "ERROR %lu\n", *line);
         }
+        if (session->trace != NULL) {
+            json_writer_t *writer = &session->trace_writer;
+            begin_trace_event(session, &command, 1, "engine", start, end);
+            json_key(writer, "args");
+            json_begin_array(writer);
+            for (unsigned i = 0; i < command_arguments_count(command); i++) {
+                json_uint(writer, args[i]);
+            }
+            json_end_array(writer);
+            json_key(writer, "error");
+            json_bool(writer, error != NO_ERROR);
+            end_trace_event(session);
+        }
+    }
+    if (error == INVALID_VALUE) {
+        batch_report_error(session);
+    }
+    return error;
+}
+
+void batch_report_summary(batch_session_t *session) {
+    if (session->options.format == BATCH_FORMAT_NDJSON) {
+        write_ndjson_summary(session);
+        return;
+    }
+
+    const batch_statistics_t *statistics = &session->statistics;
+    output_buffer_write_string(session->out, "LINES ");
+    output_buffer_write_uint64(session->out, session->line);
+    output_buffer_write_char(session->out, '\n');
+    write_summary_line(session->out, "MOVES", statistics->moves,
+                       statistics->successful_moves);
+    write_summary_line(session->out, "GOLDEN_MOVES", statistics->golden_moves,
+                       statistics->successful_golden_moves);
+    output_buffer_write_string(session->out, "ERRORS ");
+    output_buffer_write_uint64(session->out, statistics->errors);
+    output_buffer_write_char(session->out, '\n');
+    for (uint32_t i = 0; i < summary_players_count(session->game); i++) {
+        const uint32_t player = summary_player(session->game, i);
+        output_buffer_write_string(session->out, "PLAYER ");
+        output_buffer_write_uint64(session->out, player);
+        write_summary_line(session->out, "", gamma_busy_fields(session->game, player),
+                           gamma_free_fields(session->game, player));
+    }
+}
+
+/** @brief Zapisuje percentyle opóźnień poleceń w formacie NDJSON.
+ * @param[in,out] session – wskaźnik na stan rozgrywki ze zbieranymi opóźnieniami.
+ */
+static void write_ndjson_latency(batch_session_t *session) {
+    json_writer_t writer;
+    json_writer_init(&writer, session->report);
+
+    json_begin_object(&writer);
+    json_key(&writer, "latency");
+    json_begin_array(&writer);
+    for (unsigned i = 0; i < BATCH_COMMANDS_COUNT; i++) {
+        const latency_histogram_t *histogram = &session->latencies[i];
+        json_begin_object(&writer);
+        json_key(&writer, "command");
+        json_string(&writer, &BATCH_COMMAND_IDENTIFIERS[i], 1);
+        json_key(&writer, "count");
+        json_uint(&writer, histogram->count);
+        for (unsigned q = 0; q < LATENCY_QUANTILES_COUNT; q++) {
+            json_key(&writer, latency_quantile_names[q]);
+            json_uint(&writer,
+                      latency_histogram_quantile(histogram, latency_quantiles[q]));
+        }
+        json_key(&writer, "max_ns");
+        json_uint(&writer, histogram->max);
+        json_end_object(&writer);
+    }
+    json_end_array(&writer);
+    json_end_object(&writer);
+    output_buffer_write_char(session->report, '\n');
+}
+
+void batch_report_latency(batch_session_t *session) {
+    if (session->latencies == NULL) {
+        return;
+    }
+    if (session->options.format == BATCH_FORMAT_NDJSON) {
+        write_ndjson_latency(session);
+    } else {
+        output_buffer_t *report = session->report;
+        for (unsigned i = 0; i < BATCH_COMMANDS_COUNT; i++) {
+            const latency_histogram_t *histogram = &session->latencies[i];
+            output_buffer_write_string(report, "LATENCY ");
+            output_buffer_write_char(report, BATCH_COMMAND_IDENTIFIERS[i]);
+            output_buffer_write_char(report, ' ');
+            output_buffer_write_uint64(report, histogram->count);
+            for (unsigned q = 0; q < LATENCY_QUANTILES_COUNT; q++) {
+                const uint64_t value =
+                    latency_histogram_quantile(histogram, latency_quantiles[q]);
+                output_buffer_write_char(report, ' ');
+                output_buffer_write_uint64(report, value);
+            }
+            output_buffer_write_char(report, ' ');
+            output_buffer_write_uint64(report, histogram->max);
+            output_buffer_write_char(report, '\n');
+        }
+    }
+    output_buffer_flush(session->report);
+}
+
+void batch_run_mode(batch_session_t *session) {
+    // Gra rozpoczęta prawidłowo.
+    batch_report_game_started(session);
+
+    io_error_t error;
+    do {
+        error = batch_run_next_command(session);
     } while (error != ENCOUNTERED_EOF);
+    if (session->options.quiet) {
+        batch_report_summary(session);
+    }
+    flush_traced(session, session->out);
+    batch_report_latency(session);
 }
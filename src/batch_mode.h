@@ -9,13 +9,183 @@
 #ifndef BATCH_MODE_H
 #define BATCH_MODE_H
 
+#include "buffered_io.h"
 #include "gamma.h"
+#include "json_writer.h"
+#include "latency_histogram.h"
+
+/** Liczba różnych poleceń trybu wsadowego. */
+#define BATCH_COMMANDS_COUNT 8
+
+/**
+ * Enum opisujący formaty wyników trybu wsadowego.
+ */
+typedef enum batch_output_format {
+    BATCH_FORMAT_TEXT,   /**< Wynik każdego polecenia w osobnym wierszu, błędy
+                          * na standardowym wyjściu diagnostycznym. */
+    BATCH_FORMAT_NDJSON, /**< Jeden obiekt JSON w wierszu dla każdego polecenia
+                          * i każdego błędu. */
+} batch_output_format_t;
+
+/**
+ * Struktura przechowująca opcje trybu wsadowego.
+ */
+typedef struct batch_options {
+    batch_output_format_t format; /**< Format wyników. */
+    bool timing; /**< Informacja czy dołączać czas wykonania poleceń (NDJSON). */
+    bool quiet;  /**< Informacja czy pominąć wyniki poszczególnych poleceń i wypisać
+                  * jedynie podsumowanie po zakończeniu danych. */
+    bool latency; /**< Informacja czy zbierać histogramy opóźnień poleceń. */
+    uint64_t slow_threshold_ns; /**< Opóźnienie w nanosekundach, od którego
+                                 * polecenie trafia do dziennika wolnych poleceń. */
+    uint64_t max_memory; /**< Największa pamięć w bajtach, jaką może zająć gra
+                          * (zob. @ref gamma_estimate_memory), lub 0, jeżeli
+                          * rozmiar gry nie jest ograniczony. */
+    bool huge_pages; /**< Informacja czy alokować planszę z dużych stron pamięci
+                      * (zob. @ref huge_page_allocator). */
+} batch_options_t;
+
+/**
+ * Struktura przechowująca liczniki poleceń wykonanych w trybie wsadowym.
+ */
+typedef struct batch_statistics {
+    uint64_t moves;               /**< Liczba poleceń @p m. */
+    uint64_t successful_moves;    /**< Liczba wykonanych ruchów. */
+    uint64_t golden_moves;        /**< Liczba poleceń @p g. */
+    uint64_t successful_golden_moves; /**< Liczba wykonanych złotych ruchów. */
+    uint64_t errors;              /**< Liczba zgłoszonych błędów. */
+} batch_statistics_t;
+
+/**
+ * Struktura przechowująca stan rozgrywki w trybie wsadowym.
+ */
+typedef struct batch_session {
+    gamma_t *game;          /**< Gra lub NULL, jeżeli jeszcze nie została utworzona. */
+    unsigned long line;     /**< Numer aktualnego wiersza wejścia. */
+    input_buffer_t *in;     /**< Wejście z poleceniami. */
+    output_buffer_t *out;   /**< Wyjście z wynikami poleceń. */
+    output_buffer_t *err;   /**< Wyjście diagnostyczne. */
+    output_buffer_t *report; /**< Wyjście raportów o wydajności; domyślnie
+                              * wyjście diagnostyczne. */
+    batch_options_t options; /**< Opcje trybu wsadowego. */
+    batch_statistics_t statistics; /**< Liczniki wykonanych poleceń. */
+    latency_histogram_t *latencies; /**< Histogramy opóźnień kolejnych poleceń
+                                     * lub NULL, jeżeli nie są zbierane. */
+    output_buffer_t *trace; /**< Wyjście śladu wykonania w formacie Chrome Trace
+                             * lub NULL, jeżeli ślad nie jest zapisywany. */
+    json_writer_t trace_writer; /**< Stan zapisu zdarzeń śladu wykonania. */
+    output_buffer_t *slow_log; /**< Wyjście dziennika wolnych poleceń lub NULL,
+                                * jeżeli dziennik nie jest zapisywany. */
+    uint64_t trace_origin_ns; /**< Chwila rozpoczęcia zapisu śladu wykonania. */
+} batch_session_t;
+
+/** @brief Inicjuje stan rozgrywki w trybie wsadowym.
+ * Gra nie jest tworzona, a numer wiersza jest ustawiany na zero.
+ * @param[out] session   – wskaźnik na inicjowaną strukturę,
+ * @param[in] in         – wskaźnik na strukturę wejścia,
+ * @param[in] out        – wskaźnik na bufor wyjścia,
+ * @param[in] err        – wskaźnik na bufor wyjścia diagnostycznego,
+ * @param[in] options    – wskaźnik na opcje trybu wsadowego.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci.
+ */
+io_error_t batch_session_init(batch_session_t *session, input_buffer_t *in,
+                              output_buffer_t *out, output_buffer_t *err,
+                              const batch_options_t *options);
+
+/** @brief Zwalnia pamięć zajmowaną przez stan rozgrywki.
+ * Nie usuwa gry.
+ * @param[in,out] session – wskaźnik na stan rozgrywki.
+ */
+void batch_session_free(batch_session_t *session);
+
+/** @brief Rozpoczyna zapis śladu wykonania w formacie Chrome Trace.
+ * Od tej chwili dla każdego wiersza zapisywane są zdarzenia obejmujące
+ * wczytanie polecenia, jego wykonanie i opróżnianie bufora wyjścia. Plik można
+ * otworzyć w przeglądarce śladów (chrome://tracing, Perfetto).
+ * @param[in,out] session – wskaźnik na stan rozgrywki,
+ * @param[in] trace       – wskaźnik na bufor wyjścia śladu.
+ */
+void batch_trace_begin(batch_session_t *session, output_buffer_t *trace);
+
+/** @brief Kończy zapis śladu wykonania i opróżnia jego bufor.
+ * Nic nie robi, jeżeli ślad nie jest zapisywany.
+ * @param[in,out] session – wskaźnik na stan rozgrywki.
+ */
+void batch_trace_end(batch_session_t *session);
+
+/** @brief Włącza dziennik wolnych poleceń.
+ * Każde polecenie wykonywane co najmniej @p slow_threshold_ns nanosekund jest
+ * zapisywane jako jeden obiekt JSON w wierszu zawierający numer wiersza,
+ * polecenie, argumenty, czas wykonania, wymiary planszy, liczbę graczy
+ * zajmujących pola, pary numer gracza i liczba jego obszarów dla co najwyżej 256
+ * z nich (w kolejności pierwszego ruchu) i kosztowne ścieżki wykonane przez
+ * silnik. Dziennik włączany jest przed utworzeniem gry, więc pierwsze polecenie
+ * nie dziedziczy żadnych zaznaczonych ścieżek.
+ * @param[in,out] session – wskaźnik na stan rozgrywki,
+ * @param[in] slow_log    – wskaźnik na bufor wyjścia dziennika.
+ */
+void batch_slow_log_begin(batch_session_t *session, output_buffer_t *slow_log);
+
+/** @brief Tworzy grę o parametrach wczytanych z wiersza tworzącego grę.
+ * Gra, która zajęłaby więcej pamięci niż pozwala opcja @p max_memory, jest
+ * odrzucana przed próbą alokacji, a utworzona gra dostaje ten limit
+ * (zob. @ref gamma_set_memory_limit) dla struktur tworzonych na żądanie.
+ * @param[in,out] session – wskaźnik na stan rozgrywki bez utworzonej gry,
+ * @param[in] args        – szerokość, wysokość planszy, liczba graczy i limit
+ *                          obszarów.
+ * @return Kod @p NO_ERROR jeżeli gra została utworzona, @p INVALID_VALUE jeżeli
+ * parametry są niepoprawne lub gra jest zbyt duża, @p MEMORY_ERROR jeżeli nie
+ * udało się zaalokować pamięci.
+ */
+io_error_t batch_create_game(batch_session_t *session, const uint32_t *args);
+
+/** @brief Wypisuje komunikat o błędzie w aktualnym wierszu.
+ * W trybie z opcją @p quiet błąd jest jedynie zliczany.
+ * @param[in,out] session – wskaźnik na stan rozgrywki.
+ */
+void batch_report_error(batch_session_t *session);
+
+/** @brief Wypisuje potwierdzenie utworzenia gry w aktualnym wierszu.
+ * W trybie z opcją @p quiet nic nie jest wypisywane.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z utworzoną grą.
+ */
+void batch_report_game_started(batch_session_t *session);
+
+/** @brief Wczytuje i wykonuje następne polecenie trybu wsadowego.
+ * Zwiększa numer aktualnego wiersza i wypisuje komunikat o błędzie, jeżeli
+ * polecenie jest niepoprawne.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z utworzoną grą.
+ * @return Kod @p NO_ERROR jeżeli polecenie zostało wykonane, @p INVALID_VALUE
+ * jeżeli polecenie jest niepoprawne, @p LINE_IGNORED jeżeli wiersz został pominięty,
+ * @p ENCOUNTERED_EOF jeżeli dane na wejściu się skończyły.
+ */
+io_error_t batch_run_next_command(batch_session_t *session);
+
+/** @brief Wypisuje podsumowanie rozgrywki.
+ * Podsumowanie zawiera liczbę wczytanych wierszy, liczby wykonanych poleceń
+ * @p m i @p g wraz z liczbą udanych ruchów, liczbę błędów oraz, dla każdego
+ * gracza, wyniki funkcji @ref gamma_busy_fields i @ref gamma_free_fields. W grze
+ * o liczbie graczy większej niż @ref GAMMA_DENSE_PLAYERS_LIMIT wypisywani są tylko
+ * gracze aktywni (@ref gamma_active_player), w kolejności pierwszego ruchu.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z utworzoną grą.
+ */
+void batch_report_summary(batch_session_t *session);
+
+/** @brief Wypisuje percentyle opóźnień poleceń na wyjście raportów.
+ * Dla każdego polecenia wypisuje liczbę wykonań oraz percentyle 50, 99 i 99,9
+ * i największe opóźnienie w nanosekundach. Nic nie robi, jeżeli histogramy
+ * opóźnień nie są zbierane.
+ * @param[in,out] session – wskaźnik na stan rozgrywki.
+ */
+void batch_report_latency(batch_session_t *session);
 
 /** @brief Przeprowadza rozgrywkę w trybie wsadowym.
- * Rozgrywka kończy się, gdy kończą się dane na wejściu.
- * @param[in] g          – wskaźnik na strukturę danych gry,
- * @param[in,out] line   – wskaźnik na numer aktualnego wiersza.
+ * Rozgrywka kończy się, gdy kończą się dane na wejściu. W trybie z opcją
+ * @p quiet na koniec wypisywane jest podsumowanie @ref batch_report_summary,
+ * a z opcją @p latency - raport @ref batch_report_latency.
+ * @param[in,out] session – wskaźnik na stan rozgrywki z utworzoną grą.
  */
-void batch_run_mode(gamma_t *g, unsigned long *line);
+void batch_run_mode(batch_session_t *session);
 
 #endif /* BATCH_MODE_H */
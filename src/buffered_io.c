@@ -0,0 +1,183 @@
+/** @file
+ * Implementacja modułu buforowanego wejścia i wyjścia.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "buffered_io.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Ograniczenie górne długości dziesiętnej reprezentacji liczby typu uint64_t
+ * 20 = ceil(log10(UINT64_MAX)) */
+#define UINT64_LENGTH_UPPER_BOUND 20
+
+/** @brief Uzupełnia bufor danymi wczytanymi z deskryptora.
+ * Przed wczytaniem opróżnia powiązany bufor wyjścia, aby odpowiedzi na
+ * dotychczasowe polecenia były widoczne zanim program zablokuje się na odczycie.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia.
+ * @return Kod @p NO_ERROR jeżeli wczytano nowe dane, @p ENCOUNTERED_EOF
+ * w przeciwnym przypadku.
+ */
+static io_error_t refill_from_fd(input_buffer_t *in) {
+    if (in->tied_output != NULL) {
+        output_buffer_flush(in->tied_output);
+    }
+
+    ssize_t read_bytes;
+    do {
+        read_bytes = read(in->fd, in->data, in->capacity);
+    } while (read_bytes < 0 && errno == EINTR);
+
+    if (read_bytes <= 0) {
+        return ENCOUNTERED_EOF;
+    }
+
+    in->position = 0;
+    in->length = (size_t)read_bytes;
+    return NO_ERROR;
+}
+
+io_error_t input_buffer_init_fd(input_buffer_t *in, int fd, size_t capacity) {
+    in->data = malloc(capacity);
+    if (in->data == NULL) {
+        return MEMORY_ERROR;
+    }
+    in->position = 0;
+    in->length = 0;
+    in->capacity = capacity;
+    in->fd = fd;
+    in->tied_output = NULL;
+    in->refill = refill_from_fd;
+    in->release = NULL;
+    in->backend = NULL;
+    return NO_ERROR;
+}
+
+void input_buffer_init_memory(input_buffer_t *in, char *data, size_t length) {
+    in->data = data;
+    in->position = 0;
+    in->length = length;
+    in->capacity = length;
+    in->fd = -1;
+    in->tied_output = NULL;
+    in->refill = NULL;
+    in->release = NULL;
+    in->backend = NULL;
+}
+
+void input_buffer_free(input_buffer_t *in) {
+    if (in->release != NULL) {
+        in->release(in);
+    } else if (in->refill != NULL) {
+        free(in->data);
+    }
+    in->data = NULL;
+    in->position = in->length = in->capacity = 0;
+}
+
+/** @brief Zapisuje całą zawartość bufora do deskryptora.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p SYSTEM_ERROR
+ * jeżeli zapis się nie powiódł.
+ */
+static io_error_t flush_to_fd(output_buffer_t *out) {
+    size_t written = 0;
+    while (written < out->length) {
+        ssize_t result = write(out->fd, out->data + written, out->length - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            out->length = 0;
+            return SYSTEM_ERROR;
+        }
+        written += (size_t)result;
+    }
+
+    out->length = 0;
+    return NO_ERROR;
+}
+
+io_error_t output_buffer_init_fd(output_buffer_t *out, int fd, size_t capacity) {
+    out->data = malloc(capacity);
+    if (out->data == NULL) {
+        return MEMORY_ERROR;
+    }
+    out->length = 0;
+    out->capacity = capacity;
+    out->fd = fd;
+    out->flush = flush_to_fd;
+    out->release = NULL;
+    out->backend = NULL;
+    return NO_ERROR;
+}
+
+void output_buffer_free(output_buffer_t *out) {
+    if (out->release != NULL) {
+        out->release(out);
+    }
+    free(out->data);
+    out->data = NULL;
+    out->length = out->capacity = 0;
+}
+
+io_error_t output_buffer_reserve_slow(output_buffer_t *out, size_t size) {
+    io_error_t error = output_buffer_flush(out);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    if (out->capacity - out->length >= size) {
+        return NO_ERROR;
+    }
+
+    size_t new_capacity =
+        out->capacity == 0 ? BUFFERED_IO_DEFAULT_CAPACITY : out->capacity;
+    while (new_capacity - out->length < size) {
+        new_capacity *= 2;
+    }
+    char *new_data = realloc(out->data, new_capacity);
+    if (new_data == NULL) {
+        return MEMORY_ERROR;
+    }
+    out->data = new_data;
+    out->capacity = new_capacity;
+    return NO_ERROR;
+}
+
+io_error_t output_buffer_write(output_buffer_t *out, const char *str, size_t size) {
+    io_error_t error = output_buffer_reserve(out, size);
+    if (error != NO_ERROR) {
+        return error;
+    }
+    memcpy(out->data + out->length, str, size);
+    out->length += size;
+    return NO_ERROR;
+}
+
+io_error_t output_buffer_write_string(output_buffer_t *out, const char *str) {
+    return output_buffer_write(out, str, strlen(str));
+}
+
+io_error_t output_buffer_write_uint64(output_buffer_t *out, uint64_t value) {
+    io_error_t error = output_buffer_reserve(out, UINT64_LENGTH_UPPER_BOUND);
+    if (error != NO_ERROR) {
+        return error;
+    }
+
+    char digits[UINT64_LENGTH_UPPER_BOUND];
+    unsigned length = 0;
+    do {
+        digits[length++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (length > 0) {
+        out->data[out->length++] = digits[--length];
+    }
+    return NO_ERROR;
+}
@@ -0,0 +1,198 @@
+/** @file
+ * Interfejs modułu buforowanego wejścia i wyjścia.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef BUFFERED_IO_H
+#define BUFFERED_IO_H
+
+#include "errors.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/** Domyślny rozmiar buforów wejścia i wyjścia w bajtach. */
+#define BUFFERED_IO_DEFAULT_CAPACITY (1u << 16u)
+
+struct output_buffer;
+
+/**
+ * Struktura przechowująca stan buforowanego wejścia.
+ * Dane mogą pochodzić z deskryptora pliku lub z bufora w pamięci.
+ */
+typedef struct input_buffer {
+    char *data;      /**< Bufor z wczytanymi danymi. */
+    size_t position; /**< Indeks następnego znaku do odczytania. */
+    size_t length;   /**< Liczba poprawnych znaków w buforze. */
+    size_t capacity; /**< Rozmiar bufora. */
+    int fd;          /**< Deskryptor, z którego wczytywane są dane. */
+    struct output_buffer *tied_output; /**< Bufor wyjścia opróżniany przed każdym
+                                        * wczytaniem danych, lub NULL. */
+    /** Funkcja uzupełniająca bufor, NULL jeżeli wejście nie ma dalszych danych.
+     * Zwraca @p NO_ERROR jeżeli wczytano nowe dane, @p ENCOUNTERED_EOF
+     * w przeciwnym przypadku. */
+    io_error_t (*refill)(struct input_buffer *in);
+    /** Funkcja zwalniająca zasoby alternatywnej implementacji wejścia lub NULL. */
+    void (*release)(struct input_buffer *in);
+    void *backend; /**< Dane wewnętrzne alternatywnej implementacji wejścia. */
+} input_buffer_t;
+
+/**
+ * Struktura przechowująca stan buforowanego wyjścia.
+ */
+typedef struct output_buffer {
+    char *data;      /**< Bufor z danymi oczekującymi na zapisanie. */
+    size_t length;   /**< Liczba znaków w buforze. */
+    size_t capacity; /**< Rozmiar bufora. */
+    int fd;          /**< Deskryptor, do którego zapisywane są dane. */
+    /** Funkcja zapisująca zawartość bufora. Może zapisać tylko część danych,
+     * pozostawiając resztę na początku bufora. */
+    io_error_t (*flush)(struct output_buffer *out);
+    /** Funkcja kończąca zapis i zwalniająca zasoby alternatywnej implementacji
+     * wyjścia lub NULL. */
+    void (*release)(struct output_buffer *out);
+    void *backend; /**< Dane wewnętrzne alternatywnej implementacji wyjścia. */
+} output_buffer_t;
+
+/** @brief Inicjuje buforowane wejście czytające z deskryptora.
+ * @param[out] in         – wskaźnik na inicjowaną strukturę,
+ * @param[in] fd          – deskryptor pliku,
+ * @param[in] capacity    – rozmiar bufora.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci.
+ */
+io_error_t input_buffer_init_fd(input_buffer_t *in, int fd, size_t capacity);
+
+/** @brief Inicjuje buforowane wejście czytające z zadanego obszaru pamięci.
+ * Nie kopiuje danych, obszar musi pozostać poprawny do końca czytania.
+ * @param[out] in         – wskaźnik na inicjowaną strukturę,
+ * @param[in] data        – wskaźnik na dane,
+ * @param[in] length      – liczba znaków.
+ */
+void input_buffer_init_memory(input_buffer_t *in, char *data, size_t length);
+
+/** @brief Zwalnia pamięć zajmowaną przez buforowane wejście.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia.
+ */
+void input_buffer_free(input_buffer_t *in);
+
+/** @brief Wczytuje następny znak.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia.
+ * @return Kod wczytanego znaku jako unsigned char lub EOF.
+ */
+static inline int input_buffer_getc(input_buffer_t *in) {
+    if (in->position == in->length &&
+        (in->refill == NULL || in->refill(in) != NO_ERROR)) {
+        return EOF;
+    }
+    return (unsigned char)in->data[in->position++];
+}
+
+/** @brief Cofa ostatnio wczytany znak.
+ * Może zostać wywołana tylko bezpośrednio po @ref input_buffer_getc.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia,
+ * @param[in] ch          – cofany znak; EOF jest ignorowany.
+ */
+static inline void input_buffer_ungetc(input_buffer_t *in, int ch) {
+    if (ch != EOF) {
+        in->position--;
+    }
+}
+
+/** @brief Sprawdza, czy w buforze pozostały nieprzeczytane znaki.
+ * Nie wczytuje nowych danych.
+ * @param[in] in          – wskaźnik na strukturę wejścia.
+ * @return Wartość @p true, jeżeli w buforze są nieprzeczytane znaki.
+ */
+static inline bool input_buffer_has_buffered_data(const input_buffer_t *in) {
+    return in->position < in->length;
+}
+
+/** @brief Inicjuje buforowane wyjście zapisujące do deskryptora.
+ * Zapis jest blokujący - opróżnienie bufora zapisuje wszystkie dane.
+ * @param[out] out        – wskaźnik na inicjowaną strukturę,
+ * @param[in] fd          – deskryptor pliku,
+ * @param[in] capacity    – rozmiar bufora.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci.
+ */
+io_error_t output_buffer_init_fd(output_buffer_t *out, int fd, size_t capacity);
+
+/** @brief Zwalnia pamięć zajmowaną przez buforowane wyjście.
+ * Nie zapisuje danych pozostających w buforze, ale czeka na zakończenie zapisów
+ * rozpoczętych wcześniej przez alternatywną implementację wyjścia.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia.
+ */
+void output_buffer_free(output_buffer_t *out);
+
+/** @brief Zapisuje dane z bufora.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p SYSTEM_ERROR
+ * jeżeli zapis się nie powiódł.
+ */
+static inline io_error_t output_buffer_flush(output_buffer_t *out) {
+    return out->length == 0 ? NO_ERROR : out->flush(out);
+}
+
+/** @brief Zapewnia miejsce na zadaną liczbę znaków w buforze.
+ * Jeżeli brakuje miejsca, opróżnia bufor, a gdy to nie wystarczy - powiększa go.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia,
+ * @param[in] size        – wymagana liczba wolnych znaków.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci, @p SYSTEM_ERROR jeżeli zapis się
+ * nie powiódł.
+ */
+io_error_t output_buffer_reserve_slow(output_buffer_t *out, size_t size);
+
+/** @brief Zapewnia miejsce na zadaną liczbę znaków w buforze.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia,
+ * @param[in] size        – wymagana liczba wolnych znaków.
+ * @return Kod błędu jak w @ref output_buffer_reserve_slow.
+ */
+static inline io_error_t output_buffer_reserve(output_buffer_t *out, size_t size) {
+    if (out->capacity - out->length >= size) {
+        return NO_ERROR;
+    }
+    return output_buffer_reserve_slow(out, size);
+}
+
+/** @brief Dopisuje ciąg znaków do bufora.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia,
+ * @param[in] str         – wskaźnik na znaki,
+ * @param[in] size        – liczba znaków.
+ * @return Kod błędu jak w @ref output_buffer_reserve_slow.
+ */
+io_error_t output_buffer_write(output_buffer_t *out, const char *str, size_t size);
+
+/** @brief Dopisuje napis zakończony znakiem \0 do bufora.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia,
+ * @param[in] str         – napis.
+ * @return Kod błędu jak w @ref output_buffer_reserve_slow.
+ */
+io_error_t output_buffer_write_string(output_buffer_t *out, const char *str);
+
+/** @brief Dopisuje znak do bufora.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia,
+ * @param[in] ch          – znak.
+ * @return Kod błędu jak w @ref output_buffer_reserve_slow.
+ */
+static inline io_error_t output_buffer_write_char(output_buffer_t *out, char ch) {
+    io_error_t error = output_buffer_reserve(out, 1);
+    if (error == NO_ERROR) {
+        out->data[out->length++] = ch;
+    }
+    return error;
+}
+
+/** @brief Dopisuje dziesiętną reprezentację liczby do bufora.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia,
+ * @param[in] value       – liczba.
+ * @return Kod błędu jak w @ref output_buffer_reserve_slow.
+ */
+io_error_t output_buffer_write_uint64(output_buffer_t *out, uint64_t value);
+
+#endif /* BUFFERED_IO_H */
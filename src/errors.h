@@ -19,6 +19,7 @@ typedef enum errors {
     LINE_IGNORED,
     MEMORY_ERROR,
     TERMINAL_ERROR,
+    SYSTEM_ERROR,
 } io_error_t;
 
 #endif // GAMMA_ERRORS_H
@@ -7,17 +7,31 @@
  */
 
 #include "gamma.h"
+#include "ownership_pyramid.h"
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef GAMMA_STATS
+/** Zwiększa licznik operacji wewnętrznych silnika o zadaną wartość. */
+#define GAMMA_STATS_ADD(g, counter, value) ((g)->stats.counter += (value))
+#else
+/** Liczniki operacji wewnętrznych są wyłączone - makro nic nie robi. */
+#define GAMMA_STATS_ADD(g, counter, value) ((void)(g))
+#endif
+
+/** Początkowa pojemność rzadkiej tablicy graczy. */
+#define SPARSE_PLAYERS_INITIAL_CAPACITY 16u
+/** Zapas na końcu tablicy właścicieli pól pozwalający odczytać cztery bajty od
+ * początku ostatniego elementu. */
+#define OWNERS_PADDING (sizeof(uint32_t) - 1)
 
 /**
- * Struktura przechowująca stan pola.
+ * Struktura przechowująca stan pola w strukturze find-union. Właściciel pola i ranga
+ * przechowywane są w osobnych tablicach o tych samych indeksach.
  */
 typedef struct field {
-    bool empty;      /**< Informacja czy dane pole jest puste. */
-    uint8_t rank;    /**< Ranga obszaru, którego rodzicem jest to pole (find-union). */
-    uint32_t player; /**< Numer gracza zajmującego pole. */
     struct field *parent; /**< Rodzic pola w danym obszarze (find-union). */
 } field_t;
 
@@ -26,6 +40,7 @@ typedef struct field {
  */
 typedef struct player {
     bool golden_move_done; /**< Informacja czy gracz wykonał już złoty ruch. */
+    bool active; /**< Informacja czy gracz jest na liście graczy aktywnych. */
     uint32_t areas; /**< Liczba rozłącznych obszarów zajmowanych przez gracza. */
     uint64_t occupied_fields;     /**< Liczba pól zajmowanych przez gracza. */
     uint64_t border_empty_fields; /**< Liczba pól, na których gracz może postawić
@@ -44,23 +59,283 @@ struct gamma {
     uint32_t width;           /**< Liczba kolumn planszy. */
     uint64_t occupied_fields; /**< Łączna liczba zajętych pól na planszy. */
 
-    player_t *players; /**< Tablica danych graczy. */
-    field_t **board;   /**< Tablica 2D przedstawiająca planszę. */
+    player_t *players; /**< Dane graczy: dla co najwyżej @ref GAMMA_DENSE_PLAYERS_LIMIT
+                        * graczy tablica indeksowana numerem gracza modulo liczba
+                        * graczy, w przeciwnym przypadku dane graczy aktywnych
+                        * w kolejności z @p active_players. */
+    uint32_t *active_players; /**< Numery graczy, którzy wykonali ruch, w kolejności
+                               * pierwszego ruchu. */
+    uint32_t active_players_num; /**< Liczba graczy aktywnych. */
+    uint32_t players_capacity;   /**< Pojemność tablic @p players
+                                  * i @p active_players. */
+    uint32_t players_with_fields;    /**< Liczba graczy zajmujących pola. */
+    uint32_t max_player_with_fields; /**< Największy numer gracza zajmującego pola
+                                      * lub 0. */
+    uint64_t leader_busy_fields; /**< Największa liczba pól zajętych przez gracza. */
+    uint32_t leaders; /**< Liczba graczy zajmujących @p leader_busy_fields pól, jeżeli
+                       * jest ona dodatnia. */
+    uint32_t leader;  /**< Numer gracza zajmującego @p leader_busy_fields pól, jeżeli
+                       * @p leaders jest równe 1. */
+    uint32_t *player_slots; /**< Tablica mieszająca o liczbie miejsc wyznaczonej
+                             * przez @ref player_slots_count, zawierających indeks
+                             * gracza w @p players powiększony o 1 lub 0, albo
+                             * NULL, jeżeli tablica graczy jest indeksowana
+                             * bezpośrednio. */
+    field_t *fields;   /**< Pola planszy w kolejności wyznaczonej przez
+                        * @ref field_index. */
+    uint8_t *ranks;    /**< Rangi obszarów, których rodzicami są pola (find-union). */
+    void *owners;      /**< Numery graczy zajmujących pola lub 0 dla pól pustych. */
+    unsigned owner_bytes; /**< Rozmiar elementu tablicy @p owners: 1, 2 lub 4 bajty,
+                           * najmniejszy mieszczący numer każdego gracza. */
+    uint32_t owner_mask;  /**< Maska @p 8 * owner_bytes najmłodszych bitów. */
+    ownership_pyramid_t *pyramid; /**< Piramida zajętości planszy lub NULL, jeżeli
+                                   * minimapa nie była jeszcze używana. */
+    uint32_t *split_search; /**< Tablice przeszukiwania wgłąb
+                             * @ref gamma_golden_possible_all lub NULL, jeżeli nie
+                             * były jeszcze potrzebne. */
+    unsigned paths; /**< Flagi @ref gamma_path_t wykonanych kosztownych ścieżek. */
+    uint64_t memory_limit; /**< Limit pamięci gry dla struktur tworzonych na
+                            * żądanie lub 0, jeżeli nie ma limitu. */
+    gamma_allocator_t allocator; /**< Alokator całej pamięci gry. */
+#ifdef GAMMA_STATS
+    gamma_stats_t stats; /**< Liczniki operacji wewnętrznych silnika. */
+#endif
 };
 
+#ifdef GAMMA_TILED_LAYOUT
+/** Bok kwadratowego kafelka planszy; wskaźniki rodziców 16x16 pól zajmują pół
+ * strony 4 KiB. */
+#define TILE_SIDE 16
+/** Liczba bitów numeru kolumny (wiersza) pola wewnątrz kafelka. */
+#define TILE_SHIFT 4
+
+/** Bity liczby od 0 do 15 rozsunięte na parzyste pozycje (kod Mortona). */
+static const uint8_t morton_spread[TILE_SIDE] = {0,  1,  4,  5,  16, 17, 20, 21,
+                                                 64, 65, 68, 69, 80, 81, 84, 85};
+
+/** @brief Wyznacza indeks pola w tablicy pól planszy.
+ * Plansza podzielona jest na kafelki 16x16 ułożone wierszami, a pola wewnątrz
+ * kafelka ułożone są w porządku Mortona (Z-order). Dzięki temu bloki 2x2 pól
+ * mieszczą się w jednej linii pamięci podręcznej, a cały kafelek w jednej
+ * stronie, więc również sąsiedzi pionowi leżą zwykle blisko siebie.
+ * @param[in] width       – szerokość planszy,
+ * @param[in] x           – numer kolumny,
+ * @param[in] y           – numer wiersza.
+ * @return Indeks pola.
+ */
+static inline size_t field_index(uint32_t width, uint32_t x, uint32_t y) {
+    const size_t tile_columns = ((size_t)width + TILE_SIDE - 1) >> TILE_SHIFT;
+    const size_t tile = (y >> TILE_SHIFT) * tile_columns + (x >> TILE_SHIFT);
+    return (tile << (2 * TILE_SHIFT)) | morton_spread[x & (TILE_SIDE - 1)] |
+           (size_t)morton_spread[y & (TILE_SIDE - 1)] << 1;
+}
+
+/** @brief Wyznacza rozmiar tablicy pól planszy.
+ * Plansza uzupełniana jest do pełnych kafelków; pola uzupełnienia nie są używane.
+ * @param[in] width       – szerokość planszy,
+ * @param[in] height      – wysokość planszy.
+ * @return Liczba elementów tablicy pól.
+ */
+static inline uint64_t board_fields_count(uint32_t width, uint32_t height) {
+    const uint64_t tile_columns = ((uint64_t)width + TILE_SIDE - 1) >> TILE_SHIFT;
+    const uint64_t tile_rows = ((uint64_t)height + TILE_SIDE - 1) >> TILE_SHIFT;
+    return tile_columns * tile_rows * TILE_SIDE * TILE_SIDE;
+}
+#else
+/** @brief Wyznacza indeks pola w tablicy pól planszy ułożonej wierszami.
+ * @param[in] width       – szerokość planszy,
+ * @param[in] x           – numer kolumny,
+ * @param[in] y           – numer wiersza.
+ * @return Indeks pola.
+ */
+static inline size_t field_index(uint32_t width, uint32_t x, uint32_t y) {
+    return (size_t)y * width + x;
+}
+
+/** @brief Wyznacza rozmiar tablicy pól planszy.
+ * @param[in] width       – szerokość planszy,
+ * @param[in] height      – wysokość planszy.
+ * @return Liczba elementów tablicy pól.
+ */
+static inline uint64_t board_fields_count(uint32_t width, uint32_t height) {
+    return (uint64_t)width * height;
+}
+#endif /* GAMMA_TILED_LAYOUT */
+
+/** @brief Zwraca wskaźnik na pole planszy.
+ * Razem z @ref owner_at i @ref set_owner jedyne miejsca, w których silnik odwołuje
+ * się do tablic pól, aby ułożenie pól w pamięci zależało wyłącznie od
+ * @ref field_index.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny, mniejszy niż szerokość planszy,
+ * @param[in] y       – numer wiersza, mniejszy niż wysokość planszy.
+ * @return Wskaźnik na pole.
+ */
+static inline field_t *field_at(const gamma_t *g, uint32_t x, uint32_t y) {
+    return &g->fields[field_index(g->width, x, y)];
+}
+
+/** @brief Zwraca numer gracza zajmującego pole.
+ * Odczytuje bez rozgałęzień cztery bajty od początku elementu tablicy i odrzuca
+ * bajty kolejnych elementów; tablica ma na końcu @ref OWNERS_PADDING bajtów
+ * zapasu. Odczyt jest wykonywany przy każdym sprawdzeniu sąsiada, więc wybór
+ * rozmiaru elementu instrukcją switch wyraźnie spowalniał ruchy.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny, mniejszy niż szerokość planszy,
+ * @param[in] y       – numer wiersza, mniejszy niż wysokość planszy.
+ * @return Numer gracza lub 0, jeżeli pole jest puste.
+ */
+static inline uint32_t owner_at(const gamma_t *g, uint32_t x, uint32_t y) {
+    const size_t index = field_index(g->width, x, y);
+    uint32_t owner;
+    memcpy(&owner, (const char *)g->owners + index * g->owner_bytes, sizeof(owner));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return owner >> (8 * (sizeof(owner) - g->owner_bytes));
+#else
+    return owner & g->owner_mask;
+#endif
+}
+
+/** @brief Ustawia numer gracza zajmującego pole.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny, mniejszy niż szerokość planszy,
+ * @param[in] y       – numer wiersza, mniejszy niż wysokość planszy,
+ * @param[in] player  – numer gracza nie większy niż liczba graczy lub 0 dla pola
+ *                      pustego.
+ */
+static inline void set_owner(gamma_t *g, uint32_t x, uint32_t y, uint32_t player) {
+    const size_t index = field_index(g->width, x, y);
+    switch (g->owner_bytes) {
+    case sizeof(uint8_t):
+        ((uint8_t *)g->owners)[index] = (uint8_t)player;
+        break;
+    case sizeof(uint16_t):
+        ((uint16_t *)g->owners)[index] = (uint16_t)player;
+        break;
+    default:
+        ((uint32_t *)g->owners)[index] = player;
+    }
+}
+
+/** @brief Wyznacza rozmiar tablicy właścicieli pól.
+ * @param[in] fields      – liczba pól planszy,
+ * @param[in] owner_bytes – rozmiar elementu tablicy.
+ * @return Liczba bajtów.
+ */
+static inline size_t owners_size(size_t fields, unsigned owner_bytes) {
+    return fields * owner_bytes + OWNERS_PADDING;
+}
+
+/** @brief Wyznacza rozmiar numeru gracza w tablicy właścicieli pól.
+ * @param[in] players – liczba graczy.
+ * @return Liczba bajtów: 1, 2 lub 4.
+ */
+static inline unsigned owner_bytes_for(uint32_t players) {
+    if (players <= UINT8_MAX) {
+        return sizeof(uint8_t);
+    }
+    return players <= UINT16_MAX ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+/** @brief Wyznacza początkową pojemność tablicy graczy.
+ * @param[in] players – liczba graczy.
+ * @return Liczba graczy, jeżeli tablica jest indeksowana bezpośrednio, lub
+ * początkowa pojemność tablicy rzadkiej.
+ */
+static inline uint32_t initial_players_capacity(uint32_t players) {
+    return players <= GAMMA_DENSE_PLAYERS_LIMIT ? players
+                                                : SPARSE_PLAYERS_INITIAL_CAPACITY;
+}
+
+/** @brief Wyznacza liczbę miejsc tablicy mieszającej graczy.
+ * Jest to najmniejsza potęga dwójki nie mniejsza niż dwukrotność pojemności, także
+ * gdy pojemność (równa wtedy liczbie graczy) nie jest potęgą dwójki.
+ * @param[in] capacity – pojemność rzadkiej tablicy graczy.
+ * @return Liczba miejsc, potęga dwójki.
+ */
+static inline size_t player_slots_count(uint32_t capacity) {
+    size_t count = 1;
+    while (count < 2 * (size_t)capacity) {
+        count *= 2;
+    }
+    return count;
+}
+
+/** @brief Wyznacza pamięć tablic graczy.
+ * @param[in] players  – liczba graczy,
+ * @param[in] capacity – pojemność tablic graczy.
+ * @return Liczba bajtów.
+ */
+static inline uint64_t players_table_bytes(uint32_t players, uint32_t capacity) {
+    const uint64_t bytes = (uint64_t)capacity * (sizeof(player_t) + sizeof(uint32_t));
+    if (players <= GAMMA_DENSE_PLAYERS_LIMIT) {
+        return bytes;
+    }
+    return bytes + player_slots_count(capacity) * sizeof(uint32_t);
+}
+
+/** @brief Wyznacza pierwsze miejsce gracza w tablicy mieszającej.
+ * @param[in] player  – numer gracza,
+ * @param[in] slots   – liczba miejsc tablicy, potęga dwójki.
+ * @return Indeks miejsca.
+ */
+static inline size_t player_slot(uint32_t player, size_t slots) {
+    uint32_t hash = player * 0x9E3779B1u;
+    hash ^= hash >> 16u;
+    return hash & (slots - 1);
+}
+
+/** @brief Wpisuje gracza do tablicy mieszającej.
+ * Tablica musi mieć wolne miejsce, a gracza nie może w niej jeszcze być.
+ * @param[in,out] slots – tablica mieszająca,
+ * @param[in] count     – liczba miejsc tablicy, potęga dwójki,
+ * @param[in] player    – numer gracza,
+ * @param[in] index     – indeks gracza w tablicy danych graczy.
+ */
+static void insert_player_slot(uint32_t *slots, size_t count, uint32_t player,
+                               uint32_t index) {
+    size_t slot = player_slot(player, count);
+    while (slots[slot] != 0) {
+        slot = (slot + 1) & (count - 1);
+    }
+    slots[slot] = index + 1;
+}
+
+#ifdef GAMMA_TILED_LAYOUT
+/** Przechodzi wszystkie pola planszy gry @p g kafelek po kafelku, ustawiając
+ * zmienne @p column i @p row; kolejne pola leżą blisko siebie w pamięci. */
+#define FOR_EACH_FIELD(g, column, row)                                                 \
+    for (uint32_t tile_row_ = 0; tile_row_ < (g)->height; tile_row_ += TILE_SIDE)      \
+        for (uint32_t tile_column_ = 0; tile_column_ < (g)->width;                     \
+             tile_column_ += TILE_SIDE)                                                \
+            for (uint32_t row = tile_row_;                                             \
+                 row < (g)->height && row < tile_row_ + TILE_SIDE; row++)              \
+                for (uint32_t column = tile_column_;                                   \
+                     column < (g)->width && column < tile_column_ + TILE_SIDE; column++)
+#else
+/** Przechodzi wszystkie pola planszy gry @p g wierszami, ustawiając zmienne
+ * @p column i @p row. */
+#define FOR_EACH_FIELD(g, column, row)                                                 \
+    for (uint32_t row = 0; row < (g)->height; row++)                                   \
+        for (uint32_t column = 0; column < (g)->width; column++)
+#endif /* GAMMA_TILED_LAYOUT */
+
 /** @brief Operacja find (find-union) na planszy gry.
  * Zwraca najstarszego rodzica (lidera) należącego do danego obszaru na planszy.
  * (Operacja na strukturze danych find-union).
  * Funkcja stosuje metodę path-halving skracania ścieżki do najstarszego rodzica.
  * Złożoność O(a(n)) gdzie a to odwrotna funkcja Ackermanna [efektywnie O(1)].
+ * @param[in,out] g        – wskaźnik na strukturę przechowującą stan gry,
  * @param[in,out] field    – wskaźnik na dowolne pole należące do planszy.
  * @return Wskaźnik na jednoznacznie wyznaczonego przedstawiciela danego obszaru
  * (find-union).
  */
-static inline field_t *fu_find(field_t *field) {
+static inline field_t *fu_find(gamma_t *g, field_t *field) {
+    GAMMA_STATS_ADD(g, find_calls, 1);
     while (field->parent != field) {
         field->parent = field->parent->parent;
         field = field->parent;
+        GAMMA_STATS_ADD(g, find_path_length, 1);
     }
 
     return field;
@@ -71,78 +346,364 @@ static inline field_t *fu_find(field_t *field) {
  * Funkcja stosuje metodę union by rank do wyznaczania nowego lidera po połączeniu
  * dwóch obszarów.
  * Złożoność O(a(n)) gdzie a to odwrotna funkcja Ackermanna [efektywnie O(1)].
+ * @param[in,out] g    – wskaźnik na strukturę przechowującą stan gry,
  * @param[in,out] x    – wskaźnik na dowolne pole należące do planszy,
  * @param[in,out] y    – wskaźnik na dowolne pole należące do planszy.
  * @return Wartość logiczna @p false jeżeli pola należały już do tego samego obszaru,
  * @p true jeżeli obszary zostały połączone.
  */
-static inline bool fu_union(field_t *x, field_t *y) {
-    field_t *x_root = fu_find(x);
-    field_t *y_root = fu_find(y);
+static inline bool fu_union(gamma_t *g, field_t *x, field_t *y) {
+    field_t *x_root = fu_find(g, x);
+    field_t *y_root = fu_find(g, y);
 
     if (x_root == y_root) {
         return false;
     }
+    GAMMA_STATS_ADD(g, union_merges, 1);
 
-    if (x_root->rank < y_root->rank) {
+    uint8_t *x_rank = &g->ranks[x_root - g->fields];
+    uint8_t *y_rank = &g->ranks[y_root - g->fields];
+    if (*x_rank < *y_rank) {
         field_t *tmp = x_root;
         x_root = y_root;
         y_root = tmp;
+        uint8_t *tmp_rank = x_rank;
+        x_rank = y_rank;
+        y_rank = tmp_rank;
     }
 
     y_root->parent = x_root;
-    if (x_root->rank == y_root->rank) {
-        x_root->rank += 1;
+    if (*x_rank == *y_rank) {
+        *x_rank += 1;
     }
 
     return true;
 }
 
-/** @brief Alokuje planszę do gry Gamma.
- * Alokuje planszę o zadanych wymiarach składającą się z pustych pól.
- * Złożoność O(height*width).
- * @param[in] width       – szerokość planszy,
- * @param[in] height      – wysokość planszy.
- * @return Wskaźnik na planszę lub @p NULL jeśli nie udało się zaalokować pamięci.
+/** @brief Alokuje blok pamięci funkcją malloc.
+ * @param[in] context     – nieużywany,
+ * @param[in] size        – rozmiar bloku.
+ * @return Wskaźnik na blok lub NULL, jeśli nie udało się zaalokować pamięci.
  */
-static field_t **allocate_board(uint32_t width, uint32_t height) {
-    field_t **board = malloc(height * sizeof(field_t *));
-    if (board == NULL) {
-        return NULL;
+static void *default_alloc(void *context, size_t size) {
+    (void)context;
+    return malloc(size);
+}
+
+/** @brief Zmienia rozmiar bloku pamięci funkcją realloc.
+ * @param[in] context     – nieużywany,
+ * @param[in] ptr         – wskaźnik na blok,
+ * @param[in] old_size    – nieużywany,
+ * @param[in] new_size    – nowy rozmiar bloku.
+ * @return Wskaźnik na blok lub NULL, jeśli nie udało się zaalokować pamięci.
+ */
+static void *default_realloc(void *context, void *ptr, size_t old_size,
+                             size_t new_size) {
+    (void)context;
+    (void)old_size;
+    return realloc(ptr, new_size);
+}
+
+/** @brief Zwalnia blok pamięci funkcją free.
+ * @param[in] context     – nieużywany,
+ * @param[in] ptr         – wskaźnik na blok,
+ * @param[in] size        – nieużywany.
+ */
+static void default_free(void *context, void *ptr, size_t size) {
+    (void)context;
+    (void)size;
+    free(ptr);
+}
+
+/** Alokator używany przez @ref gamma_new. */
+static const gamma_allocator_t default_allocator = {default_alloc, default_realloc,
+                                                    default_free, NULL};
+
+/** @brief Zwalnia tablice pól planszy.
+ * Nic nie robi z tablicami o wartości NULL.
+ * @param[in,out] g       – wskaźnik na strukturę gry.
+ */
+static void free_board(gamma_t *g) {
+    const size_t fields = board_fields_count(g->width, g->height);
+    const gamma_allocator_t *allocator = &g->allocator;
+    if (g->fields != NULL) {
+        allocator->free(allocator->context, g->fields, fields * sizeof(field_t));
+    }
+    if (g->ranks != NULL) {
+        allocator->free(allocator->context, g->ranks, fields * sizeof(uint8_t));
+    }
+    if (g->owners != NULL) {
+        allocator->free(allocator->context, g->owners,
+                        owners_size(fields, g->owner_bytes));
+    }
+}
+
+/** @brief Zwalnia tablice graczy.
+ * Nic nie robi z tablicami o wartości NULL.
+ * @param[in,out] g       – wskaźnik na strukturę gry.
+ */
+static void free_players(gamma_t *g) {
+    const gamma_allocator_t *allocator = &g->allocator;
+    const size_t capacity = g->players_capacity;
+    if (g->players != NULL) {
+        allocator->free(allocator->context, g->players, capacity * sizeof(player_t));
+    }
+    if (g->active_players != NULL) {
+        allocator->free(allocator->context, g->active_players,
+                        capacity * sizeof(uint32_t));
+    }
+    if (g->player_slots != NULL) {
+        allocator->free(allocator->context, g->player_slots,
+                        player_slots_count(g->players_capacity) * sizeof(uint32_t));
     }
+}
 
-    uint32_t allocated_rows = 0;
-    for (; allocated_rows < height; allocated_rows++) {
-        board[allocated_rows] = malloc((uint64_t)width * sizeof(struct field));
-        if (board[allocated_rows] == NULL) {
-            break;
+/** @brief Alokuje puste tablice graczy o zadanej pojemności.
+ * @param[in] allocator   – wskaźnik na alokator,
+ * @param[in] capacity    – pojemność tablic,
+ * @param[in] sparse      – informacja czy alokować tablicę mieszającą,
+ * @param[out] players    – wskaźnik na tablicę danych graczy,
+ * @param[out] active     – wskaźnik na tablicę numerów graczy aktywnych,
+ * @param[out] slots      – wskaźnik na tablicę mieszającą lub NULL.
+ * @return Wartość @p true, jeżeli udało się zaalokować pamięć, @p false
+ * w przeciwnym przypadku; wtedy nic nie pozostaje zaalokowane.
+ */
+static bool allocate_players_arrays(const gamma_allocator_t *allocator,
+                                    uint32_t capacity, bool sparse, player_t **players,
+                                    uint32_t **active, uint32_t **slots) {
+    const size_t players_size = (size_t)capacity * sizeof(player_t);
+    const size_t active_size = (size_t)capacity * sizeof(uint32_t);
+    const size_t slots_size = player_slots_count(capacity) * sizeof(uint32_t);
+    *players = allocator->alloc(allocator->context, players_size);
+    *active = allocator->alloc(allocator->context, active_size);
+    *slots = sparse ? allocator->alloc(allocator->context, slots_size) : NULL;
+    if (*players == NULL || *active == NULL || (sparse && *slots == NULL)) {
+        if (*players != NULL) {
+            allocator->free(allocator->context, *players, players_size);
+        }
+        if (*active != NULL) {
+            allocator->free(allocator->context, *active, active_size);
         }
-        for (uint32_t i = 0; i < width; i++) {
-            board[allocated_rows][i].empty = true;
-            board[allocated_rows][i].parent = &board[allocated_rows][i];
-            board[allocated_rows][i].rank = 1;
-            board[allocated_rows][i].player = 0;
+        if (*slots != NULL) {
+            allocator->free(allocator->context, *slots, slots_size);
         }
+        return false;
+    }
+    memset(*players, 0, players_size);
+    if (sparse) {
+        memset(*slots, 0, slots_size);
     }
+    return true;
+}
 
-    if (allocated_rows == height) {
-        return board;
+/** @brief Alokuje tablice graczy do gry Gamma.
+ * Dla co najwyżej @ref GAMMA_DENSE_PLAYERS_LIMIT graczy alokuje dane wszystkich graczy,
+ * a w przeciwnym przypadku pustą tablicę rzadką.
+ * @param[in,out] g       – wskaźnik na strukturę gry z ustawioną liczbą graczy
+ *                          i alokatorem.
+ * @return Wartość @p true, jeżeli udało się zaalokować pamięć, @p false
+ * w przeciwnym przypadku.
+ */
+static bool allocate_players(gamma_t *g) {
+    g->players_capacity = initial_players_capacity(g->players_num);
+    g->active_players_num = 0;
+    return allocate_players_arrays(&g->allocator, g->players_capacity,
+                                   g->players_num > GAMMA_DENSE_PLAYERS_LIMIT,
+                                   &g->players, &g->active_players, &g->player_slots);
+}
+
+/** @brief Podwaja pojemność rzadkiej tablicy graczy.
+ * Pojemność nie przekracza liczby graczy. Wskaźniki na dane graczy tracą ważność.
+ * @param[in,out] g       – wskaźnik na strukturę gry z rzadką tablicą graczy.
+ * @return Wartość @p true, jeżeli udało się zaalokować pamięć, @p false
+ * w przeciwnym przypadku; wtedy tablica pozostaje bez zmian.
+ */
+static bool grow_players(gamma_t *g) {
+    const uint32_t capacity = g->players_capacity <= g->players_num / 2
+                                  ? 2 * g->players_capacity
+                                  : g->players_num;
+    player_t *players;
+    uint32_t *active, *slots;
+    if (!allocate_players_arrays(&g->allocator, capacity, true, &players, &active,
+                                 &slots)) {
+        return false;
+    }
+    memcpy(players, g->players, g->active_players_num * sizeof(player_t));
+    memcpy(active, g->active_players, g->active_players_num * sizeof(uint32_t));
+    for (uint32_t i = 0; i < g->active_players_num; i++) {
+        insert_player_slot(slots, player_slots_count(capacity), active[i], i);
+    }
+
+    free_players(g);
+    g->players = players;
+    g->active_players = active;
+    g->player_slots = slots;
+    g->players_capacity = capacity;
+    return true;
+}
+
+/** @brief Alokuje planszę do gry Gamma.
+ * Alokuje planszę o wymiarach zapisanych w strukturze gry składającą się z pustych
+ * pól. Każda z tablic pól zajmuje jeden ciągły blok pamięci, więc alokator może
+ * pokryć planszę dużymi stronami. Tablica właścicieli ma elementy o rozmiarze
+ * @p g->owner_bytes.
+ * Złożoność O(height*width).
+ * @param[in,out] g       – wskaźnik na strukturę gry z ustawionymi wymiarami,
+ *                          liczbą graczy i alokatorem.
+ * @return Wartość @p true, jeżeli udało się zaalokować pamięć, @p false
+ * w przeciwnym przypadku.
+ */
+static bool allocate_board(gamma_t *g) {
+    const size_t fields = board_fields_count(g->width, g->height);
+    const gamma_allocator_t *allocator = &g->allocator;
+    g->owner_bytes = owner_bytes_for(g->players_num);
+    g->owner_mask = UINT32_MAX >> (8 * (sizeof(uint32_t) - g->owner_bytes));
+    g->fields = allocator->alloc(allocator->context, fields * sizeof(field_t));
+    g->ranks = allocator->alloc(allocator->context, fields * sizeof(uint8_t));
+    const size_t owners_bytes = owners_size(fields, g->owner_bytes);
+    g->owners = allocator->alloc(allocator->context, owners_bytes);
+    if (g->fields == NULL || g->ranks == NULL || g->owners == NULL) {
+        free_board(g);
+        return false;
     }
 
-    for (uint32_t row = 0; row < allocated_rows; row++) {
-        free(board[row]);
+    // Pola uzupełnienia kafelków nigdy nie są zajmowane, więc zerujemy je razem
+    // z pozostałymi i z zapasem na końcu tablicy.
+    memset(g->owners, 0, owners_bytes);
+    FOR_EACH_FIELD(g, column, row) {
+        field_t *field = field_at(g, column, row);
+        field->parent = field;
+        g->ranks[field - g->fields] = 1;
     }
-    free(board);
 
-    return NULL;
+    return true;
+}
+
+/** @brief Mnoży liczby, zwracając @p UINT64_MAX w przypadku przepełnienia.
+ * @param[in] a           – pierwszy czynnik,
+ * @param[in] b           – drugi czynnik.
+ * @return Iloczyn lub @p UINT64_MAX.
+ */
+static inline uint64_t saturating_multiply(uint64_t a, uint64_t b) {
+    uint64_t product;
+    return __builtin_mul_overflow(a, b, &product) ? UINT64_MAX : product;
+}
+
+/** @brief Dodaje liczby, zwracając @p UINT64_MAX w przypadku przepełnienia.
+ * @param[in] a           – pierwszy składnik,
+ * @param[in] b           – drugi składnik.
+ * @return Suma lub @p UINT64_MAX.
+ */
+static inline uint64_t saturating_add(uint64_t a, uint64_t b) {
+    uint64_t sum;
+    return __builtin_add_overflow(a, b, &sum) ? UINT64_MAX : sum;
+}
+
+/** @brief Wyznacza pamięć struktur alokowanych przez @ref gamma_new.
+ * Pole @p caches jest zerowane.
+ * @param[in] width       – szerokość planszy,
+ * @param[in] height      – wysokość planszy,
+ * @param[in] players     – liczba graczy,
+ * @param[in] players_capacity – pojemność tablic graczy,
+ * @param[out] usage      – wskaźnik na strukturę, do której zapisane zostaną wyniki.
+ */
+static void fixed_memory_usage(uint32_t width, uint32_t height, uint32_t players,
+                               uint32_t players_capacity, gamma_memory_t *usage) {
+    const uint64_t fields = board_fields_count(width, height);
+    usage->union_find = saturating_multiply(fields, sizeof(field_t) + sizeof(uint8_t));
+    usage->board = saturating_add(saturating_multiply(fields, owner_bytes_for(players)),
+                                  OWNERS_PADDING);
+    usage->players =
+        saturating_add(sizeof(gamma_t), players_table_bytes(players, players_capacity));
+    usage->caches = 0;
+    usage->total = saturating_add(saturating_add(usage->board, usage->union_find),
+                                  usage->players);
+}
+
+uint64_t gamma_estimate_memory(uint32_t width, uint32_t height, uint32_t players,
+                               uint32_t areas) {
+    if (!gamma_game_new_arguments_valid(width, height, players, areas)) {
+        return 0;
+    }
+    gamma_memory_t usage;
+    fixed_memory_usage(width, height, players, initial_players_capacity(players),
+                       &usage);
+    return usage.total;
+}
+
+/** @brief Wyznacza rozmiar tablic przeszukiwania wgłąb
+ * @ref gamma_golden_possible_all: numeru odwiedzenia, najmniejszego numeru
+ * osiągalnego krawędzią powrotną, stosu (po 4 bajty) i stanu pola (1 bajt).
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry.
+ * @return Liczba bajtów.
+ */
+static inline uint64_t split_search_bytes(const gamma_t *g) {
+    return saturating_multiply((uint64_t)g->width * g->height,
+                               3 * sizeof(uint32_t) + sizeof(uint8_t));
+}
+
+bool gamma_memory_usage(const gamma_t *g, gamma_memory_t *usage) {
+    if (g == NULL) {
+        return false;
+    }
+    fixed_memory_usage(g->width, g->height, g->players_num, g->players_capacity, usage);
+    usage->caches = ownership_pyramid_memory_usage(g->pyramid);
+    if (g->split_search != NULL) {
+        usage->caches = saturating_add(usage->caches, split_search_bytes(g));
+    }
+    usage->total += usage->caches;
+    return true;
+}
+
+void gamma_set_memory_limit(gamma_t *g, uint64_t limit) {
+    if (g != NULL) {
+        g->memory_limit = limit;
+    }
+}
+
+/** @brief Sprawdza, czy strukturę tworzoną na żądanie można zaalokować bez
+ * przekroczenia limitu pamięci gry.
+ * Ustawia @p errno na ENOMEM, jeżeli limit zostałby przekroczony.
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] bytes       – rozmiar struktury w bajtach.
+ * @return Wartość @p true, jeżeli struktura mieści się w limicie, @p false
+ * w przeciwnym przypadku.
+ */
+static bool cache_fits_memory_limit(const gamma_t *g, uint64_t bytes) {
+    if (g->memory_limit == 0) {
+        return true;
+    }
+    gamma_memory_t usage;
+    gamma_memory_usage(g, &usage);
+    if (saturating_add(usage.total, bytes) > g->memory_limit) {
+        errno = ENOMEM;
+        return false;
+    }
+    return true;
 }
 
 gamma_t *gamma_new(uint32_t width, uint32_t height, uint32_t players, uint32_t areas) {
+    return gamma_new_ex(width, height, players, areas, NULL);
+}
+
+gamma_t *gamma_new_ex(uint32_t width, uint32_t height, uint32_t players,
+                      uint32_t areas, const gamma_allocator_t *allocator) {
     if (!gamma_game_new_arguments_valid(width, height, players, areas)) {
         return NULL;
     }
+    if (allocator == NULL) {
+        allocator = &default_allocator;
+    } else if (allocator->alloc == NULL || allocator->realloc == NULL ||
+               allocator->free == NULL) {
+        return NULL;
+    }
+    // Gry, której nie da się zaadresować, nie próbujemy nawet częściowo alokować.
+    if (gamma_estimate_memory(width, height, players, areas) >= SIZE_MAX) {
+        errno = ENOMEM;
+        return NULL;
+    }
 
-    gamma_t *game = malloc(sizeof(gamma_t));
+    gamma_t *game = allocator->alloc(allocator->context, sizeof(gamma_t));
     if (game == NULL) {
         errno = ENOMEM;
         return NULL;
@@ -154,18 +715,29 @@ gamma_t *gamma_new(uint32_t width, uint32_t height, uint32_t players, uint32_t a
     game->players_num = players;
 
     game->occupied_fields = 0;
-
-    game->players = calloc(players, sizeof(player_t));
-    if (game->players != NULL) {
-        game->board = allocate_board(width, height);
-        if (game->board != NULL) {
+    game->players_with_fields = 0;
+    game->max_player_with_fields = 0;
+    game->leader_busy_fields = 0;
+    game->leaders = 0;
+    game->leader = 0;
+    game->pyramid = NULL;
+    game->split_search = NULL;
+    game->paths = 0;
+    game->memory_limit = 0;
+    game->allocator = *allocator;
+#ifdef GAMMA_STATS
+    memset(&game->stats, 0, sizeof(gamma_stats_t));
+#endif
+
+    if (allocate_players(game)) {
+        if (allocate_board(game)) {
             return game;
         }
 
-        free(game->players);
+        free_players(game);
     }
 
-    free(game);
+    allocator->free(allocator->context, game, sizeof(gamma_t));
     errno = ENOMEM;
     return NULL;
 }
@@ -175,12 +747,92 @@ void gamma_delete(gamma_t *g) {
         return;
     }
 
-    for (uint32_t row = 0; row < g->height; row++) {
-        free(g->board[row]);
+    // Struktura gry jest zwalniana jako ostatnia, więc alokator trzeba skopiować.
+    const gamma_allocator_t allocator = g->allocator;
+    free_board(g);
+    free_players(g);
+    ownership_pyramid_delete(g->pyramid);
+    if (g->split_search != NULL) {
+        allocator.free(allocator.context, g->split_search,
+                       (size_t)split_search_bytes(g));
+    }
+    allocator.free(allocator.context, g, sizeof(gamma_t));
+}
+
+/** Dane gracza, który nie wykonał jeszcze ruchu. */
+static const player_t inactive_player = {0};
+
+/** @brief Wyszukuje dane gracza.
+ * Złożoność O(1), w tablicy rzadkiej oczekiwana.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia nie większa niż liczba graczy.
+ * @return Wskaźnik na dane gracza lub NULL, jeżeli gracz nie ma danych w rzadkiej
+ * tablicy graczy.
+ */
+static inline player_t *find_player(const gamma_t *g, uint32_t player) {
+    if (g->player_slots == NULL) {
+        return &g->players[player % g->players_num];
+    }
+    const size_t count = player_slots_count(g->players_capacity);
+    for (size_t slot = player_slot(player, count);; slot = (slot + 1) & (count - 1)) {
+        const uint32_t index = g->player_slots[slot];
+        if (index == 0) {
+            return NULL;
+        }
+        if (g->active_players[index - 1] == player) {
+            return &g->players[index - 1];
+        }
+    }
+}
+
+/** @brief Zwraca dane gracza do odczytu.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia nie większa niż liczba graczy.
+ * @return Wskaźnik na dane gracza lub na dane gracza bez ruchów.
+ */
+static inline const player_t *player_state(const gamma_t *g, uint32_t player) {
+    const player_t *state = find_player(g, player);
+    return state != NULL ? state : &inactive_player;
+}
+
+/** @brief Zwraca dane gracza z listy graczy aktywnych.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] i       – indeks na liście, mniejszy niż liczba graczy aktywnych.
+ * @return Wskaźnik na dane gracza.
+ */
+static inline player_t *active_player(const gamma_t *g, uint32_t i) {
+    return g->player_slots == NULL
+               ? &g->players[g->active_players[i] % g->players_num]
+               : &g->players[i];
+}
+
+/** @brief Dopisuje gracza do listy graczy aktywnych, jeżeli jeszcze go na niej nie
+ * ma.
+ * W rzadkiej tablicy graczy tworzy przy tym dane gracza, więc wskaźniki na dane
+ * innych graczy mogą stracić ważność.
+ * Złożoność zamortyzowana O(1), w tablicy rzadkiej oczekiwana.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza, liczba dodatnia nie większa niż liczba graczy.
+ * @return Wskaźnik na dane gracza lub NULL, jeżeli nie udało się zaalokować
+ * pamięci.
+ */
+static player_t *activate_player(gamma_t *g, uint32_t player) {
+    player_t *state = find_player(g, player);
+    if (state != NULL && state->active) {
+        return state;
     }
-    free(g->board);
-    free(g->players);
-    free(g);
+    if (g->player_slots != NULL) {
+        if (g->active_players_num == g->players_capacity && !grow_players(g)) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        state = &g->players[g->active_players_num];
+        insert_player_slot(g->player_slots, player_slots_count(g->players_capacity),
+                           player, g->active_players_num);
+    }
+    state->active = true;
+    g->active_players[g->active_players_num++] = player;
+    return state;
 }
 
 /** @brief Sprawdza, czy pole należy do planszy.
@@ -206,8 +858,7 @@ static inline bool is_within_board(const gamma_t *g, int64_t x, int64_t y) {
  */
 static inline bool belongs_to_player(const gamma_t *g, int64_t x, int64_t y,
                                      uint32_t player) {
-    return is_within_board(g, x, y) && !g->board[y][x].empty &&
-           g->board[y][x].player == player;
+    return is_within_board(g, x, y) && owner_at(g, x, y) == player;
 }
 
 /** @brief Sprawdza, czy zadane pole sąsiaduje z polem zadanego gracza.
@@ -227,16 +878,15 @@ static inline bool has_neighbor(const gamma_t *g, int64_t x, int64_t y,
            belongs_to_player(g, x, y - 1, player);
 }
 
-/** @brief Zwraca wskaźnik na pole o zadanych koordynatach.
+/** @brief Zwraca numer gracza zajmującego pole o zadanych koordynatach.
  * Złożoność O(1).
  * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
  * @param[in] x       – numer kolumny,
  * @param[in] y       – numer wiersza.
- * @return Wartość @p true, jeśli pole sąsiaduje z dowolnym polem zadanego gracza,
- * a @p false w przeciwnym przypadku.
+ * @return Numer gracza lub 0, jeżeli pole jest puste lub nie należy do planszy.
  */
-static inline field_t *get_field(const gamma_t *g, int64_t x, int64_t y) {
-    return is_within_board(g, x, y) ? &g->board[y][x] : NULL;
+static inline uint32_t get_owner(const gamma_t *g, int64_t x, int64_t y) {
+    return is_within_board(g, x, y) ? owner_at(g, x, y) : 0;
 }
 
 /** @brief Łączy (union z find-union) pole z sąsiednimi obszarami tego samego gracza.
@@ -249,20 +899,19 @@ static inline field_t *get_field(const gamma_t *g, int64_t x, int64_t y) {
  * @return Liczbę pomyślnie przeprowadzonych operacji union (0, 1, 2, 3 lub 4).
  */
 static inline unsigned union_neighbors(gamma_t *g, uint32_t column, uint32_t row) {
-    field_t **board = g->board;
-    field_t *this_field = &board[row][column];
-    const uint32_t player = this_field->player;
+    field_t *this_field = field_at(g, column, row);
+    const uint32_t player = owner_at(g, column, row);
 
     unsigned merged_areas = 0;
 
     if (belongs_to_player(g, column + 1, row, player))
-        merged_areas += fu_union(this_field, &board[row][column + 1]);
+        merged_areas += fu_union(g, this_field, field_at(g, column + 1, row));
     if (belongs_to_player(g, column - 1, row, player))
-        merged_areas += fu_union(this_field, &board[row][column - 1]);
+        merged_areas += fu_union(g, this_field, field_at(g, column - 1, row));
     if (belongs_to_player(g, column, row + 1, player))
-        merged_areas += fu_union(this_field, &board[row + 1][column]);
+        merged_areas += fu_union(g, this_field, field_at(g, column, row + 1));
     if (belongs_to_player(g, column, row - 1, player))
-        merged_areas += fu_union(this_field, &board[row - 1][column]);
+        merged_areas += fu_union(g, this_field, field_at(g, column, row - 1));
 
     return merged_areas;
 }
@@ -285,8 +934,9 @@ static inline unsigned new_border_empty_fields(const gamma_t *g, int64_t x, int6
             if ((dx == 0 && dy == 0) || (dx != 0 && dy != 0)) {
                 continue;
             }
-            field_t *f = get_field(g, x + dx, y + dy);
-            if (f != NULL && f->empty && !has_neighbor(g, x + dx, y + dy, player)) {
+            if (is_within_board(g, x + dx, y + dy) &&
+                owner_at(g, x + dx, y + dy) == 0 &&
+                !has_neighbor(g, x + dx, y + dy, player)) {
                 new_nearby_empty_fields++;
             }
         }
@@ -305,19 +955,19 @@ static inline unsigned new_border_empty_fields(const gamma_t *g, int64_t x, int6
 static inline void decrement_neighbors_border_empty_fields(gamma_t *g, int64_t x,
                                                            int64_t y) {
     static const unsigned neighbors_count = 4;
-    field_t *neighbors[] = {get_field(g, x + 1, y), get_field(g, x - 1, y),
-                            get_field(g, x, y + 1), get_field(g, x, y - 1)};
+    uint32_t neighbors[] = {get_owner(g, x + 1, y), get_owner(g, x - 1, y),
+                            get_owner(g, x, y + 1), get_owner(g, x, y - 1)};
     for (unsigned i = 0; i < neighbors_count; i++) {
-        if (neighbors[i] == NULL || neighbors[i]->empty) {
+        if (neighbors[i] == 0) {
             continue;
         }
 
-        uint32_t neighbor = neighbors[i]->player;
-        g->players[neighbor % g->players_num].border_empty_fields--;
+        uint32_t neighbor = neighbors[i];
+        find_player(g, neighbor)->border_empty_fields--;
 
         for (unsigned j = i; j < neighbors_count; j++) {
-            if (neighbors[j] != NULL && neighbors[j]->player == neighbor) {
-                neighbors[j] = NULL;
+            if (neighbors[j] == neighbor) {
+                neighbors[j] = 0;
             }
         }
     }
@@ -335,29 +985,124 @@ static inline void decrement_neighbors_border_empty_fields(gamma_t *g, int64_t x
  */
 static inline bool would_exceed_areas_limit(const gamma_t *g, uint32_t player,
                                             uint32_t x, uint32_t y) {
-    return g->players[player % g->players_num].areas == g->max_areas &&
+    return player_state(g, player)->areas == g->max_areas &&
            !has_neighbor(g, x, y, player);
 }
 
+/** @brief Zapisuje w piramidzie zajętości blok 2x2 zawierający zadane pole.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry z piramidą,
+ * @param[in] column  – numer kolumny bloku,
+ * @param[in] row     – numer wiersza bloku.
+ */
+static void set_pyramid_block(const gamma_t *g, uint32_t column, uint32_t row) {
+    uint32_t owners[4];
+    unsigned count = 0;
+    for (uint64_t y = 2ull * row; y < 2ull * row + 2 && y < g->height; y++) {
+        for (uint64_t x = 2ull * column; x < 2ull * column + 2 && x < g->width; x++) {
+            owners[count++] = owner_at(g, x, y);
+        }
+    }
+    ownership_pyramid_set_block(g->pyramid, column, row, owners, count);
+}
+
+/** @brief Aktualizuje piramidę zajętości po zmianie zadanego pola.
+ * Nic nie robi, jeżeli piramida nie została utworzona.
+ * Złożoność O(log(max(width, height))).
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] x       – numer kolumny,
+ * @param[in] y       – numer wiersza.
+ */
+static inline void update_pyramid(const gamma_t *g, uint32_t x, uint32_t y) {
+    if (g->pyramid != NULL) {
+        set_pyramid_block(g, x / 2, y / 2);
+        ownership_pyramid_propagate(g->pyramid, x / 2, y / 2);
+    }
+}
+
+/** @brief Aktualizuje statystyki graczy po zajęciu pola przez gracza.
+ * Złożoność O(1).
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] state   – wskaźnik na dane gracza ze zwiększoną liczbą pól.
+ */
+static inline void busy_fields_increased(gamma_t *g, uint32_t player,
+                                         const player_t *state) {
+    if (state->occupied_fields == 1) {
+        g->players_with_fields++;
+        if (player > g->max_player_with_fields) {
+            g->max_player_with_fields = player;
+        }
+    }
+    if (state->occupied_fields > g->leader_busy_fields) {
+        g->leader_busy_fields = state->occupied_fields;
+        g->leaders = 1;
+        g->leader = player;
+    } else if (state->occupied_fields == g->leader_busy_fields) {
+        g->leaders++;
+    }
+}
+
+/** @brief Aktualizuje statystyki graczy po utracie pola przez gracza.
+ * Pola tracone są tylko w złotych ruchach, które i tak przeglądają całą planszę,
+ * więc statystyki, których nie da się poprawić w czasie stałym, wyznaczane są od
+ * nowa z listy graczy aktywnych.
+ * Złożoność O(1) lub O(active_players_num).
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player  – numer gracza,
+ * @param[in] state   – wskaźnik na dane gracza ze zmniejszoną liczbą pól.
+ */
+static void busy_fields_decreased(gamma_t *g, uint32_t player, const player_t *state) {
+    const bool lost_last_field = state->occupied_fields == 0;
+    const bool was_leader = state->occupied_fields + 1 == g->leader_busy_fields;
+    if (lost_last_field) {
+        g->players_with_fields--;
+    }
+    if (!was_leader && !(lost_last_field && player == g->max_player_with_fields)) {
+        return;
+    }
+
+    g->max_player_with_fields = 0;
+    g->leader_busy_fields = 0;
+    g->leaders = 0;
+    for (uint32_t i = 0; i < g->active_players_num; i++) {
+        const uint32_t p = g->active_players[i];
+        const uint64_t busy = active_player(g, i)->occupied_fields;
+        if (busy > 0 && p > g->max_player_with_fields) {
+            g->max_player_with_fields = p;
+        }
+        if (busy > g->leader_busy_fields) {
+            g->leader_busy_fields = busy;
+            g->leaders = 1;
+            g->leader = p;
+        } else if (busy == g->leader_busy_fields && busy > 0) {
+            g->leaders++;
+        }
+    }
+}
+
 bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
     if (g == NULL || player == 0 || player > g->players_num || x >= g->width ||
-        y >= g->height || !g->board[y][x].empty ||
+        y >= g->height || owner_at(g, x, y) != 0 ||
         would_exceed_areas_limit(g, player, x, y)) {
         return false;
     }
 
-    const uint32_t player_index = player % g->players_num;
+    player_t *state = activate_player(g, player);
+    if (state == NULL) {
+        return false;
+    }
     unsigned border_empty_fields_to_add = new_border_empty_fields(g, x, y, player);
 
-    g->board[y][x].player = player;
-    g->board[y][x].empty = false;
+    set_owner(g, x, y, player);
     g->occupied_fields++;
-    g->players[player_index].areas++;
-    g->players[player_index].occupied_fields++;
-    g->players[player_index].areas -= union_neighbors(g, x, y);
-    g->players[player_index].border_empty_fields += border_empty_fields_to_add;
+    state->areas++;
+    state->occupied_fields++;
+    state->areas -= union_neighbors(g, x, y);
+    state->border_empty_fields += border_empty_fields_to_add;
+    busy_fields_increased(g, player, state);
 
     decrement_neighbors_border_empty_fields(g, x, y);
+    update_pyramid(g, x, y);
 
     return true;
 }
@@ -369,16 +1114,15 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
  * @param[in,out] g       – wskaźnik na strukturę przechowującą stan gry.
  */
 static inline void reset_find_union_metadata(gamma_t *g) {
-    for (uint32_t row = 0; row < g->height; row++) {
-        for (uint32_t column = 0; column < g->width; column++) {
-            if (g->board[row][column].empty) {
-                continue;
-            }
-            g->board[row][column].parent = &g->board[row][column];
-            g->board[row][column].rank = 1;
-            uint32_t player_index = g->board[row][column].player % g->players_num;
-            g->players[player_index].areas++;
+    FOR_EACH_FIELD(g, column, row) {
+        const uint32_t player = owner_at(g, column, row);
+        if (player == 0) {
+            continue;
         }
+        field_t *field = field_at(g, column, row);
+        field->parent = field;
+        g->ranks[field - g->fields] = 1;
+        find_player(g, player)->areas++;
     }
 }
 
@@ -386,32 +1130,34 @@ static inline void reset_find_union_metadata(gamma_t *g) {
  * @brief Na nowo tworzy strukturę find-union obszarów.
  * Na nowo tworzy strukturę find-union obszarów i dla każdego gracza aktualizuje
  * liczbę posiadanych obszarów.
- * Złożoność O(height*width) + O(players_num)
+ * Złożoność O(height*width) + O(active_players_num)
  * @param[in,out] g       – wskaźnik na strukturę przechowującą stan gry.
  * @return Wartość @p true, jeżeli po zakończeniu każdy z graczy ma nie więcej niż
  * @p g->max_areas obszarów, @p false w przeciwnym przypadku.
  */
 static bool reindex_areas(gamma_t *g) {
-    for (uint32_t p = 0; p < g->players_num; p++) {
-        g->players[p].areas = 0;
+    // Oba przebiegi poniżej odwiedzają każde pole planszy.
+    GAMMA_STATS_ADD(g, reindex_calls, 1);
+    GAMMA_STATS_ADD(g, reindex_visited_fields, 2 * (uint64_t)g->width * g->height);
+    g->paths |= GAMMA_PATH_REINDEX;
+    for (uint32_t i = 0; i < g->active_players_num; i++) {
+        active_player(g, i)->areas = 0;
     }
 
     reset_find_union_metadata(g);
 
     // Utwórz na nowo sety find-union.
-    for (uint32_t row = 0; row < g->height; row++) {
-        for (uint32_t column = 0; column < g->width; column++) {
-            if (g->board[row][column].empty) {
-                continue;
-            }
-            uint32_t player_index = g->board[row][column].player % g->players_num;
-            unsigned merged_areas = union_neighbors(g, column, row);
-            g->players[player_index].areas -= merged_areas;
+    FOR_EACH_FIELD(g, column, row) {
+        const uint32_t player = owner_at(g, column, row);
+        if (player == 0) {
+            continue;
         }
+        unsigned merged_areas = union_neighbors(g, column, row);
+        find_player(g, player)->areas -= merged_areas;
     }
 
-    for (uint32_t p = 0; p < g->players_num; p++) {
-        if (g->players[p].areas > g->max_areas) {
+    for (uint32_t i = 0; i < g->active_players_num; i++) {
+        if (active_player(g, i)->areas > g->max_areas) {
             return false;
         }
     }
@@ -433,8 +1179,8 @@ static bool reindex_areas(gamma_t *g) {
 static inline bool is_golden_move_impossible(const gamma_t *g, uint32_t player,
                                              uint32_t x, uint32_t y) {
     return (g == NULL || player == 0 || player > g->players_num || x >= g->width ||
-            y >= g->height || g->board[y][x].empty || g->board[y][x].player == player ||
-            g->players[player % g->players_num].golden_move_done ||
+            y >= g->height || owner_at(g, x, y) == 0 || owner_at(g, x, y) == player ||
+            player_state(g, player)->golden_move_done ||
             would_exceed_areas_limit(g, player, x, y));
 }
 
@@ -443,28 +1189,36 @@ bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y) {
         return false;
     }
 
+    if (activate_player(g, player) == NULL) {
+        return false;
+    }
     unsigned border_empty_fields_to_add = new_border_empty_fields(g, x, y, player);
 
-    uint32_t previous_player = g->board[y][x].player;
-    uint32_t previous_player_index = previous_player % g->players_num;
+    uint32_t previous_player = owner_at(g, x, y);
 
-    g->board[y][x].player = player;
+    set_owner(g, x, y, player);
     bool areas_limit_not_exceeded = reindex_areas(g);
     if (!areas_limit_not_exceeded) {
-        g->board[y][x].player = previous_player;
+        GAMMA_STATS_ADD(g, golden_move_rollbacks, 1);
+        g->paths |= GAMMA_PATH_ROLLBACK;
+        set_owner(g, x, y, previous_player);
         reindex_areas(g);
         return false;
     }
 
-    const uint32_t player_index = player % g->players_num;
-    g->players[player_index].occupied_fields++;
-    g->players[player_index].border_empty_fields += border_empty_fields_to_add;
-    g->players[player_index].golden_move_done = true;
+    player_t *state = find_player(g, player);
+    state->occupied_fields++;
+    state->border_empty_fields += border_empty_fields_to_add;
+    state->golden_move_done = true;
+    busy_fields_increased(g, player, state);
 
     unsigned lost_border_empty_fields =
         new_border_empty_fields(g, x, y, previous_player);
-    g->players[previous_player_index].occupied_fields--;
-    g->players[previous_player_index].border_empty_fields -= lost_border_empty_fields;
+    player_t *previous_state = find_player(g, previous_player);
+    previous_state->occupied_fields--;
+    previous_state->border_empty_fields -= lost_border_empty_fields;
+    busy_fields_decreased(g, previous_player, previous_state);
+    update_pyramid(g, x, y);
 
     return true;
 }
@@ -474,7 +1228,7 @@ uint64_t gamma_busy_fields(gamma_t *g, uint32_t player) {
         return 0;
     }
 
-    return g->players[player % g->players_num].occupied_fields;
+    return player_state(g, player)->occupied_fields;
 }
 
 uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
@@ -482,13 +1236,13 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
         return 0;
     }
 
-    const uint32_t player_index = player % g->players_num;
-    if (g->players[player_index].areas < g->max_areas) {
+    const player_t *state = player_state(g, player);
+    if (state->areas < g->max_areas) {
         uint64_t total_fields = g->width * g->height;
         return total_fields - g->occupied_fields;
     }
 
-    return g->players[player_index].border_empty_fields;
+    return state->border_empty_fields;
 }
 
 /**
@@ -503,22 +1257,21 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player) {
  * ruch, w przeciwnym przypadku @p false.
  */
 static bool can_attack_any_field_without_increasing_areas(gamma_t *g, uint32_t player) {
-    for (uint32_t row = 0; row < g->height; row++) {
-        for (uint32_t column = 0; column < g->width; column++) {
-            field_t *field = &g->board[row][column];
-            if (field->empty || field->player == player ||
-                !has_neighbor(g, column, row, player)) {
-                continue;
-            }
+    g->paths |= GAMMA_PATH_ATTACK_SCAN;
+    FOR_EACH_FIELD(g, column, row) {
+        const uint32_t previous_player = owner_at(g, column, row);
+        if (previous_player == 0 || previous_player == player ||
+            !has_neighbor(g, column, row, player)) {
+            continue;
+        }
 
-            const uint32_t previous_player = field->player;
-            field->player = player;
-            bool areas_limit_not_exceeded = reindex_areas(g);
-            field->player = previous_player;
-            reindex_areas(g);
-            if (areas_limit_not_exceeded) {
-                return true;
-            }
+        GAMMA_STATS_ADD(g, golden_possible_candidates, 1);
+        set_owner(g, column, row, player);
+        bool areas_limit_not_exceeded = reindex_areas(g);
+        set_owner(g, column, row, previous_player);
+        reindex_areas(g);
+        if (areas_limit_not_exceeded) {
+            return true;
         }
     }
 
@@ -530,29 +1283,237 @@ bool gamma_golden_possible(gamma_t *g, uint32_t player) {
         return false;
     }
 
-    const uint32_t player_index = player % g->players_num;
-    if (g->players[player_index].golden_move_done) {
+    const player_t *state = player_state(g, player);
+    if (state->golden_move_done) {
         return false;
     }
 
-    bool other_players_have_no_fields = true;
-    for (uint32_t p = 0; p < g->players_num; p++) {
-        if (g->players[p].occupied_fields > 0 && p != player_index) {
-            other_players_have_no_fields = false;
-            break;
-        }
-    }
-    if (other_players_have_no_fields) {
+    const uint32_t other_players_with_fields =
+        g->players_with_fields - (state->occupied_fields > 0);
+    if (other_players_with_fields == 0) {
         return false;
     }
 
-    if (g->players[player_index].areas < g->max_areas) {
+    if (state->areas < g->max_areas) {
         return true;
     }
 
     return can_attack_any_field_without_increasing_areas(g, player);
 }
 
+/** Liczba bitów licznika sąsiadów w stanie pola przeszukiwania wgłąb. */
+#define NEXT_NEIGHBOR_BITS 3u
+/** Maska licznika sąsiadów w stanie pola przeszukiwania wgłąb. */
+#define NEXT_NEIGHBOR_MASK ((1u << NEXT_NEIGHBOR_BITS) - 1)
+/** Numer oznaczający brak sąsiada pola. */
+#define NO_NEIGHBOR UINT32_MAX
+
+/**
+ * Struktura przechowująca stan przeszukiwania wgłąb obszarów planszy, wyznaczającego
+ * pola, których zabranie dzieli obszar. Tablice indeksowane są numerem pola
+ * w kolejności wierszami; numery pól mieszczą się w 32 bitach.
+ */
+typedef struct split_search {
+    uint32_t *order;  /**< Numery pól w kolejności odwiedzenia, od 1; 0 dla pól
+                       * nieodwiedzonych. */
+    uint32_t *low;    /**< Najmniejszy numer pola osiągalny z poddrzewa pola
+                       * krawędzią powrotną. */
+    uint32_t *stack;  /**< Stos odwiedzanych pól. */
+    uint8_t *progress; /**< Numer następnego sąsiada do sprawdzenia (młodsze bity)
+                        * i liczba poddrzew odcinanych po zabraniu pola. */
+} split_search_t;
+
+/** @brief Zapisuje numery pól sąsiadujących z polem.
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] position    – numer pola w kolejności wierszami,
+ * @param[out] neighbors  – tablica numerów czterech sąsiadów; @ref NO_NEIGHBOR
+ *                          oznacza brak sąsiada.
+ */
+static void neighbor_positions(const gamma_t *g, uint32_t position,
+                               uint32_t neighbors[4]) {
+    const uint32_t x = position % g->width, y = position / g->width;
+    neighbors[0] = x + 1 < g->width ? position + 1 : NO_NEIGHBOR;
+    neighbors[1] = x > 0 ? position - 1 : NO_NEIGHBOR;
+    neighbors[2] = y + 1 < g->height ? position + g->width : NO_NEIGHBOR;
+    neighbors[3] = y > 0 ? position - g->width : NO_NEIGHBOR;
+}
+
+/** @brief Zwraca numer gracza zajmującego pole o numerze w kolejności wierszami.
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] position    – numer pola.
+ * @return Numer gracza lub 0, jeżeli pole jest puste.
+ */
+static inline uint32_t owner_of_position(const gamma_t *g, uint32_t position) {
+    return owner_at(g, position % g->width, position / g->width);
+}
+
+/** @brief Zaznacza graczy, którzy mogą wykonać złoty ruch na pole.
+ * Jeżeli właściciel pola nie przekroczy limitu obszarów po jego utracie, zaznacza
+ * każdego sąsiadującego z polem innego gracza, który ma limit obszarów wyczerpany
+ * i nie wykonał jeszcze złotego ruchu. Taki gracz nie zwiększy liczby swoich
+ * obszarów, ponieważ pole sąsiaduje z jego obszarem.
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] position    – numer pola w kolejności wierszami,
+ * @param[in] parts       – liczba części, na które podzieli się obszar pola po jego
+ *                          zabraniu,
+ * @param[in,out] out     – tablica wyników graczy.
+ */
+static void mark_attackers(const gamma_t *g, uint32_t position, unsigned parts,
+                           bool *out) {
+    const uint32_t owner = owner_of_position(g, position);
+    if (find_player(g, owner)->areas - 1 + parts > g->max_areas) {
+        return;
+    }
+    uint32_t neighbors[4];
+    neighbor_positions(g, position, neighbors);
+    for (unsigned i = 0; i < 4; i++) {
+        if (neighbors[i] == NO_NEIGHBOR) {
+            continue;
+        }
+        const uint32_t attacker = owner_of_position(g, neighbors[i]);
+        if (attacker == 0 || attacker == owner) {
+            continue;
+        }
+        const player_t *state = find_player(g, attacker);
+        if (!state->golden_move_done && state->areas == g->max_areas) {
+            out[attacker - 1] = true;
+        }
+    }
+}
+
+/** @brief Przeszukuje wgłąb obszar zawierający zadane pole.
+ * Algorytmem Tarjana wyznacza dla każdego pola obszaru liczbę części, na które
+ * obszar podzieli się po zabraniu pola, i przekazuje ją do @ref mark_attackers.
+ * Złożoność O(rozmiar obszaru).
+ * @param[in] g           – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in,out] search  – wskaźnik na stan przeszukiwania,
+ * @param[in,out] visited – wskaźnik na liczbę odwiedzonych dotąd pól,
+ * @param[in] root        – numer pierwszego pola obszaru w kolejności wierszami,
+ * @param[in,out] out     – tablica wyników graczy.
+ */
+static void search_area(const gamma_t *g, split_search_t *search, uint32_t *visited,
+                        uint32_t root, bool *out) {
+    const uint32_t owner = owner_of_position(g, root);
+    uint32_t stack_size = 0;
+    search->stack[stack_size++] = root;
+    search->order[root] = search->low[root] = ++*visited;
+
+    while (stack_size > 0) {
+        const uint32_t v = search->stack[stack_size - 1];
+        const unsigned next = search->progress[v] & NEXT_NEIGHBOR_MASK;
+        if (next < 4) {
+            search->progress[v]++;
+            uint32_t neighbors[4];
+            neighbor_positions(g, v, neighbors);
+            const uint32_t n = neighbors[next];
+            if (n == NO_NEIGHBOR || owner_of_position(g, n) != owner) {
+                continue;
+            }
+            if (search->order[n] == 0) {
+                search->order[n] = search->low[n] = ++*visited;
+                search->stack[stack_size++] = n;
+            } else if (search->order[n] < search->low[v]) {
+                search->low[v] = search->order[n];
+            }
+            continue;
+        }
+
+        stack_size--;
+        // Poddrzewa odcinane po zabraniu pola tworzą osobne części, a reszta obszaru
+        // - o ile pole nie jest korzeniem - jeszcze jedną.
+        const unsigned cut_subtrees = search->progress[v] >> NEXT_NEIGHBOR_BITS;
+        mark_attackers(g, v, cut_subtrees + (v != root), out);
+        if (stack_size > 0) {
+            const uint32_t parent = search->stack[stack_size - 1];
+            if (search->low[v] < search->low[parent]) {
+                search->low[parent] = search->low[v];
+            }
+            if (search->low[v] >= search->order[parent]) {
+                search->progress[parent] += 1u << NEXT_NEIGHBOR_BITS;
+            }
+        }
+    }
+}
+
+/** @brief Zaznacza graczy z wyczerpanym limitem obszarów, którzy mogą wykonać złoty
+ * ruch.
+ * Tablice przeszukiwania alokowane są przy pierwszym wywołaniu i pozostają w grze
+ * jako pamięć podręczna, wliczana przez @ref gamma_memory_usage. Na planszy
+ * o więcej niż @p UINT32_MAX polach, której numery pól nie mieszczą się w tablicach,
+ * gracze sprawdzani są pojedynczo funkcją
+ * @ref can_attack_any_field_without_increasing_areas.
+ * Złożoność O(height*width).
+ * @param[in,out] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in,out] out     – tablica wyników graczy.
+ * @return Wartość @p true, jeżeli udało się zaalokować pamięć, @p false
+ * w przeciwnym przypadku.
+ */
+static bool mark_attackers_at_limit(gamma_t *g, bool *out) {
+    const uint64_t fields = (uint64_t)g->width * g->height;
+    if (fields > UINT32_MAX) {
+        for (uint32_t i = 0; i < g->active_players_num; i++) {
+            const uint32_t player = g->active_players[i];
+            const player_t *state = active_player(g, i);
+            if (!state->golden_move_done && state->areas == g->max_areas &&
+                g->players_with_fields - (state->occupied_fields > 0) > 0) {
+                out[player - 1] =
+                    can_attack_any_field_without_increasing_areas(g, player);
+            }
+        }
+        return true;
+    }
+
+    const gamma_allocator_t *allocator = &g->allocator;
+    if (g->split_search == NULL) {
+        if (split_search_bytes(g) >= SIZE_MAX ||
+            !cache_fits_memory_limit(g, split_search_bytes(g))) {
+            errno = ENOMEM;
+            return false;
+        }
+        g->split_search = allocator->alloc(allocator->context,
+                                           (size_t)split_search_bytes(g));
+        if (g->split_search == NULL) {
+            errno = ENOMEM;
+            return false;
+        }
+    }
+    split_search_t search = {g->split_search, g->split_search + fields,
+                             g->split_search + 2 * fields,
+                             (uint8_t *)(g->split_search + 3 * fields)};
+    memset(search.order, 0, fields * sizeof(uint32_t));
+    memset(search.progress, 0, fields);
+
+    g->paths |= GAMMA_PATH_ATTACK_SCAN;
+    uint32_t visited = 0;
+    for (uint32_t position = 0; position < fields; position++) {
+        if (search.order[position] == 0 && owner_of_position(g, position) != 0) {
+            search_area(g, &search, &visited, position, out);
+        }
+    }
+    return true;
+}
+
+bool gamma_golden_possible_all(gamma_t *g, bool *out) {
+    if (g == NULL || out == NULL || g->player_slots != NULL) {
+        return false;
+    }
+
+    // Gracz bez ruchów ma mniej obszarów niż limit, więc może zająć pole dowolnego
+    // innego gracza.
+    memset(out, g->players_with_fields > 0, g->players_num * sizeof(bool));
+    bool any_at_limit = false;
+    for (uint32_t i = 0; i < g->active_players_num; i++) {
+        const player_t *state = active_player(g, i);
+        const bool can_attack =
+            !state->golden_move_done &&
+            g->players_with_fields - (state->occupied_fields > 0) > 0;
+        out[g->active_players[i] - 1] = can_attack && state->areas < g->max_areas;
+        any_at_limit |= can_attack && state->areas == g->max_areas;
+    }
+
+    return !any_at_limit || mark_attackers_at_limit(g, out);
+}
+
 /**
  * @brief Zwraca liczbę cyfr zadanej liczby nieujemnej.
  * @param[in] value   - liczba nieujemna.
@@ -570,15 +1531,16 @@ static unsigned get_uint_length(uint64_t value) {
 io_error_t gamma_render_field(const gamma_t *g, char *str, uint32_t x, uint32_t y,
                               uint32_t field_width, int *written_characters,
                               uint32_t *player_number) {
-    if (g->board[y][x].empty) {
+    const uint32_t owner = owner_at(g, x, y);
+    if (owner == 0) {
         *written_characters = sprintf(str, "%*c", field_width, '.');
         if (player_number != NULL) {
             *player_number = 0;
         }
     } else {
-        *written_characters = sprintf(str, "%*u", field_width, g->board[y][x].player);
+        *written_characters = sprintf(str, "%*u", field_width, owner);
         if (player_number != NULL) {
-            *player_number = g->board[y][x].player;
+            *player_number = owner;
         }
     }
     if (*written_characters < 0) {
@@ -587,23 +1549,11 @@ io_error_t gamma_render_field(const gamma_t *g, char *str, uint32_t x, uint32_t
     return NO_ERROR;
 }
 
-/**
- * @brief Zwraca informacje o szerokościach pól podczas wypisywania planszy.
- * Wskaźnik @p g musi wskazywać na prawidłowo zainicjowaną strukturę gry.
- * @param[in] g                    - wskaźnik na strukturę przechowującą stan gry,
- * @param[out] first_column_width  - wskaźnik na komórkę, do której zapisana zostanie
- *                                   szerokość pola z pierwszej kolumny,
- * @param[out] field_width         - wskaźnik na komórkę, do której zapisana zostanie
- *                                   szerokość pola z kolumn innych niż pierwsza.
- */
 void gamma_rendered_fields_width(const gamma_t *g, unsigned *first_column_width,
                                  unsigned *field_width) {
-    uint32_t max_player = 1; // Najmniejszy numer gracza to 1.
-    for (uint32_t p = 0; p++ < g->players_num;) {
-        if (g->players[p % g->players_num].occupied_fields > 0 && p > max_player) {
-            max_player = p;
-        }
-    }
+    // Najmniejszy numer gracza to 1.
+    const uint32_t max_player =
+        g->max_player_with_fields > 1 ? g->max_player_with_fields : 1;
     unsigned min_width = get_uint_length(max_player);
     // Jeżeli min_width > 1, to dodajemy jeden dodatkowy znak paddingu, aby "najdłuższy"
     // gracz nie sklejał się z poprzednim.
@@ -611,8 +1561,9 @@ void gamma_rendered_fields_width(const gamma_t *g, unsigned *first_column_width,
 
     uint32_t max_player_first_column = 1;
     for (uint32_t r = 0; r < g->height; r++) {
-        if (!g->board[r][0].empty && g->board[r][0].player > max_player_first_column) {
-            max_player_first_column = g->board[r][0].player;
+        const uint32_t owner = owner_at(g, 0, r);
+        if (owner > max_player_first_column) {
+            max_player_first_column = owner;
         }
     }
     *first_column_width = get_uint_length(max_player_first_column);
@@ -635,12 +1586,21 @@ char *gamma_board(gamma_t *g) {
             if ((allocated_space - pos) < min_buffer_size) {
                 uint64_t left_fields = total_fields - written_fields;
                 uint64_t extra_chars = left_fields * min_width + y + min_buffer_size;
+                const uint64_t old_space = allocated_space;
                 allocated_space += extra_chars * sizeof(char);
-                if ((str = realloc(str, allocated_space)) == NULL) {
+                void *context = g->allocator.context;
+                char *resized = str == NULL
+                                    ? g->allocator.alloc(context, allocated_space)
+                                    : g->allocator.realloc(context, str, old_space,
+                                                           allocated_space);
+                if (resized == NULL) {
                     errno = ENOMEM;
-                    free(str);
+                    if (str != NULL) {
+                        g->allocator.free(g->allocator.context, str, old_space);
+                    }
                     return NULL;
                 }
+                str = resized;
             }
 
             unsigned field_width = x == 0 ? min_first_column_width : min_width;
@@ -652,18 +1612,138 @@ char *gamma_board(gamma_t *g) {
     }
 
     str[pos] = '\0';
+    // Napis jest przycinany do długości, aby gamma_board_free mogło wyznaczyć jego
+    // rozmiar.
+    if (pos + 1 < allocated_space) {
+        char *trimmed =
+            g->allocator.realloc(g->allocator.context, str, allocated_space, pos + 1);
+        if (trimmed == NULL) {
+            errno = ENOMEM;
+            g->allocator.free(g->allocator.context, str, allocated_space);
+            return NULL;
+        }
+        str = trimmed;
+    }
     return str;
 }
 
+void gamma_board_free(const gamma_t *g, char *board) {
+    if (board == NULL) {
+        return;
+    }
+    g->allocator.free(g->allocator.context, board, strlen(board) + 1);
+}
+
+bool gamma_stats(const gamma_t *g, gamma_stats_t *stats) {
+    if (g == NULL || stats == NULL) {
+        return false;
+    }
+#ifdef GAMMA_STATS
+    *stats = g->stats;
+    return true;
+#else
+    memset(stats, 0, sizeof(gamma_stats_t));
+    return false;
+#endif
+}
+
+bool gamma_minimap_block_size(gamma_t *g, uint32_t max_columns, uint32_t max_rows,
+                              uint32_t *block_size) {
+    if (g == NULL || max_columns == 0 || max_rows == 0) {
+        return false;
+    }
+
+    if (g->pyramid == NULL) {
+        if (!cache_fits_memory_limit(
+                g, ownership_pyramid_estimate_memory(g->width, g->height))) {
+            return false;
+        }
+        g->pyramid = ownership_pyramid_new(g->width, g->height, &g->allocator);
+        if (g->pyramid == NULL) {
+            errno = ENOMEM;
+            return false;
+        }
+        for (uint32_t row = 0; row < ownership_pyramid_rows(g->pyramid, 1); row++) {
+            for (uint32_t column = 0; column < ownership_pyramid_columns(g->pyramid, 1);
+                 column++) {
+                set_pyramid_block(g, column, row);
+            }
+        }
+        ownership_pyramid_rebuild(g->pyramid);
+    }
+
+    // Pojedyncze pola nie są przechowywane w piramidzie.
+    if (g->width <= max_columns && g->height <= max_rows) {
+        *block_size = 1;
+    } else {
+        *block_size = 1u << ownership_pyramid_fitting_level(g->pyramid, max_columns,
+                                                            max_rows);
+    }
+    return true;
+}
+
+void gamma_minimap_block(const gamma_t *g, uint32_t block_size, uint32_t column,
+                         uint32_t row, gamma_block_summary_t *block) {
+    const uint64_t first_x = (uint64_t)column * block_size;
+    const uint64_t first_y = (uint64_t)row * block_size;
+    const uint64_t width = g->width - first_x < block_size ? g->width - first_x
+                                                           : block_size;
+    const uint64_t height = g->height - first_y < block_size ? g->height - first_y
+                                                             : block_size;
+    block->fields = width * height;
+
+    if (block_size == 1) {
+        block->owner = owner_at(g, column, row);
+        block->occupied = block->owner != 0;
+        return;
+    }
+
+    unsigned level = 0;
+    while ((1u << level) < block_size) {
+        level++;
+    }
+    const pyramid_node_t *node = ownership_pyramid_node(g->pyramid, level, column, row);
+    block->owner = node->owner;
+    block->occupied = node->occupied;
+}
+
 bool gamma_game_new_arguments_valid(uint32_t width, uint32_t height, uint32_t players,
                                     uint32_t areas) {
     return !(width == 0 || height == 0 || players == 0 || areas == 0);
 }
 
+uint32_t gamma_player_areas(const gamma_t *g, uint32_t player) {
+    if (g == NULL || player == 0 || player > g->players_num) {
+        return 0;
+    }
+    return player_state(g, player)->areas;
+}
+
+unsigned gamma_take_paths(gamma_t *g) {
+    if (g == NULL) {
+        return 0;
+    }
+    const unsigned paths = g->paths;
+    g->paths = 0;
+    return paths;
+}
+
 uint32_t gamma_players_number(const gamma_t *g) {
     return g == NULL ? 0 : g->players_num;
 }
 
+uint32_t gamma_active_players_number(const gamma_t *g) {
+    return g == NULL ? 0 : g->active_players_num;
+}
+
+uint32_t gamma_active_player(const gamma_t *g, uint32_t index) {
+    return g == NULL || index >= g->active_players_num ? 0 : g->active_players[index];
+}
+
+uint32_t gamma_max_areas(const gamma_t *g) {
+    return g == NULL ? 0 : g->max_areas;
+}
+
 uint32_t gamma_board_width(const gamma_t *g) {
     return g == NULL ? 0 : g->width;
 }
@@ -671,3 +1751,25 @@ uint32_t gamma_board_width(const gamma_t *g) {
 uint32_t gamma_board_height(const gamma_t *g) {
     return g == NULL ? 0 : g->height;
 }
+
+uint32_t gamma_players_with_fields(const gamma_t *g) {
+    return g == NULL ? 0 : g->players_with_fields;
+}
+
+uint32_t gamma_max_player_with_fields(const gamma_t *g) {
+    return g == NULL ? 0 : g->max_player_with_fields;
+}
+
+uint32_t gamma_leader(const gamma_t *g, uint64_t *busy_fields) {
+    if (g == NULL) {
+        return 0;
+    }
+    if (busy_fields != NULL) {
+        *busy_fields = g->leader_busy_fields;
+    }
+    // Bez zajętych pól remisują wszyscy gracze.
+    if (g->leader_busy_fields == 0) {
+        return g->players_num == 1 ? 1 : 0;
+    }
+    return g->leaders == 1 ? g->leader : 0;
+}
@@ -12,13 +12,93 @@
 
 #include "errors.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+/** Największa liczba graczy, dla której tablica graczy alokowana jest w całości
+ * przy tworzeniu gry. Przy większej liczbie graczy dane gracza tworzone są przy jego
+ * pierwszym ruchu, a funkcja @ref gamma_golden_possible_all nie jest dostępna. */
+#define GAMMA_DENSE_PLAYERS_LIMIT UINT16_MAX
+
 /**
  * Struktura przechowująca stan gry.
  */
 typedef struct gamma gamma_t;
 
+/**
+ * Struktura opisująca kwadratowy blok planszy wyświetlany jako jedno pole minimapy.
+ */
+typedef struct gamma_block_summary {
+    uint32_t owner;    /**< Przybliżony dominujący gracz w bloku lub 0, jeżeli
+                        * w bloku nie ma zajętych pól. */
+    uint64_t occupied; /**< Liczba zajętych pól w bloku. */
+    uint64_t fields;   /**< Liczba pól bloku należących do planszy. */
+} gamma_block_summary_t;
+
+/**
+ * Struktura przechowująca liczniki operacji wewnętrznych silnika.
+ * Liczniki są zbierane tylko w programie skompilowanym z makrem @p GAMMA_STATS.
+ */
+typedef struct gamma_stats {
+    uint64_t find_calls;          /**< Liczba wywołań operacji find. */
+    uint64_t find_path_length;    /**< Łączna długość ścieżek przebytych przez
+                                   * operację find. */
+    uint64_t union_merges;        /**< Liczba operacji union łączących dwa obszary. */
+    uint64_t reindex_calls;       /**< Liczba przebudowań struktury find-union. */
+    uint64_t reindex_visited_fields; /**< Łączna liczba pól odwiedzonych podczas
+                                      * przebudowań struktury find-union. */
+    uint64_t golden_move_rollbacks;  /**< Liczba złotych ruchów wycofanych, ponieważ
+                                      * przekraczały limit obszarów. */
+    uint64_t golden_possible_candidates; /**< Liczba pól sprawdzonych przez
+                                          * @ref gamma_golden_possible jako cel
+                                          * złotego ruchu. */
+} gamma_stats_t;
+
+/**
+ * Enum opisujący kosztowne ścieżki wykonania funkcji silnika. Wartości są
+ * flagami bitowymi zwracanymi przez @ref gamma_take_paths.
+ */
+typedef enum gamma_path {
+    GAMMA_PATH_REINDEX = 1u << 0,     /**< Przebudowanie struktury find-union
+                                       * całej planszy. */
+    GAMMA_PATH_ROLLBACK = 1u << 1,    /**< Wycofanie złotego ruchu przekraczającego
+                                       * limit obszarów. */
+    GAMMA_PATH_ATTACK_SCAN = 1u << 2, /**< Przeszukanie planszy w poszukiwaniu
+                                       * celu złotego ruchu. */
+} gamma_path_t;
+
+/**
+ * Struktura opisująca pamięć zajmowaną przez grę, w bajtach.
+ */
+typedef struct gamma_memory {
+    uint64_t board;      /**< Numery graczy zajmujących pola planszy (wraz
+                          * z polami uzupełnienia kafelków). */
+    uint64_t union_find; /**< Metadane find-union pól (rodzic i ranga). */
+    uint64_t players;    /**< Tablice danych graczy i struktura gry; przy
+                          * liczbie graczy większej niż
+                          * @ref GAMMA_DENSE_PLAYERS_LIMIT rosną wraz z liczbą
+                          * graczy, którzy wykonali ruch. */
+    uint64_t caches;     /**< Struktury tworzone na żądanie (piramida zajętości
+                          * minimapy i tablice przeszukiwania
+                          * @ref gamma_golden_possible_all). */
+    uint64_t total;      /**< Suma powyższych. */
+} gamma_memory_t;
+
+/**
+ * Struktura opisująca alokator pamięci gry.
+ * Wszystkie funkcje otrzymują wskaźnik @p context. Funkcje @p free i @p realloc
+ * otrzymują rozmiar zwalnianego bloku, więc alokator nie musi go zapamiętywać.
+ */
+typedef struct gamma_allocator {
+    void *(*alloc)(void *context, size_t size); /**< Alokuje blok pamięci lub
+                                                 * zwraca NULL. */
+    void *(*realloc)(void *context, void *ptr, size_t old_size,
+                     size_t new_size); /**< Zmienia rozmiar niepustego bloku lub
+                                        * zwraca NULL, pozostawiając blok. */
+    void (*free)(void *context, void *ptr, size_t size); /**< Zwalnia blok. */
+    void *context; /**< Dane alokatora przekazywane do jego funkcji. */
+} gamma_allocator_t;
+
 /** @brief Tworzy strukturę przechowującą stan gry.
  * Alokuje pamięć na nową strukturę przechowującą stan gry.
  * Inicjuje tę strukturę tak, aby reprezentowała początkowy stan gry.
@@ -32,6 +112,55 @@ typedef struct gamma gamma_t;
  */
 gamma_t *gamma_new(uint32_t width, uint32_t height, uint32_t players, uint32_t areas);
 
+/** @brief Tworzy strukturę przechowującą stan gry, korzystając z alokatora.
+ * Działa jak @ref gamma_new, ale całą pamięć gry - strukturę gry, planszę,
+ * tablicę graczy, piramidę zajętości minimapy i napisy z @ref gamma_board -
+ * alokuje i zwalnia zadanym alokatorem. Dzięki temu grę można umieścić np.
+ * w arenie zwalnianej w całości.
+ * @param[in] width     – szerokość planszy, liczba dodatnia,
+ * @param[in] height    – wysokość planszy, liczba dodatnia,
+ * @param[in] players   – liczba graczy, liczba dodatnia,
+ * @param[in] areas     – maksymalna liczba obszarów,
+ *                        jakie może zająć jeden gracz, liczba dodatnia,
+ * @param[in] allocator – wskaźnik na alokator, kopiowany do struktury gry, lub
+ *                        NULL dla funkcji malloc, realloc i free.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+gamma_t *gamma_new_ex(uint32_t width, uint32_t height, uint32_t players,
+                      uint32_t areas, const gamma_allocator_t *allocator);
+
+/** @brief Szacuje pamięć, którą zaalokuje @ref gamma_new.
+ * Pozwala odrzucić zbyt dużą grę przed próbą jej utworzenia. Wynik nie obejmuje
+ * narzutu alokatora ani struktur tworzonych na żądanie.
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy,
+ * @param[in] players – liczba graczy,
+ * @param[in] areas   – maksymalna liczba obszarów jednego gracza.
+ * @return Liczba bajtów, zero, jeżeli któryś z parametrów jest niepoprawny, lub
+ * @p UINT64_MAX, jeżeli liczba bajtów nie mieści się w 64 bitach.
+ */
+uint64_t gamma_estimate_memory(uint32_t width, uint32_t height, uint32_t players,
+                               uint32_t areas);
+
+/** @brief Podaje pamięć zajmowaną przez grę.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] usage  – wskaźnik na strukturę, do której zapisane zostaną wyniki.
+ * @return Wartość @p true, jeżeli wyniki zostały zapisane, @p false jeżeli
+ * wskaźnik @p g ma wartość NULL.
+ */
+bool gamma_memory_usage(const gamma_t *g, gamma_memory_t *usage);
+
+/** @brief Ogranicza pamięć gry.
+ * Struktury tworzone na żądanie (pole @p caches struktury @ref gamma_memory_t)
+ * nie są tworzone, jeżeli łączna pamięć gry przekroczyłaby limit; funkcje, które
+ * ich wymagają (@ref gamma_golden_possible_all, @ref gamma_minimap_block_size),
+ * zwracają wtedy błąd. Nic nie robi, jeżeli @p g ma wartość NULL.
+ * @param[in,out] g    – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] limit    – limit w bajtach lub 0, aby zdjąć limit.
+ */
+void gamma_set_memory_limit(gamma_t *g, uint64_t limit);
+
 /** @brief Usuwa strukturę przechowującą stan gry.
  * Usuwa z pamięci strukturę wskazywaną przez @p g.
  * Nic nie robi, jeśli wskaźnik ten ma wartość NULL.
@@ -104,6 +233,27 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player);
  */
 bool gamma_golden_possible(gamma_t *g, uint32_t player);
 
+/** @brief Sprawdza dla wszystkich graczy, czy mogą wykonać złoty ruch.
+ * Wyznacza wyniki @ref gamma_golden_possible wszystkich graczy jednym przejściem
+ * planszy: dla każdego zajętego pola sprawdza, na ile części podzieli się jego
+ * obszar po zabraniu pola, i na tej podstawie, czy gracz może je utracić.
+ * Złożoność O(height*width + players). Pamięć pomocnicza - 13 bajtów na pole - jest
+ * alokowana przy pierwszym przeszukaniu planszy i pozostaje w grze jako pamięć
+ * podręczna wliczana przez @ref gamma_memory_usage i ograniczana przez
+ * @ref gamma_set_memory_limit. Funkcja wymaga tablicy
+ * wyników wszystkich graczy, więc nie obsługuje gier o liczbie graczy większej niż
+ * @ref GAMMA_DENSE_PLAYERS_LIMIT.
+ * @param[in,out] g   – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] out    – wskaźnik na tablicę o @ref gamma_players_number elementach,
+ *                      do której pod indeksem @p player - 1 zapisany zostanie
+ *                      wynik gracza @p player.
+ * @return Wartość @p true, jeżeli wyniki zostały zapisane, @p false, jeżeli któryś
+ * z parametrów jest niepoprawny, graczy jest więcej niż
+ * @ref GAMMA_DENSE_PLAYERS_LIMIT lub nie udało się zaalokować pamięci albo
+ * przekroczyłaby ona limit pamięci gry.
+ */
+bool gamma_golden_possible_all(gamma_t *g, bool *out);
+
 /** @brief Daje napis opisujący stan planszy.
  * Alokuje w pamięci bufor, w którym umieszcza napis zawierający tekstowy
  * opis aktualnego stanu planszy.
@@ -114,6 +264,13 @@ bool gamma_golden_possible(gamma_t *g, uint32_t player);
  */
 char *gamma_board(gamma_t *g);
 
+/** @brief Zwalnia napis zwrócony przez @ref gamma_board.
+ * Napis gry utworzonej przez @ref gamma_new można zwolnić także funkcją free.
+ * @param[in] g       – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] board   – napis zwrócony przez @ref gamma_board dla tej gry lub NULL.
+ */
+void gamma_board_free(const gamma_t *g, char *board);
+
 /** @brief Weryfikuje parametry funkcji gamma_new.
  * @param[in] width   – szerokość planszy, liczba dodatnia,
  * @param[in] height  – wysokość planszy, liczba dodatnia,
@@ -126,12 +283,84 @@ char *gamma_board(gamma_t *g);
 bool gamma_game_new_arguments_valid(uint32_t width, uint32_t height, uint32_t players,
                                     uint32_t areas);
 
+/** @brief Zwraca liczbę obszarów zajmowanych przez gracza.
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] player   – numer gracza, liczba dodatnia niewiększa od wartości
+ *                       @p players z funkcji @ref gamma_new.
+ * @return Liczba rozłącznych obszarów gracza lub zero, jeżeli któryś z parametrów
+ * jest niepoprawny.
+ */
+uint32_t gamma_player_areas(const gamma_t *g, uint32_t player);
+
+/** @brief Zwraca i zeruje zbiór kosztownych ścieżek wykonania.
+ * Silnik zaznacza ścieżki z @ref gamma_path_t, gdy tylko zostaną wykonane;
+ * zaznaczenie nie spowalnia zwykłych ruchów.
+ * @param[in,out] g    – wskaźnik na strukturę przechowującą stan gry.
+ * @return Suma bitowa flag @ref gamma_path_t ścieżek wykonanych od poprzedniego
+ * wywołania lub od utworzenia gry.
+ */
+unsigned gamma_take_paths(gamma_t *g);
+
 /** @brief Zwraca liczbę graczy.
  * @param[in] g        – wskaźnik na strukturę przechowującą stan gry.
  * @return liczba graczy.
  */
 uint32_t gamma_players_number(const gamma_t *g);
 
+/** @brief Zwraca liczbę graczy aktywnych.
+ * Graczem aktywnym jest gracz, dla którego silnik utworzył dane, czyli który
+ * zajął pole lub próbował wykonać złoty ruch. Pozostali gracze nie zajmują pól
+ * i nie wykonali złotego ruchu, więc w grach o liczbie graczy większej niż
+ * @ref GAMMA_DENSE_PLAYERS_LIMIT wystarczy przeglądać graczy aktywnych.
+ * Złożoność O(1).
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry.
+ * @return Liczba graczy aktywnych lub zero, jeżeli @p g ma wartość NULL.
+ */
+uint32_t gamma_active_players_number(const gamma_t *g);
+
+/** @brief Zwraca numer gracza aktywnego.
+ * Gracze aktywni uporządkowani są w kolejności pierwszego ruchu.
+ * Złożoność O(1).
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] index    – indeks gracza, mniejszy niż
+ *                       @ref gamma_active_players_number.
+ * @return Numer gracza lub zero, jeżeli @p g ma wartość NULL lub indeks jest
+ * niepoprawny.
+ */
+uint32_t gamma_active_player(const gamma_t *g, uint32_t index);
+
+/** @brief Zwraca liczbę graczy zajmujących co najmniej jedno pole.
+ * Złożoność O(1).
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry.
+ * @return Liczba graczy lub zero, jeżeli @p g ma wartość NULL.
+ */
+uint32_t gamma_players_with_fields(const gamma_t *g);
+
+/** @brief Zwraca największy numer gracza zajmującego co najmniej jedno pole.
+ * Złożoność O(1).
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry.
+ * @return Numer gracza lub zero, jeżeli żaden gracz nie zajmuje pola lub @p g ma
+ * wartość NULL.
+ */
+uint32_t gamma_max_player_with_fields(const gamma_t *g);
+
+/** @brief Zwraca gracza zajmującego najwięcej pól.
+ * Złożoność O(1).
+ * @param[in] g            – wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] busy_fields – wskaźnik na komórkę, do której zapisana zostanie
+ *                           największa liczba pól zajętych przez jednego gracza,
+ *                           lub NULL.
+ * @return Numer jedynego gracza zajmującego najwięcej pól lub zero, jeżeli takich
+ * graczy jest kilku (remis) lub @p g ma wartość NULL.
+ */
+uint32_t gamma_leader(const gamma_t *g, uint64_t *busy_fields);
+
+/** @brief Zwraca maksymalną liczbę obszarów jednego gracza.
+ * @param[in] g        – wskaźnik na strukturę przechowującą stan gry.
+ * @return maksymalna liczba obszarów.
+ */
+uint32_t gamma_max_areas(const gamma_t *g);
+
 /** @brief Zwraca szerokość planszy.
  * @param[in] g        – wskaźnik na strukturę przechowującą stan gry.
  * @return szerokość planszy.
@@ -166,4 +395,63 @@ io_error_t gamma_render_field(const gamma_t *g, char *str, uint32_t x, uint32_t
                               uint32_t field_width, int *written_characters,
                               uint32_t *player_number);
 
+/**
+ * @brief Zwraca informacje o szerokościach pól podczas wypisywania planszy.
+ * Wskaźnik @p g musi wskazywać na prawidłowo zainicjowaną strukturę gry.
+ * @param[in] g                    - wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] first_column_width  - wskaźnik na komórkę, do której zapisana zostanie
+ *                                   szerokość pola z pierwszej kolumny,
+ * @param[out] field_width         - wskaźnik na komórkę, do której zapisana zostanie
+ *                                   szerokość pola z kolumn innych niż pierwsza.
+ */
+void gamma_rendered_fields_width(const gamma_t *g, unsigned *first_column_width,
+                                 unsigned *field_width);
+
+/**
+ * @brief Zwraca liczniki operacji wewnętrznych silnika.
+ * Liczniki są zbierane od utworzenia gry tylko wtedy, gdy silnik został
+ * skompilowany z makrem @p GAMMA_STATS (opcja CMake @p GAMMA_STATS).
+ * @param[in] g                    - wskaźnik na strukturę przechowującą stan gry,
+ * @param[out] stats               - wskaźnik na strukturę, do której zapisane
+ *                                   zostaną liczniki.
+ * @return Wartość @p true, jeżeli liczniki są dostępne, @p false jeżeli silnik
+ * został skompilowany bez nich (wtedy liczniki są zerowane) lub któryś
+ * z parametrów ma wartość NULL.
+ */
+bool gamma_stats(const gamma_t *g, gamma_stats_t *stats);
+
+/**
+ * @brief Wyznacza rozmiar bloków minimapy mieszczącej się w zadanym obszarze.
+ * Minimapa dzieli planszę na kwadratowe bloki o boku będącym potęgą dwójki,
+ * najmniejszym, przy którym minimapa ma nie więcej niż @p max_columns kolumn
+ * i @p max_rows wierszy. Przy pierwszym wywołaniu tworzy piramidę zajętości planszy
+ * w czasie O(width * height), którą następnie @ref gamma_move i
+ * @ref gamma_golden_move aktualizują w czasie O(log(max(width, height))).
+ * Piramida nie jest tworzona, jeżeli przekroczyłaby limit ustawiony przez
+ * @ref gamma_set_memory_limit.
+ * @param[in,out] g                - wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] max_columns          - maksymalna liczba kolumn minimapy, liczba dodatnia,
+ * @param[in] max_rows             - maksymalna liczba wierszy minimapy, liczba dodatnia,
+ * @param[out] block_size          - wskaźnik na komórkę, do której zapisany zostanie
+ *                                   bok bloku.
+ * @return Wartość @p true, jeżeli minimapa jest dostępna, @p false jeżeli parametry
+ * są niepoprawne, nie udało się zaalokować pamięci lub przekroczyłaby ona limit.
+ */
+bool gamma_minimap_block_size(gamma_t *g, uint32_t max_columns, uint32_t max_rows,
+                              uint32_t *block_size);
+
+/**
+ * @brief Zwraca podsumowanie bloku planszy.
+ * Rozmiar bloku musi być wyznaczony przez @ref gamma_minimap_block_size.
+ * Złożoność O(1).
+ * @param[in] g                    - wskaźnik na strukturę przechowującą stan gry,
+ * @param[in] block_size           - bok bloku,
+ * @param[in] column               - numer kolumny bloku,
+ * @param[in] row                  - numer wiersza bloku,
+ * @param[out] block               - wskaźnik na strukturę, do której zapisane
+ *                                   zostanie podsumowanie bloku.
+ */
+void gamma_minimap_block(const gamma_t *g, uint32_t block_size, uint32_t column,
+                         uint32_t row, gamma_block_summary_t *block);
+
 #endif /* GAMMA_H */
@@ -0,0 +1,460 @@
+/** @file
+ * Mikrobenchmarki najczęściej wywoływanych funkcji silnika gry gamma.
+ * Dla każdej konfiguracji planszy (rozmiar, liczba graczy, limit obszarów) mierzy
+ * czas wykonania jednej operacji, przepustowość oraz liczbę alokacji pamięci.
+ * Alokacje zliczane są przez opakowanie funkcji malloc, calloc i realloc opcją
+ * linkera --wrap. Z opcją --perf wypisywane są również sprzętowe liczniki
+ * wydajności w przeliczeniu na operację.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+/** _POSIX_C_SOURCE - wymagane, aby time.h definiowało funkcję clock_gettime */
+#define _POSIX_C_SOURCE 199309L
+
+#include "gamma.h"
+#include "huge_pages.h"
+#include "perf_counters.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Liczba wstępnie wylosowanych argumentów, używanych cyklicznie przez benchmarki. */
+#define RANDOM_ARGUMENTS 4096
+/** Domyślny czas trwania jednego benchmarku w milisekundach. */
+#define DEFAULT_BUDGET_MS 200
+/** Domyślne ziarno generatora liczb pseudolosowych. */
+#define DEFAULT_SEED 42
+/** Największa liczba pól planszy, dla której domyślnie mierzymy
+ * @ref gamma_golden_possible - pesymistycznie kwadratowe względem liczby pól. */
+#define GOLDEN_POSSIBLE_FIELDS_LIMIT 10000
+
+/** Przełącznik ograniczający największy bok planszy. */
+#define MAX_SIDE_OPTION "--max-side="
+/** Przełącznik ustawiający czas trwania jednego benchmarku. */
+#define BUDGET_OPTION "--budget-ms="
+/** Przełącznik ustawiający ziarno generatora liczb pseudolosowych. */
+#define SEED_OPTION "--seed="
+/** Przełącznik wyłączający limit rozmiaru planszy dla gamma_golden_possible. */
+#define FULL_OPTION "--full"
+/** Przełącznik włączający sprzętowe liczniki wydajności. */
+#define PERF_OPTION "--perf"
+/** Przełącznik alokujący plansze z dużych stron pamięci. */
+#define HUGE_PAGES_OPTION "--huge-pages"
+
+/** Boki mierzonych plansz kwadratowych. */
+static const uint32_t board_sides[] = {10, 100, 1000, 10000};
+/** Mierzone liczby graczy. */
+static const uint32_t players_counts[] = {2, 64};
+/** Mierzone limity obszarów. */
+static const uint32_t areas_limits[] = {1, 16};
+
+/** Liczba wywołań malloc, calloc i realloc. */
+static uint64_t allocations = 0;
+/** Łączna liczba bajtów, o które proszono w wywołaniach malloc, calloc i realloc. */
+static uint64_t allocated_bytes = 0;
+
+/** @brief Oryginalna funkcja malloc.
+ * @param[in] size        – liczba bajtów.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+void *__real_malloc(size_t size);
+
+/** @brief Oryginalna funkcja calloc.
+ * @param[in] count       – liczba elementów,
+ * @param[in] size        – rozmiar elementu.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+void *__real_calloc(size_t count, size_t size);
+
+/** @brief Oryginalna funkcja realloc.
+ * @param[in] ptr         – wskaźnik na pamięć lub NULL,
+ * @param[in] size        – nowa liczba bajtów.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+void *__real_realloc(void *ptr, size_t size);
+
+/** @brief Zlicza wywołanie malloc.
+ * @param[in] size        – liczba bajtów.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+void *__wrap_malloc(size_t size) {
+    allocations++;
+    allocated_bytes += size;
+    return __real_malloc(size);
+}
+
+/** @brief Zlicza wywołanie calloc.
+ * @param[in] count       – liczba elementów,
+ * @param[in] size        – rozmiar elementu.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+void *__wrap_calloc(size_t count, size_t size) {
+    allocations++;
+    allocated_bytes += count * size;
+    return __real_calloc(count, size);
+}
+
+/** @brief Zlicza wywołanie realloc.
+ * @param[in] ptr         – wskaźnik na pamięć lub NULL,
+ * @param[in] size        – nowa liczba bajtów.
+ * @return Wskaźnik na zaalokowaną pamięć lub NULL.
+ */
+void *__wrap_realloc(void *ptr, size_t size) {
+    allocations++;
+    allocated_bytes += size;
+    return __real_realloc(ptr, size);
+}
+
+/**
+ * Struktura przechowująca opcje benchmarków.
+ */
+typedef struct bench_options {
+    uint32_t max_side;  /**< Największy mierzony bok planszy. */
+    uint64_t budget_ns; /**< Czas trwania jednego benchmarku w nanosekundach. */
+    uint64_t seed;      /**< Ziarno generatora liczb pseudolosowych. */
+    bool full;          /**< Informacja czy mierzyć gamma_golden_possible na
+                         * wszystkich planszach. */
+    bool perf;          /**< Informacja czy odczytywać liczniki wydajności. */
+    perf_counters_t *counters; /**< Otwarte liczniki wydajności lub NULL, jeżeli
+                                * nie są odczytywane. */
+    const gamma_allocator_t *allocator; /**< Alokator gier lub NULL dla
+                                         * @ref gamma_new. */
+} bench_options_t;
+
+/**
+ * Struktura przechowująca argumenty jednego wywołania funkcji silnika.
+ */
+typedef struct bench_arguments {
+    uint32_t player; /**< Numer gracza. */
+    uint32_t x;      /**< Numer kolumny. */
+    uint32_t y;      /**< Numer wiersza. */
+} bench_arguments_t;
+
+/**
+ * Struktura przechowująca stan benchmarku jednej konfiguracji planszy.
+ */
+typedef struct bench_case {
+    gamma_t *game;     /**< Mierzona gra lub NULL. */
+    uint32_t side;     /**< Bok planszy. */
+    uint32_t players;  /**< Liczba graczy. */
+    uint32_t areas;    /**< Limit obszarów. */
+    const gamma_allocator_t *allocator; /**< Alokator gier lub NULL. */
+    bench_arguments_t arguments[RANDOM_ARGUMENTS]; /**< Wylosowane argumenty. */
+} bench_case_t;
+
+/** Typ funkcji wykonującej @p ops operacji w ramach benchmarku. */
+typedef void (*bench_function_t)(bench_case_t *bench, uint64_t first, uint64_t ops);
+
+/** @brief Zwraca wskazanie zegara monotonicznego.
+ * @return Czas w nanosekundach liczony od nieokreślonego momentu w przeszłości.
+ */
+static uint64_t monotonic_time_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+/** @brief Zwraca kolejną liczbę pseudolosową (xorshift64*).
+ * @param[in,out] state   – wskaźnik na niezerowy stan generatora.
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t next_random(uint64_t *state) {
+    *state ^= *state >> 12u;
+    *state ^= *state << 25u;
+    *state ^= *state >> 27u;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+/** @brief Losuje argumenty wywołań funkcji silnika dla zadanej konfiguracji.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in,out] state   – wskaźnik na stan generatora liczb pseudolosowych.
+ */
+static void draw_arguments(bench_case_t *bench, uint64_t *state) {
+    for (unsigned i = 0; i < RANDOM_ARGUMENTS; i++) {
+        bench->arguments[i].player = next_random(state) % bench->players + 1;
+        bench->arguments[i].x = next_random(state) % bench->side;
+        bench->arguments[i].y = next_random(state) % bench->side;
+    }
+}
+
+/** @brief Tworzy i usuwa grę @p ops razy.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in] first       – numer pierwszej operacji,
+ * @param[in] ops         – liczba operacji.
+ */
+static void bench_new(bench_case_t *bench, uint64_t first, uint64_t ops) {
+    (void)first;
+    for (uint64_t i = 0; i < ops; i++) {
+        gamma_delete(gamma_new_ex(bench->side, bench->side, bench->players,
+                                  bench->areas, bench->allocator));
+    }
+}
+
+/** @brief Wykonuje @p ops wywołań gamma_move z wylosowanymi argumentami.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in] first       – numer pierwszej operacji,
+ * @param[in] ops         – liczba operacji.
+ */
+static void bench_move(bench_case_t *bench, uint64_t first, uint64_t ops) {
+    for (uint64_t i = first; i < first + ops; i++) {
+        const bench_arguments_t *args = &bench->arguments[i % RANDOM_ARGUMENTS];
+        gamma_move(bench->game, args->player, args->x, args->y);
+    }
+}
+
+/** @brief Wykonuje @p ops wywołań gamma_golden_move z wylosowanymi argumentami.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in] first       – numer pierwszej operacji,
+ * @param[in] ops         – liczba operacji.
+ */
+static void bench_golden_move(bench_case_t *bench, uint64_t first, uint64_t ops) {
+    for (uint64_t i = first; i < first + ops; i++) {
+        const bench_arguments_t *args = &bench->arguments[i % RANDOM_ARGUMENTS];
+        gamma_golden_move(bench->game, args->player, args->x, args->y);
+    }
+}
+
+/** @brief Wykonuje @p ops wywołań gamma_golden_possible dla kolejnych graczy.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in] first       – numer pierwszej operacji,
+ * @param[in] ops         – liczba operacji.
+ */
+static void bench_golden_possible(bench_case_t *bench, uint64_t first, uint64_t ops) {
+    for (uint64_t i = first; i < first + ops; i++) {
+        gamma_golden_possible(bench->game, i % bench->players + 1);
+    }
+}
+
+/** @brief Wykonuje @p ops wywołań gamma_free_fields dla kolejnych graczy.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in] first       – numer pierwszej operacji,
+ * @param[in] ops         – liczba operacji.
+ */
+static void bench_free_fields(bench_case_t *bench, uint64_t first, uint64_t ops) {
+    for (uint64_t i = first; i < first + ops; i++) {
+        gamma_free_fields(bench->game, i % bench->players + 1);
+    }
+}
+
+/** @brief Wykonuje @p ops wywołań gamma_board.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in] first       – numer pierwszej operacji,
+ * @param[in] ops         – liczba operacji.
+ */
+static void bench_board(bench_case_t *bench, uint64_t first, uint64_t ops) {
+    (void)first;
+    for (uint64_t i = 0; i < ops; i++) {
+        gamma_board_free(bench->game, gamma_board(bench->game));
+    }
+}
+
+/** @brief Mierzy zadaną funkcję i wypisuje wynik.
+ * Wykonuje operacje w coraz większych porcjach, dopóki łączny czas nie przekroczy
+ * budżetu; wykonywana jest co najmniej jedna operacja. Liczniki wydajności
+ * zliczają jedynie wywołania mierzonej funkcji.
+ * @param[in] name        – nazwa benchmarku,
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in] function    – mierzona funkcja,
+ * @param[in] options     – wskaźnik na opcje benchmarków.
+ */
+static void run_benchmark(const char *name, bench_case_t *bench,
+                          bench_function_t function, const bench_options_t *options) {
+    uint64_t ops = 0, elapsed = 0, batch = 1;
+    allocations = 0;
+    allocated_bytes = 0;
+    if (options->counters != NULL) {
+        perf_counters_reset(options->counters);
+    }
+    while (elapsed < options->budget_ns) {
+        uint64_t start = monotonic_time_ns();
+        if (options->counters != NULL) {
+            perf_counters_start(options->counters);
+        }
+        function(bench, ops, batch);
+        if (options->counters != NULL) {
+            perf_counters_stop(options->counters);
+        }
+        elapsed += monotonic_time_ns() - start;
+        ops += batch;
+        batch *= 2;
+    }
+
+    char board[32];
+    snprintf(board, sizeof(board), "%" PRIu32 "x%" PRIu32, bench->side, bench->side);
+    printf("%-22s %-12s %7" PRIu32 " %6" PRIu32 " %12" PRIu64 " %14.1f %14.1f %10.2f "
+           "%12.1f",
+           name, board, bench->players, bench->areas, ops, (double)elapsed / ops,
+           ops * 1e9 / elapsed, (double)allocations / ops,
+           (double)allocated_bytes / ops);
+    for (unsigned i = 0; options->counters != NULL && i < PERF_COUNTERS_COUNT; i++) {
+        uint64_t value;
+        if (perf_counters_read(options->counters, (perf_counter_t)i, &value)) {
+            printf(" %13.2f", (double)value / ops);
+        } else {
+            printf(" %13s", "-");
+        }
+    }
+    printf("\n");
+}
+
+/** @brief Wypisuje informację o pominięciu benchmarku.
+ * @param[in] name        – nazwa benchmarku,
+ * @param[in] bench       – wskaźnik na stan benchmarku,
+ * @param[in] reason      – przyczyna pominięcia.
+ */
+static void skip_benchmark(const char *name, const bench_case_t *bench,
+                           const char *reason) {
+    char board[32];
+    snprintf(board, sizeof(board), "%" PRIu32 "x%" PRIu32, bench->side, bench->side);
+    printf("%-22s %-12s %7" PRIu32 " %6" PRIu32 " skipped: %s\n", name, board,
+           bench->players, bench->areas, reason);
+}
+
+/** @brief Losowo zapełnia planszę.
+ * Wykonuje liczbę prób ruchu równą połowie liczby pól planszy.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku,
+ * @param[in,out] state   – wskaźnik na stan generatora liczb pseudolosowych.
+ */
+static void fill_board(bench_case_t *bench, uint64_t *state) {
+    const uint64_t attempts = (uint64_t)bench->side * bench->side / 2;
+    for (uint64_t i = 0; i < attempts; i++) {
+        gamma_move(bench->game, next_random(state) % bench->players + 1,
+                   next_random(state) % bench->side, next_random(state) % bench->side);
+    }
+}
+
+/** @brief Uruchamia wszystkie benchmarki dla jednej konfiguracji planszy.
+ * @param[in,out] bench   – wskaźnik na stan benchmarku z ustawioną konfiguracją,
+ * @param[in] options     – wskaźnik na opcje benchmarków.
+ */
+static void run_case(bench_case_t *bench, const bench_options_t *options) {
+    uint64_t state = options->seed;
+    draw_arguments(bench, &state);
+    run_benchmark("gamma_new+delete", bench, bench_new, options);
+
+    bench->game = gamma_new_ex(bench->side, bench->side, bench->players, bench->areas,
+                               bench->allocator);
+    if (bench->game == NULL) {
+        skip_benchmark("*", bench, "out of memory");
+        return;
+    }
+    run_benchmark("gamma_move", bench, bench_move, options);
+
+    fill_board(bench, &state);
+    run_benchmark("gamma_free_fields", bench, bench_free_fields, options);
+    if (options->full ||
+        (uint64_t)bench->side * bench->side <= GOLDEN_POSSIBLE_FIELDS_LIMIT) {
+        run_benchmark("gamma_golden_possible", bench, bench_golden_possible, options);
+    } else {
+        skip_benchmark("gamma_golden_possible", bench, "board too large, use --full");
+    }
+    run_benchmark("gamma_board", bench, bench_board, options);
+    // Udany złoty ruch zmienia stan gry, więc mierzymy go na końcu.
+    run_benchmark("gamma_golden_move", bench, bench_golden_move, options);
+
+    gamma_delete(bench->game);
+    bench->game = NULL;
+}
+
+/** @brief Wczytuje opcje z wiersza poleceń.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów,
+ * @param[out] options    – wskaźnik na strukturę, do której zapisane zostaną opcje.
+ * @return Wartość @p true, jeżeli opcje są poprawne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_options(int argc, char *argv[], bench_options_t *options) {
+    options->max_side = UINT32_MAX;
+    options->budget_ns = DEFAULT_BUDGET_MS * 1000000ull;
+    options->seed = DEFAULT_SEED;
+    options->full = false;
+    options->perf = false;
+    options->counters = NULL;
+    options->allocator = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], MAX_SIDE_OPTION, strlen(MAX_SIDE_OPTION)) == 0) {
+            options->max_side = strtoul(argv[i] + strlen(MAX_SIDE_OPTION), NULL, 10);
+        } else if (strncmp(argv[i], BUDGET_OPTION, strlen(BUDGET_OPTION)) == 0) {
+            options->budget_ns =
+                strtoull(argv[i] + strlen(BUDGET_OPTION), NULL, 10) * 1000000ull;
+        } else if (strncmp(argv[i], SEED_OPTION, strlen(SEED_OPTION)) == 0) {
+            options->seed = strtoull(argv[i] + strlen(SEED_OPTION), NULL, 10);
+        } else if (strcmp(argv[i], FULL_OPTION) == 0) {
+            options->full = true;
+        } else if (strcmp(argv[i], PERF_OPTION) == 0) {
+            options->perf = true;
+        } else if (strcmp(argv[i], HUGE_PAGES_OPTION) == 0) {
+            options->allocator = &huge_page_allocator;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return false;
+        }
+    }
+    // Generator xorshift wymaga niezerowego stanu.
+    options->seed = options->seed != 0 ? options->seed : DEFAULT_SEED;
+    return true;
+}
+
+/** @brief Uruchamia mikrobenchmarki silnika gry gamma.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów.
+ * @return Zero, gdy wszystko przebiegło poprawnie, 1 jeżeli opcje są niepoprawne
+ * lub nie udało się zaalokować pamięci.
+ */
+int main(int argc, char *argv[]) {
+    bench_options_t options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+    bench_case_t *bench = malloc(sizeof(bench_case_t));
+    if (bench == NULL) {
+        return 1;
+    }
+    perf_counters_t counters;
+    if (options.perf) {
+        if (perf_counters_open(&counters)) {
+            options.counters = &counters;
+        } else {
+            fprintf(stderr, "Performance counters unavailable (check "
+                            "kernel.perf_event_paranoid), continuing without them\n");
+        }
+    }
+
+    const size_t sides = sizeof(board_sides) / sizeof(board_sides[0]);
+    const size_t players = sizeof(players_counts) / sizeof(players_counts[0]);
+    const size_t areas = sizeof(areas_limits) / sizeof(areas_limits[0]);
+    printf("%-22s %-12s %7s %6s %12s %14s %14s %10s %12s", "benchmark", "board",
+           "players", "areas", "ops", "ns/op", "ops/s", "allocs/op", "bytes/op");
+    for (unsigned i = 0; options.counters != NULL && i < PERF_COUNTERS_COUNT; i++) {
+        printf(" %13s", perf_counter_names[i]);
+    }
+    printf("\n");
+    for (size_t s = 0; s < sides; s++) {
+        if (board_sides[s] > options.max_side) {
+            continue;
+        }
+        for (size_t p = 0; p < players; p++) {
+            for (size_t a = 0; a < areas; a++) {
+                bench->game = NULL;
+                bench->side = board_sides[s];
+                bench->players = players_counts[p];
+                bench->areas = areas_limits[a];
+                bench->allocator = options.allocator;
+                run_case(bench, &options);
+                fflush(stdout);
+            }
+        }
+    }
+
+    if (options.counters != NULL) {
+        perf_counters_close(options.counters);
+    }
+    free(bench);
+    return 0;
+}
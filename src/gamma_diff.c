@@ -0,0 +1,811 @@
+/** @file
+ * Program porównujący silnik gry gamma z implementacją wzorcową.
+ * Wykonuje na obu implementacjach identyczne, losowe ciągi wywołań funkcji
+ * z gamma.h i porównuje każdy wynik oraz, po każdej zmianie stanu gry, napis
+ * z @ref gamma_board. Parametry kolejnych sesji (rozmiar planszy, liczba graczy,
+ * limit obszarów, wagi poleceń) są dobierane pod kątem pokrycia: sesje, które
+ * osiągnęły nową kombinację polecenia, wyniku, stanu gracza i kosztownych ścieżek
+ * silnika, trafiają do korpusu i są następnie modyfikowane. Silnik alokuje pamięć
+ * alokatorem sprawdzającym rozmiary zwalnianych bloków i brak wycieków. Przed
+ * losowymi sesjami sprawdzana jest gra z rzadką tablicą graczy, w której ruch
+ * wykonuje ponad 65536 graczy.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "gamma.h"
+#include "gamma_reference.h"
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Przełącznik ustawiający ziarno generatora liczb pseudolosowych. */
+#define SEED_OPTION "--seed="
+/** Przełącznik ustawiający liczbę sesji. */
+#define SESSIONS_OPTION "--sessions="
+/** Przełącznik ustawiający liczbę poleceń jednej sesji. */
+#define COMMANDS_OPTION "--commands="
+/** Przełącznik ograniczający największy bok planszy. */
+#define MAX_SIDE_OPTION "--max-side="
+/** Przełącznik powtarzający pojedynczą sesję o zadanych parametrach. */
+#define REPLAY_OPTION "--replay="
+
+/** Domyślne ziarno generatora liczb pseudolosowych. */
+#define DEFAULT_SEED 1
+/** Domyślna liczba sesji. */
+#define DEFAULT_SESSIONS 1000
+/** Domyślna liczba poleceń jednej sesji. */
+#define DEFAULT_COMMANDS 2000
+/** Domyślny największy bok planszy. */
+#define DEFAULT_MAX_SIDE 12
+/** Największa liczba graczy zwykłej sesji. */
+#define MAX_PLAYERS 12
+/** Co która sesja ma liczbę graczy niemieszczącą się w jednym bajcie. */
+#define WIDE_PLAYERS_PERIOD 8
+/** Największy limit obszarów sesji. */
+#define MAX_AREAS 6
+/** Bok planszy sesji sprawdzającej rzadką tablicę graczy. */
+#define SPARSE_SIDE 300
+/** Liczba graczy sesji sprawdzającej rzadką tablicę graczy. */
+#define SPARSE_PLAYERS 100000
+/** Liczba graczy wykonujących ruch w sesji sprawdzającej rzadką tablicę graczy;
+ * większa niż 65536, aby tablica urosła do pojemności równej liczbie graczy. */
+#define SPARSE_MOVING_PLAYERS 70000
+/** Największa waga polecenia. */
+#define MAX_WEIGHT 20
+/** Największa liczba parametrów sesji przechowywanych w korpusie. */
+#define CORPUS_CAPACITY 256
+
+/** Wszystkie identyfikatory porównywanych poleceń. */
+#define COMMANDS "mgbfqp"
+/** Liczba porównywanych poleceń. */
+#define COMMANDS_COUNT 6
+/** Liczba cech pokrycia jednego polecenia zwracającego wartość logiczną:
+ * wynik (2) x flagi ścieżek silnika (8) x gracz na limicie obszarów (2). */
+#define BOOL_COMMAND_FEATURES 32
+/** Liczba cech pokrycia jednego polecenia zwracającego liczbę:
+ * przedział wyniku (4) x gracz na limicie obszarów (2). */
+#define COUNT_COMMAND_FEATURES 8
+/** Łączna liczba cech pokrycia: polecenia m, g, q, b, f oraz p. */
+#define FEATURES_COUNT (3 * BOOL_COMMAND_FEATURES + 2 * COUNT_COMMAND_FEATURES + 1)
+
+/**
+ * Struktura przechowująca parametry jednej sesji; sesja jest nimi w pełni
+ * wyznaczona.
+ */
+typedef struct session_params {
+    uint64_t seed;                    /**< Ziarno losowania poleceń. */
+    uint32_t width;                   /**< Szerokość planszy. */
+    uint32_t height;                  /**< Wysokość planszy. */
+    uint32_t players;                 /**< Liczba graczy. */
+    uint32_t areas;                   /**< Limit obszarów. */
+    uint32_t weights[COMMANDS_COUNT]; /**< Wagi kolejnych poleceń z @ref COMMANDS. */
+} session_params_t;
+
+/**
+ * Struktura przechowująca opcje programu.
+ */
+typedef struct diff_options {
+    uint64_t seed;       /**< Ziarno generatora parametrów sesji. */
+    uint64_t sessions;   /**< Liczba sesji. */
+    uint64_t commands;   /**< Liczba poleceń jednej sesji. */
+    uint32_t max_side;   /**< Największy bok planszy. */
+    bool replay;         /**< Informacja czy powtórzyć jedną sesję. */
+    session_params_t replayed; /**< Parametry powtarzanej sesji. */
+} diff_options_t;
+
+/**
+ * Struktura przechowująca stan alokatora sprawdzającego.
+ */
+typedef struct checked_allocator {
+    uint64_t live_blocks; /**< Liczba niezwolnionych bloków. */
+    bool size_mismatch;   /**< Informacja czy podano błędny rozmiar bloku. */
+} checked_allocator_t;
+
+/**
+ * Nagłówek bloku alokatora sprawdzającego; wyrównany jak @p max_align_t, aby
+ * blok za nim był poprawnie wyrównany.
+ */
+typedef union block_header {
+    size_t size;        /**< Rozmiar bloku podany przy alokacji. */
+    max_align_t align;  /**< Wyrównanie nagłówka. */
+} block_header_t;
+
+/**
+ * Struktura przechowująca stan porównania.
+ */
+typedef struct diff_state {
+    bool covered[FEATURES_COUNT]; /**< Osiągnięte cechy pokrycia. */
+    unsigned covered_count;       /**< Liczba osiągniętych cech pokrycia. */
+    session_params_t corpus[CORPUS_CAPACITY]; /**< Parametry sesji, które osiągnęły
+                                               * nowe cechy pokrycia. */
+    unsigned corpus_size;         /**< Liczba parametrów w korpusie. */
+    uint64_t commands;            /**< Liczba porównanych wywołań. */
+} diff_state_t;
+
+/** @brief Zwraca kolejną liczbę pseudolosową (splitmix64).
+ * @param[in,out] state   – wskaźnik na stan generatora.
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t next_random(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+/** @brief Zwraca liczbę pseudolosową z przedziału [@p low, @p high].
+ * @param[in,out] state   – wskaźnik na stan generatora,
+ * @param[in] low         – najmniejsza wartość,
+ * @param[in] high        – największa wartość.
+ * @return Liczba pseudolosowa.
+ */
+static uint32_t random_between(uint64_t *state, uint32_t low, uint32_t high) {
+    return low + (uint32_t)(next_random(state) % ((uint64_t)high - low + 1));
+}
+
+/** @brief Zaznacza cechę pokrycia.
+ * @param[in,out] state   – wskaźnik na stan porównania,
+ * @param[in] feature     – numer cechy.
+ * @return Wartość @p true, jeżeli cecha nie była wcześniej osiągnięta.
+ */
+static bool cover(diff_state_t *state, unsigned feature) {
+    if (state->covered[feature]) {
+        return false;
+    }
+    state->covered[feature] = true;
+    state->covered_count++;
+    return true;
+}
+
+/** @brief Alokuje blok, zapamiętując jego rozmiar w nagłówku.
+ * @param[in,out] context – wskaźnik na stan alokatora sprawdzającego,
+ * @param[in] size        – rozmiar bloku.
+ * @return Wskaźnik na blok lub NULL, jeśli nie udało się zaalokować pamięci.
+ */
+static void *checked_alloc(void *context, size_t size) {
+    block_header_t *header = malloc(sizeof(block_header_t) + size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->size = size;
+    ((checked_allocator_t *)context)->live_blocks++;
+    return header + 1;
+}
+
+/** @brief Zwraca nagłówek bloku, sprawdzając podany rozmiar.
+ * @param[in,out] context – wskaźnik na stan alokatora sprawdzającego,
+ * @param[in] ptr         – wskaźnik na blok,
+ * @param[in] size        – rozmiar bloku podany przez silnik.
+ * @return Wskaźnik na nagłówek bloku.
+ */
+static block_header_t *checked_header(void *context, void *ptr, size_t size) {
+    block_header_t *header = (block_header_t *)ptr - 1;
+    if (header->size != size) {
+        ((checked_allocator_t *)context)->size_mismatch = true;
+    }
+    return header;
+}
+
+/** @brief Zmienia rozmiar bloku alokatora sprawdzającego.
+ * @param[in,out] context – wskaźnik na stan alokatora sprawdzającego,
+ * @param[in] ptr         – wskaźnik na blok,
+ * @param[in] old_size    – dotychczasowy rozmiar bloku,
+ * @param[in] new_size    – nowy rozmiar bloku.
+ * @return Wskaźnik na blok lub NULL, jeśli nie udało się zaalokować pamięci.
+ */
+static void *checked_realloc(void *context, void *ptr, size_t old_size,
+                             size_t new_size) {
+    block_header_t *header = checked_header(context, ptr, old_size);
+    header = realloc(header, sizeof(block_header_t) + new_size);
+    if (header == NULL) {
+        return NULL;
+    }
+    header->size = new_size;
+    return header + 1;
+}
+
+/** @brief Zwalnia blok alokatora sprawdzającego.
+ * @param[in,out] context – wskaźnik na stan alokatora sprawdzającego,
+ * @param[in] ptr         – wskaźnik na blok,
+ * @param[in] size        – rozmiar bloku.
+ */
+static void checked_free(void *context, void *ptr, size_t size) {
+    free(checked_header(context, ptr, size));
+    ((checked_allocator_t *)context)->live_blocks--;
+}
+
+/** @brief Wypisuje parametry sesji w postaci wartości opcji @ref REPLAY_OPTION.
+ * @param[in] stream      – strumień wyjścia,
+ * @param[in] params      – wskaźnik na parametry sesji.
+ */
+static void print_params(FILE *stream, const session_params_t *params) {
+    fprintf(stream, "%s%" PRIu64 ":%" PRIu32 ":%" PRIu32 ":%" PRIu32 ":%" PRIu32,
+            REPLAY_OPTION, params->seed, params->width, params->height,
+            params->players, params->areas);
+    for (unsigned i = 0; i < COMMANDS_COUNT; i++) {
+        fprintf(stream, ":%" PRIu32, params->weights[i]);
+    }
+}
+
+/** @brief Zgłasza rozbieżność wyników obu implementacji.
+ * @param[in] params      – wskaźnik na parametry sesji,
+ * @param[in] index       – numer wywołania w sesji,
+ * @param[in] command     – znak oznaczający typ komendy,
+ * @param[in] args        – argumenty komendy,
+ * @param[in] what        – opis porównywanej wartości,
+ * @param[in] expected    – wynik implementacji wzorcowej,
+ * @param[in] actual      – wynik silnika.
+ */
+static void report_mismatch(const session_params_t *params, uint64_t index,
+                            char command, const uint32_t *args, const char *what,
+                            const char *expected, const char *actual) {
+    fprintf(stderr, "MISMATCH in call %" PRIu64 ": %c %" PRIu32 " %" PRIu32
+                    " %" PRIu32 " (%s)\n",
+            index, command, args[0], args[1], args[2], what);
+    fprintf(stderr, "expected:\n%s\nactual:\n%s\nreproduce with: gamma_diff ",
+            expected, actual);
+    print_params(stderr, params);
+    fprintf(stderr, " --commands=%" PRIu64 "\n", index + 1);
+}
+
+/** @brief Porównuje plansze obu implementacji.
+ * @param[in] g           – wskaźnik na stan gry silnika,
+ * @param[in] reference   – wskaźnik na stan gry wzorcowej,
+ * @param[in] params      – wskaźnik na parametry sesji,
+ * @param[in] index       – numer wywołania w sesji,
+ * @param[in] command     – znak oznaczający typ komendy,
+ * @param[in] args        – argumenty komendy.
+ * @return Wartość @p true, jeżeli plansze są identyczne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool compare_boards(gamma_t *g, const reference_game_t *reference,
+                           const session_params_t *params, uint64_t index,
+                           char command, const uint32_t *args) {
+    char *actual = gamma_board(g);
+    char *expected = reference_board(reference);
+    const bool same =
+        actual != NULL && expected != NULL && strcmp(actual, expected) == 0;
+    if (!same) {
+        report_mismatch(params, index, command, args, "gamma_board",
+                        expected != NULL ? expected : "(null)",
+                        actual != NULL ? actual : "(null)");
+    }
+    gamma_board_free(g, actual);
+    free(expected);
+    return same;
+}
+
+/** @brief Porównuje statystyki graczy obu implementacji.
+ * @param[in] g           – wskaźnik na stan gry silnika,
+ * @param[in,out] reference – wskaźnik na stan gry wzorcowej,
+ * @param[in] params      – wskaźnik na parametry sesji,
+ * @param[in] index       – numer wywołania w sesji,
+ * @param[in] command     – znak oznaczający typ komendy,
+ * @param[in] args        – argumenty komendy.
+ * @return Wartość @p true, jeżeli statystyki są identyczne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool compare_aggregates(const gamma_t *g, reference_game_t *reference,
+                               const session_params_t *params, uint64_t index,
+                               char command, const uint32_t *args) {
+    uint64_t expected_busy, actual_busy;
+    const uint32_t expected_leader = reference_leader(reference, &expected_busy);
+    const uint32_t actual_leader = gamma_leader(g, &actual_busy);
+    char expected[80], actual[80];
+    snprintf(expected, sizeof(expected),
+             "players %" PRIu32 " max %" PRIu32 " leader %" PRIu32 " busy %" PRIu64,
+             reference_players_with_fields(reference),
+             reference_max_player_with_fields(reference), expected_leader,
+             expected_busy);
+    snprintf(actual, sizeof(actual),
+             "players %" PRIu32 " max %" PRIu32 " leader %" PRIu32 " busy %" PRIu64,
+             gamma_players_with_fields(g), gamma_max_player_with_fields(g),
+             actual_leader, actual_busy);
+    if (strcmp(expected, actual) != 0) {
+        report_mismatch(params, index, command, args, "aggregates", expected, actual);
+        return false;
+    }
+    return true;
+}
+
+/** @brief Porównuje wyniki @ref gamma_golden_possible_all z wynikami
+ * @ref gamma_golden_possible poszczególnych graczy.
+ * Wyniki pojedynczych graczy porównywane są z implementacją wzorcową przez
+ * polecenie @p q. W grze o liczbie graczy większej niż
+ * @ref GAMMA_DENSE_PLAYERS_LIMIT funkcja musi zwrócić błąd.
+ * @param[in,out] g       – wskaźnik na stan gry silnika,
+ * @param[in] params      – wskaźnik na parametry sesji,
+ * @param[in] index       – numer wywołania w sesji,
+ * @param[in] command     – znak oznaczający typ komendy,
+ * @param[in] args        – argumenty komendy.
+ * @return Wartość @p true, jeżeli wyniki są zgodne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool compare_golden_possible_all(gamma_t *g, const session_params_t *params,
+                                        uint64_t index, char command,
+                                        const uint32_t *args) {
+    if (params->players > GAMMA_DENSE_PLAYERS_LIMIT) {
+        // Gra z rzadką tablicą graczy jest odrzucana przed zapisaniem wyników.
+        bool ignored;
+        if (gamma_golden_possible_all(g, &ignored)) {
+            report_mismatch(params, index, command, args, "gamma_golden_possible_all",
+                            "false", "true");
+            return false;
+        }
+        return true;
+    }
+    bool *all = malloc(params->players * sizeof(bool));
+    if (all == NULL || !gamma_golden_possible_all(g, all)) {
+        free(all);
+        report_mismatch(params, index, command, args, "gamma_golden_possible_all",
+                        "results", "failure");
+        return false;
+    }
+    bool same = true;
+    for (uint32_t player = 1; player <= params->players && same; player++) {
+        const bool expected = gamma_golden_possible(g, player);
+        if (all[player - 1] != expected) {
+            char what[48];
+            snprintf(what, sizeof(what), "gamma_golden_possible_all, player %" PRIu32,
+                     player);
+            report_mismatch(params, index, command, args, what, expected ? "1" : "0",
+                            expected ? "0" : "1");
+            same = false;
+        }
+    }
+    free(all);
+    gamma_take_paths(g);
+    return same;
+}
+
+/** @brief Losuje polecenie zgodnie z wagami sesji.
+ * @param[in] params      – wskaźnik na parametry sesji,
+ * @param[in,out] random  – wskaźnik na stan generatora.
+ * @return Znak oznaczający typ komendy.
+ */
+static char draw_command(const session_params_t *params, uint64_t *random) {
+    uint32_t total = 0;
+    for (unsigned i = 0; i < COMMANDS_COUNT; i++) {
+        total += params->weights[i];
+    }
+    uint32_t value = random_between(random, 1, total);
+    for (unsigned i = 0; i < COMMANDS_COUNT; i++) {
+        if (value <= params->weights[i]) {
+            return COMMANDS[i];
+        }
+        value -= params->weights[i];
+    }
+    return COMMANDS[0];
+}
+
+/** @brief Losuje argumenty polecenia.
+ * Zwykle wybiera poprawnego gracza i pole sąsiadujące z poprzednim polem,
+ * aby obszary łączyły się i dzieliły; czasem losuje argumenty niepoprawne.
+ * @param[in] params      – wskaźnik na parametry sesji,
+ * @param[in,out] random  – wskaźnik na stan generatora,
+ * @param[in,out] args    – argumenty poprzedniego polecenia, zastępowane nowymi.
+ */
+static void draw_arguments(const session_params_t *params, uint64_t *random,
+                           uint32_t *args) {
+    const uint32_t kind = random_between(random, 0, 99);
+    args[0] = kind < 3 ? (kind == 0 ? 0 : params->players + 1)
+                       : random_between(random, 1, params->players);
+    if (kind >= 3 && kind < 5) {
+        args[1] = kind == 3 ? params->width : UINT32_MAX;
+        args[2] = random_between(random, 0, params->height - 1);
+    } else if (kind < 60) {
+        const uint32_t dx = random_between(random, 0, 2);
+        const uint32_t dy = random_between(random, 0, 2);
+        args[1] = args[1] < params->width ? args[1] : 0;
+        args[2] = args[2] < params->height ? args[2] : 0;
+        args[1] = args[1] + dx > 0 && args[1] + dx - 1 < params->width
+                      ? args[1] + dx - 1
+                      : args[1];
+        args[2] = args[2] + dy > 0 && args[2] + dy - 1 < params->height
+                      ? args[2] + dy - 1
+                      : args[2];
+    } else {
+        args[1] = random_between(random, 0, params->width - 1);
+        args[2] = random_between(random, 0, params->height - 1);
+    }
+}
+
+/** @brief Zwraca numer przedziału wyniku liczbowego.
+ * @param[in] value       – wynik.
+ * @return Numer przedziału z [0, 3].
+ */
+static unsigned count_bucket(uint64_t value) {
+    return value == 0 ? 0 : value == 1 ? 1 : value < 8 ? 2 : 3;
+}
+
+/** @brief Wykonuje jedno polecenie na obu implementacjach i porównuje wyniki.
+ * @param[in,out] g        – wskaźnik na stan gry silnika,
+ * @param[in,out] reference – wskaźnik na stan gry wzorcowej,
+ * @param[in] params       – wskaźnik na parametry sesji,
+ * @param[in] index        – numer wywołania w sesji,
+ * @param[in] command      – znak oznaczający typ komendy,
+ * @param[in] args         – argumenty komendy,
+ * @param[out] feature     – wskaźnik na numer osiągniętej cechy pokrycia.
+ * @return Wartość @p true, jeżeli wyniki są zgodne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool run_command(gamma_t *g, reference_game_t *reference,
+                        const session_params_t *params, uint64_t index, char command,
+                        const uint32_t *args, unsigned *feature) {
+    const unsigned at_limit = gamma_player_areas(g, args[0]) >= gamma_max_areas(g);
+    uint64_t expected, actual;
+    unsigned base;
+    if (command == 'm') {
+        expected = reference_move(reference, args[0], args[1], args[2]);
+        actual = gamma_move(g, args[0], args[1], args[2]);
+        base = 0;
+    } else if (command == 'g') {
+        expected = reference_golden_move(reference, args[0], args[1], args[2]);
+        actual = gamma_golden_move(g, args[0], args[1], args[2]);
+        base = BOOL_COMMAND_FEATURES;
+    } else if (command == 'q') {
+        expected = reference_golden_possible(reference, args[0]);
+        actual = gamma_golden_possible(g, args[0]);
+        base = 2 * BOOL_COMMAND_FEATURES;
+    } else if (command == 'b') {
+        expected = reference_busy_fields(reference, args[0]);
+        actual = gamma_busy_fields(g, args[0]);
+        base = 3 * BOOL_COMMAND_FEATURES;
+    } else if (command == 'f') {
+        expected = reference_free_fields(reference, args[0]);
+        actual = gamma_free_fields(g, args[0]);
+        base = 3 * BOOL_COMMAND_FEATURES + COUNT_COMMAND_FEATURES;
+    } else {
+        *feature = FEATURES_COUNT - 1;
+        return compare_boards(g, reference, params, index, command, args);
+    }
+
+    const unsigned paths = gamma_take_paths(g);
+    if (command == 'b' || command == 'f') {
+        *feature = base + count_bucket(actual) * 2 + at_limit;
+    } else {
+        *feature = base + ((unsigned)actual * 8 + paths) * 2 + at_limit;
+    }
+    if (expected != actual) {
+        char expected_text[24], actual_text[24];
+        snprintf(expected_text, sizeof(expected_text), "%" PRIu64, expected);
+        snprintf(actual_text, sizeof(actual_text), "%" PRIu64, actual);
+        report_mismatch(params, index, command, args, "result", expected_text,
+                        actual_text);
+        return false;
+    }
+    if (command == 'q') {
+        return compare_golden_possible_all(g, params, index, command, args);
+    }
+    // Stan gry zmieniają tylko udane ruchy.
+    if ((command == 'm' || command == 'g') && actual) {
+        return compare_boards(g, reference, params, index, command, args) &&
+               compare_aggregates(g, reference, params, index, command, args);
+    }
+    return true;
+}
+
+/** @brief Przeprowadza jedną sesję porównania.
+ * @param[in,out] state   – wskaźnik na stan porównania,
+ * @param[in] params      – wskaźnik na parametry sesji,
+ * @param[in] commands    – liczba poleceń sesji,
+ * @param[out] new_coverage – wskaźnik na informację, czy sesja osiągnęła nową
+ *                            cechę pokrycia.
+ * @return Wartość @p true, jeżeli wszystkie wyniki są zgodne, @p false
+ * w przeciwnym przypadku.
+ */
+static bool run_session(diff_state_t *state, const session_params_t *params,
+                        uint64_t commands, bool *new_coverage) {
+    checked_allocator_t checked = {0, false};
+    const gamma_allocator_t allocator = {checked_alloc, checked_realloc, checked_free,
+                                         &checked};
+    gamma_t *g = gamma_new_ex(params->width, params->height, params->players,
+                              params->areas, &allocator);
+    reference_game_t *reference =
+        reference_new(params->width, params->height, params->players, params->areas);
+    if (g == NULL || reference == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        gamma_delete(g);
+        reference_delete(reference);
+        return false;
+    }
+
+    uint64_t random = params->seed;
+    uint32_t args[3] = {1, params->width / 2, params->height / 2};
+    bool same = true;
+    *new_coverage = false;
+    for (uint64_t i = 0; i < commands && same; i++) {
+        const char command = draw_command(params, &random);
+        draw_arguments(params, &random, args);
+        unsigned feature;
+        same = run_command(g, reference, params, i, command, args, &feature);
+        *new_coverage |= cover(state, feature);
+        state->commands++;
+    }
+    if (same) {
+        same = compare_boards(g, reference, params, commands, 'p', args);
+    }
+
+    gamma_delete(g);
+    reference_delete(reference);
+    if (same && (checked.live_blocks != 0 || checked.size_mismatch)) {
+        fprintf(stderr, "ALLOCATOR MISUSE: %" PRIu64 " blocks leaked%s\n"
+                        "reproduce with: gamma_diff ",
+                checked.live_blocks,
+                checked.size_mismatch ? ", wrong block size passed" : "");
+        print_params(stderr, params);
+        fprintf(stderr, " --commands=%" PRIu64 "\n", commands);
+        same = false;
+    }
+    return same;
+}
+
+/** @brief Sprawdza grę z rzadką tablicą graczy, w której ruch wykonuje wielu graczy.
+ * Implementacja wzorcowa byłaby tu zbyt wolna, więc wyniki porównywane są z wartościami
+ * oczekiwanymi: każdy gracz zajmuje jedno pole, kolejne pola w kolejności wierszy.
+ * @param[in,out] state   – wskaźnik na stan porównania.
+ * @return Wartość @p true, jeżeli wszystkie wyniki są zgodne, @p false
+ * w przeciwnym przypadku.
+ */
+static bool run_sparse_players_session(diff_state_t *state) {
+    checked_allocator_t checked = {0, false};
+    const gamma_allocator_t allocator = {checked_alloc, checked_realloc, checked_free,
+                                         &checked};
+    gamma_t *g = gamma_new_ex(SPARSE_SIDE, SPARSE_SIDE, SPARSE_PLAYERS, SPARSE_PLAYERS,
+                              &allocator);
+    if (g == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return false;
+    }
+
+    bool same = true;
+    for (uint32_t player = 1; player <= SPARSE_MOVING_PLAYERS && same; player++) {
+        same = gamma_move(g, player, (player - 1) % SPARSE_SIDE,
+                          (player - 1) / SPARSE_SIDE);
+        state->commands++;
+    }
+    for (uint32_t player = 1; player <= SPARSE_MOVING_PLAYERS && same; player++) {
+        same = gamma_busy_fields(g, player) == 1;
+    }
+    uint64_t busy;
+    same = same && gamma_busy_fields(g, SPARSE_PLAYERS) == 0 &&
+           gamma_players_with_fields(g) == SPARSE_MOVING_PLAYERS &&
+           gamma_max_player_with_fields(g) == SPARSE_MOVING_PLAYERS &&
+           gamma_leader(g, &busy) == 0 && busy == 1;
+    gamma_delete(g);
+    if (!same || checked.live_blocks != 0 || checked.size_mismatch) {
+        fprintf(stderr, "MISMATCH in sparse session: %" PRIu32 "x%" PRIu32
+                        ", %" PRIu32 " players, %" PRIu32 " moving\n",
+                (uint32_t)SPARSE_SIDE, (uint32_t)SPARSE_SIDE, (uint32_t)SPARSE_PLAYERS,
+                (uint32_t)SPARSE_MOVING_PLAYERS);
+        return false;
+    }
+    return true;
+}
+
+/** @brief Losuje liczbę graczy sesji.
+ * Zwykle jest ona mała, aby gracze często się spotykali, a czasem przekracza
+ * zakres jednego lub dwóch bajtów, aby sprawdzić szersze numery graczy na planszy.
+ * @param[in,out] random  – wskaźnik na stan generatora.
+ * @return Liczba graczy.
+ */
+static uint32_t draw_players(uint64_t *random) {
+    if (random_between(random, 1, WIDE_PLAYERS_PERIOD) > 1) {
+        return random_between(random, 1, MAX_PLAYERS);
+    }
+    const uint32_t base = random_between(random, 0, 1) == 0 ? UINT8_MAX : UINT16_MAX;
+    return base + random_between(random, 1, MAX_PLAYERS);
+}
+
+/** @brief Losuje nowe parametry sesji.
+ * @param[out] params     – wskaźnik na parametry sesji,
+ * @param[in,out] random  – wskaźnik na stan generatora,
+ * @param[in] max_side    – największy bok planszy.
+ */
+static void draw_params(session_params_t *params, uint64_t *random, uint32_t max_side) {
+    params->seed = next_random(random);
+    params->width = random_between(random, 1, max_side);
+    params->height = random_between(random, 1, max_side);
+    params->players = draw_players(random);
+    params->areas = random_between(random, 1, MAX_AREAS);
+    for (unsigned i = 0; i < COMMANDS_COUNT; i++) {
+        params->weights[i] = random_between(random, 0, MAX_WEIGHT);
+    }
+    // Bez ruchów plansza pozostaje pusta.
+    params->weights[0] += 1;
+}
+
+/** @brief Modyfikuje parametry sesji z korpusu.
+ * Zawsze zmienia ziarno losowania poleceń i z prawdopodobieństwem 1/2 jeden
+ * z pozostałych parametrów.
+ * @param[in,out] params  – wskaźnik na parametry sesji,
+ * @param[in,out] random  – wskaźnik na stan generatora,
+ * @param[in] max_side    – największy bok planszy.
+ */
+static void mutate_params(session_params_t *params, uint64_t *random,
+                          uint32_t max_side) {
+    params->seed = next_random(random);
+    switch (random_between(random, 0, 9)) {
+    case 0:
+        params->width = random_between(random, 1, max_side);
+        break;
+    case 1:
+        params->height = random_between(random, 1, max_side);
+        break;
+    case 2:
+        params->players = draw_players(random);
+        break;
+    case 3:
+        params->areas = random_between(random, 1, MAX_AREAS);
+        break;
+    case 4:
+        params->weights[random_between(random, 1, COMMANDS_COUNT - 1)] =
+            random_between(random, 0, MAX_WEIGHT);
+        break;
+    default:
+        break;
+    }
+}
+
+/** @brief Wczytuje liczbę nieujemną z wartości opcji.
+ * @param[in] text        – tekst liczby,
+ * @param[in] max         – największa dopuszczalna wartość,
+ * @param[out] value      – wskaźnik na wczytaną wartość,
+ * @param[out] end        – wskaźnik na pierwszy znak za liczbą lub NULL, jeżeli
+ *                          liczba musi kończyć tekst.
+ * @return Wartość @p true, jeżeli tekst zaczyna się poprawną liczbą, @p false
+ * w przeciwnym przypadku.
+ */
+static bool parse_number(const char *text, uint64_t max, uint64_t *value,
+                         const char **end) {
+    char *number_end;
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    unsigned long long number = strtoull(text, &number_end, 10);
+    if (number > max || (end == NULL && *number_end != '\0')) {
+        return false;
+    }
+    *value = number;
+    if (end != NULL) {
+        *end = number_end;
+    }
+    return true;
+}
+
+/** @brief Wczytuje parametry powtarzanej sesji.
+ * @param[in] text        – parametry w postaci wypisywanej przez @ref print_params,
+ * @param[out] params     – wskaźnik na wczytane parametry.
+ * @return Wartość @p true, jeżeli parametry są poprawne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_params(const char *text, session_params_t *params) {
+    uint64_t values[5 + COMMANDS_COUNT];
+    const uint64_t limits[5] = {UINT64_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX,
+                                UINT32_MAX};
+    uint32_t total_weight = 0;
+    for (unsigned i = 0; i < 5 + COMMANDS_COUNT; i++) {
+        const uint64_t max = i < 5 ? limits[i] : MAX_WEIGHT;
+        if (!parse_number(text, max, &values[i], &text) ||
+            *text != (i + 1 < 5 + COMMANDS_COUNT ? ':' : '\0') ||
+            (i > 0 && i < 5 && values[i] == 0)) {
+            return false;
+        }
+        text++;
+        total_weight += i >= 5 ? (uint32_t)values[i] : 0;
+    }
+    params->seed = values[0];
+    params->width = (uint32_t)values[1];
+    params->height = (uint32_t)values[2];
+    params->players = (uint32_t)values[3];
+    params->areas = (uint32_t)values[4];
+    for (unsigned i = 0; i < COMMANDS_COUNT; i++) {
+        params->weights[i] = (uint32_t)values[5 + i];
+    }
+    return total_weight > 0;
+}
+
+/** @brief Wczytuje opcje z wiersza poleceń.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów,
+ * @param[out] options    – wskaźnik na strukturę, do której zapisane zostaną opcje.
+ * @return Wartość @p true, jeżeli opcje są poprawne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_options(int argc, char *argv[], diff_options_t *options) {
+    options->seed = DEFAULT_SEED;
+    options->sessions = DEFAULT_SESSIONS;
+    options->commands = DEFAULT_COMMANDS;
+    options->max_side = DEFAULT_MAX_SIDE;
+    options->replay = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        uint64_t value;
+        bool valid;
+        if (strncmp(arg, SEED_OPTION, strlen(SEED_OPTION)) == 0) {
+            valid = parse_number(arg + strlen(SEED_OPTION), UINT64_MAX, &options->seed,
+                                 NULL);
+        } else if (strncmp(arg, SESSIONS_OPTION, strlen(SESSIONS_OPTION)) == 0) {
+            valid = parse_number(arg + strlen(SESSIONS_OPTION), UINT64_MAX,
+                                 &options->sessions, NULL);
+        } else if (strncmp(arg, COMMANDS_OPTION, strlen(COMMANDS_OPTION)) == 0) {
+            valid = parse_number(arg + strlen(COMMANDS_OPTION), UINT64_MAX,
+                                 &options->commands, NULL);
+        } else if (strncmp(arg, MAX_SIDE_OPTION, strlen(MAX_SIDE_OPTION)) == 0) {
+            valid = parse_number(arg + strlen(MAX_SIDE_OPTION), UINT32_MAX, &value,
+                                 NULL) &&
+                    value > 0;
+            options->max_side = (uint32_t)value;
+        } else if (strncmp(arg, REPLAY_OPTION, strlen(REPLAY_OPTION)) == 0) {
+            options->replay = true;
+            valid = parse_params(arg + strlen(REPLAY_OPTION), &options->replayed);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+        if (!valid) {
+            fprintf(stderr, "Invalid value in option %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Porównuje silnik gry gamma z implementacją wzorcową.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów.
+ * @return Zero, gdy wszystkie wyniki są zgodne, 1 jeżeli opcje są niepoprawne,
+ * nie udało się zaalokować pamięci lub wykryto rozbieżność.
+ */
+int main(int argc, char *argv[]) {
+    diff_options_t options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+    diff_state_t *state = calloc(1, sizeof(diff_state_t));
+    if (state == NULL) {
+        return 1;
+    }
+
+    bool same = true;
+    bool new_coverage;
+    uint64_t random = options.seed, sessions = 0;
+    if (!options.replay) {
+        same = run_sparse_players_session(state);
+    }
+    if (options.replay) {
+        same = run_session(state, &options.replayed, options.commands, &new_coverage);
+        sessions = 1;
+    }
+    for (; !options.replay && same && sessions < options.sessions; sessions++) {
+        session_params_t params;
+        // Co czwarta sesja ma zupełnie nowe parametry, pozostałe modyfikują korpus.
+        if (state->corpus_size > 0 && random_between(&random, 0, 3) != 0) {
+            params = state->corpus[random_between(&random, 0, state->corpus_size - 1)];
+            mutate_params(&params, &random, options.max_side);
+        } else {
+            draw_params(&params, &random, options.max_side);
+        }
+        same = run_session(state, &params, options.commands, &new_coverage);
+        if (new_coverage) {
+            const unsigned slot = state->corpus_size < CORPUS_CAPACITY
+                                      ? state->corpus_size++
+                                      : random_between(&random, 0, CORPUS_CAPACITY - 1);
+            state->corpus[slot] = params;
+        }
+    }
+
+    // Część cech jest nieosiągalna (np. gamma_move nie wykonuje kosztownych ścieżek),
+    // więc wypisujemy jedynie liczbę osiągniętych.
+    printf("sessions %" PRIu64 " calls %" PRIu64 " features %u corpus %u %s\n",
+           sessions, state->commands, state->covered_count, state->corpus_size,
+           same ? "OK" : "MISMATCH");
+    free(state);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,489 @@
+/** @file
+ * Generator skryptów trybu wsadowego gry gamma.
+ * Na podstawie ziarna i parametrów wypisuje na standardowe wyjście skrypt
+ * zaczynający się od polecenia @p B, po którym następują losowe polecenia
+ * w zadanych proporcjach. Losowanie korzysta wyłącznie z arytmetyki
+ * całkowitoliczbowej, więc te same parametry dają identyczny skrypt niezależnie
+ * od kompilatora i maszyny.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "buffered_io.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/** Identyfikatory poleceń w kolejności, w jakiej podaje się ich wagi. */
+#define COMMANDS "mgbfqp"
+/** Liczba różnych poleceń. */
+#define COMMANDS_COUNT 6
+/** Maksymalna odległość ruchu lokalnego od poprzedniego ruchu gracza. */
+#define LOCALITY_RADIUS 2
+/** Liczba graczy, których ostatnie ruchy są pamiętane; gracze o numerach
+ * przystających modulo ta liczba dzielą wpis. */
+#define LOCALITY_TABLE_SIZE 4096
+/** Liczba zapamiętanych ostatnich ruchów, na które mogą celować złote ruchy. */
+#define RECENT_MOVES 1024
+/** Górne ograniczenie długości jednego wypisywanego wiersza. */
+#define LINE_LENGTH_UPPER_BOUND 64
+
+/** Przełącznik ustawiający ziarno generatora liczb pseudolosowych. */
+#define SEED_OPTION "--seed="
+/** Przełącznik ustawiający szerokość planszy. */
+#define WIDTH_OPTION "--width="
+/** Przełącznik ustawiający wysokość planszy. */
+#define HEIGHT_OPTION "--height="
+/** Przełącznik ustawiający liczbę graczy. */
+#define PLAYERS_OPTION "--players="
+/** Przełącznik ustawiający limit obszarów. */
+#define AREAS_OPTION "--areas="
+/** Przełącznik ustawiający liczbę poleceń po poleceniu @p B. */
+#define LINES_OPTION "--lines="
+/** Przełącznik ustawiający wagi poleceń m, g, b, f, q, p. */
+#define MIX_OPTION "--mix="
+/** Przełącznik ustawiający procent ruchów wykonywanych obok poprzedniego ruchu
+ * tego samego gracza. */
+#define LOCALITY_OPTION "--locality="
+/** Przełącznik ustawiający procent złotych ruchów celujących w niedawno zajęte pole. */
+#define GOLDEN_HITS_OPTION "--golden-hits="
+/** Przełącznik ustawiający procent niepoprawnych wierszy. */
+#define INVALID_OPTION "--invalid="
+
+/** Wzorce niepoprawnych wierszy; %u zastępowane jest losowymi liczbami. */
+static const char *const invalid_lines[] = {
+    "x %u %u %u\n",           // nieznane polecenie
+    "m %u %u\n",              // brakujący argument
+    "m %u %u %u %u\n",        // nadmiarowy argument
+    "m%u %u %u\n",            // brak odstępu po poleceniu
+    "g %u 4294967296 %u\n",   // liczba spoza zakresu
+    "f -%u\n",                // liczba ujemna
+    "q\n",                    // brak argumentów
+    " b %u\n",                // odstęp przed poleceniem
+};
+
+/**
+ * Struktura przechowująca parametry generowanego skryptu.
+ */
+typedef struct generator_options {
+    uint64_t seed;                  /**< Ziarno generatora liczb pseudolosowych. */
+    uint32_t width;                 /**< Szerokość planszy. */
+    uint32_t height;                /**< Wysokość planszy. */
+    uint32_t players;               /**< Liczba graczy. */
+    uint32_t areas;                 /**< Limit obszarów. */
+    uint64_t lines;                 /**< Liczba poleceń po poleceniu @p B. */
+    uint32_t mix[COMMANDS_COUNT];   /**< Wagi poleceń w kolejności @ref COMMANDS. */
+    uint32_t locality;              /**< Procent ruchów lokalnych. */
+    uint32_t golden_hits;           /**< Procent złotych ruchów w zajęte pola. */
+    uint32_t invalid;               /**< Procent niepoprawnych wierszy. */
+} generator_options_t;
+
+/**
+ * Struktura przechowująca pozycję pola.
+ */
+typedef struct position {
+    uint32_t x; /**< Numer kolumny. */
+    uint32_t y; /**< Numer wiersza. */
+} position_t;
+
+/**
+ * Struktura przechowująca stan generatora.
+ */
+typedef struct generator {
+    const generator_options_t *options; /**< Parametry skryptu. */
+    uint64_t random_state;              /**< Stan generatora liczb pseudolosowych. */
+    uint64_t mix_total;                 /**< Suma wag poleceń. */
+    position_t *last_moves;             /**< Ostatnie ruchy graczy. */
+    bool *has_last_move;                /**< Informacja czy gracz wykonał już ruch. */
+    position_t recent_moves[RECENT_MOVES]; /**< Bufor cykliczny ostatnich ruchów. */
+    uint32_t recent_count;              /**< Liczba zapamiętanych ostatnich ruchów. */
+    uint32_t recent_next;               /**< Indeks kolejnego zapisu w buforze. */
+} generator_t;
+
+/** @brief Zwraca kolejną liczbę pseudolosową (splitmix64).
+ * @param[in,out] state   – wskaźnik na stan generatora.
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t next_random(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31u);
+}
+
+/** @brief Losuje liczbę z przedziału [0, @p bound).
+ * @param[in,out] generator – wskaźnik na stan generatora,
+ * @param[in] bound         – górne ograniczenie, liczba dodatnia.
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t random_below(generator_t *generator, uint64_t bound) {
+    return next_random(&generator->random_state) % bound;
+}
+
+/** @brief Losuje zdarzenie zachodzące z zadanym prawdopodobieństwem.
+ * @param[in,out] generator – wskaźnik na stan generatora,
+ * @param[in] percent       – prawdopodobieństwo w procentach.
+ * @return Wartość @p true, jeżeli zdarzenie zaszło, @p false w przeciwnym przypadku.
+ */
+static bool random_chance(generator_t *generator, uint32_t percent) {
+    return random_below(generator, 100) < percent;
+}
+
+/** @brief Losuje numer gracza.
+ * @param[in,out] generator – wskaźnik na stan generatora.
+ * @return Numer gracza od 1 do liczby graczy.
+ */
+static uint32_t random_player(generator_t *generator) {
+    return (uint32_t)random_below(generator, generator->options->players) + 1;
+}
+
+/** @brief Losuje współrzędną w pobliżu zadanej, nie wychodząc poza planszę.
+ * @param[in,out] generator – wskaźnik na stan generatora,
+ * @param[in] center        – współrzędna środka,
+ * @param[in] size          – długość boku planszy w danym wymiarze.
+ * @return Wylosowana współrzędna.
+ */
+static uint32_t random_near(generator_t *generator, uint32_t center, uint32_t size) {
+    const uint64_t low = center > LOCALITY_RADIUS ? center - LOCALITY_RADIUS : 0;
+    const uint64_t high = (uint64_t)center + LOCALITY_RADIUS < size
+                              ? (uint64_t)center + LOCALITY_RADIUS
+                              : (uint64_t)size - 1;
+    return (uint32_t)(low + random_below(generator, high - low + 1));
+}
+
+/** @brief Losuje pole ruchu zwykłego.
+ * Z prawdopodobieństwem zadanym opcją @p locality pole leży w pobliżu poprzedniego
+ * ruchu gracza, w przeciwnym razie jest losowane z całej planszy.
+ * @param[in,out] generator – wskaźnik na stan generatora,
+ * @param[in] player        – numer gracza.
+ * @return Wylosowane pole.
+ */
+static position_t random_move_position(generator_t *generator, uint32_t player) {
+    const generator_options_t *options = generator->options;
+    const uint32_t entry = (player - 1) % LOCALITY_TABLE_SIZE;
+    const position_t *last = &generator->last_moves[entry];
+    position_t position;
+    if (generator->has_last_move[entry] &&
+        random_chance(generator, options->locality)) {
+        position.x = random_near(generator, last->x, options->width);
+        position.y = random_near(generator, last->y, options->height);
+    } else {
+        position.x = (uint32_t)random_below(generator, options->width);
+        position.y = (uint32_t)random_below(generator, options->height);
+    }
+
+    generator->last_moves[entry] = position;
+    generator->has_last_move[entry] = true;
+    generator->recent_moves[generator->recent_next] = position;
+    generator->recent_next = (generator->recent_next + 1) % RECENT_MOVES;
+    if (generator->recent_count < RECENT_MOVES) {
+        generator->recent_count++;
+    }
+    return position;
+}
+
+/** @brief Losuje pole złotego ruchu.
+ * Z prawdopodobieństwem zadanym opcją @p golden_hits jest to jedno z ostatnio
+ * wylosowanych pól ruchów zwykłych, w przeciwnym razie pole z całej planszy.
+ * @param[in,out] generator – wskaźnik na stan generatora.
+ * @return Wylosowane pole.
+ */
+static position_t random_golden_position(generator_t *generator) {
+    if (generator->recent_count > 0 &&
+        random_chance(generator, generator->options->golden_hits)) {
+        const uint64_t index = random_below(generator, generator->recent_count);
+        return generator->recent_moves[index];
+    }
+    position_t position;
+    position.x = (uint32_t)random_below(generator, generator->options->width);
+    position.y = (uint32_t)random_below(generator, generator->options->height);
+    return position;
+}
+
+/** @brief Wypisuje losowy niepoprawny wiersz.
+ * @param[in,out] generator – wskaźnik na stan generatora,
+ * @param[out] line         – bufor, do którego zapisany zostanie wiersz.
+ * @return Długość wiersza.
+ */
+static int generate_invalid_line(generator_t *generator,
+                                 char line[LINE_LENGTH_UPPER_BOUND]) {
+    const char *format =
+        invalid_lines[random_below(generator,
+                                   sizeof(invalid_lines) / sizeof(invalid_lines[0]))];
+    const unsigned a = random_player(generator);
+    const unsigned b = (unsigned)random_below(generator, generator->options->width);
+    const unsigned c = (unsigned)random_below(generator, generator->options->height);
+    const unsigned d = (unsigned)random_below(generator, 10);
+    return snprintf(line, LINE_LENGTH_UPPER_BOUND, format, a, b, c, d);
+}
+
+/** @brief Wypisuje losowe poprawne polecenie.
+ * @param[in,out] generator – wskaźnik na stan generatora,
+ * @param[out] line         – bufor, do którego zapisany zostanie wiersz.
+ * @return Długość wiersza.
+ */
+static int generate_command_line(generator_t *generator,
+                                 char line[LINE_LENGTH_UPPER_BOUND]) {
+    uint64_t choice = random_below(generator, generator->mix_total);
+    unsigned command = 0;
+    while (choice >= generator->options->mix[command]) {
+        choice -= generator->options->mix[command];
+        command++;
+    }
+
+    const uint32_t player = random_player(generator);
+    position_t position;
+    switch (COMMANDS[command]) {
+    case 'm':
+        position = random_move_position(generator, player);
+        return snprintf(line, LINE_LENGTH_UPPER_BOUND, "m %" PRIu32 " %" PRIu32
+                        " %" PRIu32 "\n", player, position.x, position.y);
+    case 'g':
+        position = random_golden_position(generator);
+        return snprintf(line, LINE_LENGTH_UPPER_BOUND, "g %" PRIu32 " %" PRIu32
+                        " %" PRIu32 "\n", player, position.x, position.y);
+    case 'p':
+        return snprintf(line, LINE_LENGTH_UPPER_BOUND, "p\n");
+    default:
+        return snprintf(line, LINE_LENGTH_UPPER_BOUND, "%c %" PRIu32 "\n",
+                        COMMANDS[command], player);
+    }
+}
+
+/** @brief Wypisuje cały skrypt.
+ * @param[in,out] generator – wskaźnik na stan generatora,
+ * @param[in,out] out       – wskaźnik na strukturę wyjścia.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci, @p SYSTEM_ERROR jeżeli zapis się
+ * nie powiódł.
+ */
+static io_error_t generate_script(generator_t *generator, output_buffer_t *out) {
+    const generator_options_t *options = generator->options;
+    char line[LINE_LENGTH_UPPER_BOUND];
+    int length = snprintf(line, sizeof(line), "B %" PRIu32 " %" PRIu32 " %" PRIu32
+                          " %" PRIu32 "\n", options->width, options->height,
+                          options->players, options->areas);
+    io_error_t error = output_buffer_write(out, line, (size_t)length);
+
+    for (uint64_t i = 0; i < options->lines && error == NO_ERROR; i++) {
+        if (random_chance(generator, options->invalid)) {
+            length = generate_invalid_line(generator, line);
+        } else {
+            length = generate_command_line(generator, line);
+        }
+        error = output_buffer_write(out, line, (size_t)length);
+    }
+
+    return error == NO_ERROR ? output_buffer_flush(out) : error;
+}
+
+/** @brief Wczytuje liczbę bez znaku z wartości opcji.
+ * @param[in] text        – tekst liczby,
+ * @param[in] max         – największa dopuszczalna wartość,
+ * @param[out] value      – wskaźnik na komórkę, do której zapisana zostanie liczba,
+ * @param[out] end        – wskaźnik na komórkę, do której zapisany zostanie wskaźnik
+ *                          na pierwszy znak za liczbą lub NULL, jeżeli liczba musi
+ *                          kończyć tekst.
+ * @return Wartość @p true, jeżeli liczba jest poprawna, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_number(const char *text, uint64_t max, uint64_t *value,
+                         const char **end) {
+    char *number_end;
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    errno = 0;
+    unsigned long long number = strtoull(text, &number_end, 10);
+    if (errno == ERANGE || number > max || (end == NULL && *number_end != '\0')) {
+        return false;
+    }
+    *value = number;
+    if (end != NULL) {
+        *end = number_end;
+    }
+    return true;
+}
+
+/** @brief Wczytuje dodatnią liczbę 32-bitową z wartości opcji.
+ * @param[in] text        – tekst liczby,
+ * @param[out] value      – wskaźnik na komórkę, do której zapisana zostanie liczba.
+ * @return Wartość @p true, jeżeli liczba jest poprawna, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_positive_uint32(const char *text, uint32_t *value) {
+    uint64_t number;
+    if (!parse_number(text, UINT32_MAX, &number, NULL) || number == 0) {
+        return false;
+    }
+    *value = (uint32_t)number;
+    return true;
+}
+
+/** @brief Wczytuje procent z wartości opcji.
+ * @param[in] text        – tekst liczby,
+ * @param[out] value      – wskaźnik na komórkę, do której zapisana zostanie liczba.
+ * @return Wartość @p true, jeżeli liczba jest poprawna, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_percent(const char *text, uint32_t *value) {
+    uint64_t number;
+    if (!parse_number(text, 100, &number, NULL)) {
+        return false;
+    }
+    *value = (uint32_t)number;
+    return true;
+}
+
+/** @brief Wczytuje wagi poleceń postaci @p m:g:b:f:q:p.
+ * @param[in] text        – tekst wag,
+ * @param[out] mix        – tablica, do której zapisane zostaną wagi.
+ * @return Wartość @p true, jeżeli wagi są poprawne i nie wszystkie są zerowe,
+ * @p false w przeciwnym przypadku.
+ */
+static bool parse_mix(const char *text, uint32_t mix[COMMANDS_COUNT]) {
+    uint64_t total = 0;
+    for (unsigned i = 0; i < COMMANDS_COUNT; i++) {
+        uint64_t weight;
+        if (!parse_number(text, UINT32_MAX, &weight, &text) ||
+            *text != (i + 1 < COMMANDS_COUNT ? ':' : '\0')) {
+            return false;
+        }
+        text++;
+        mix[i] = (uint32_t)weight;
+        total += weight;
+    }
+    return total > 0;
+}
+
+/** @brief Wczytuje opcje z wiersza poleceń.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów,
+ * @param[out] options    – wskaźnik na strukturę, do której zapisane zostaną opcje.
+ * @return Kod @p NO_ERROR jeżeli opcje są poprawne, @p INVALID_VALUE w przeciwnym
+ * przypadku.
+ */
+static io_error_t parse_options(int argc, char *argv[], generator_options_t *options) {
+    static const uint32_t default_mix[COMMANDS_COUNT] = {85, 5, 3, 3, 4, 0};
+    options->seed = 1;
+    options->width = 1000;
+    options->height = 1000;
+    options->players = 8;
+    options->areas = 4;
+    options->lines = 1000000;
+    memcpy(options->mix, default_mix, sizeof(default_mix));
+    options->locality = 50;
+    options->golden_hits = 50;
+    options->invalid = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool valid;
+        if (strncmp(arg, SEED_OPTION, strlen(SEED_OPTION)) == 0) {
+            valid = parse_number(arg + strlen(SEED_OPTION), UINT64_MAX, &options->seed,
+                                 NULL);
+        } else if (strncmp(arg, WIDTH_OPTION, strlen(WIDTH_OPTION)) == 0) {
+            valid = parse_positive_uint32(arg + strlen(WIDTH_OPTION), &options->width);
+        } else if (strncmp(arg, HEIGHT_OPTION, strlen(HEIGHT_OPTION)) == 0) {
+            valid =
+                parse_positive_uint32(arg + strlen(HEIGHT_OPTION), &options->height);
+        } else if (strncmp(arg, PLAYERS_OPTION, strlen(PLAYERS_OPTION)) == 0) {
+            valid =
+                parse_positive_uint32(arg + strlen(PLAYERS_OPTION), &options->players);
+        } else if (strncmp(arg, AREAS_OPTION, strlen(AREAS_OPTION)) == 0) {
+            valid = parse_positive_uint32(arg + strlen(AREAS_OPTION), &options->areas);
+        } else if (strncmp(arg, LINES_OPTION, strlen(LINES_OPTION)) == 0) {
+            valid = parse_number(arg + strlen(LINES_OPTION), UINT64_MAX,
+                                 &options->lines, NULL);
+        } else if (strncmp(arg, MIX_OPTION, strlen(MIX_OPTION)) == 0) {
+            valid = parse_mix(arg + strlen(MIX_OPTION), options->mix);
+        } else if (strncmp(arg, LOCALITY_OPTION, strlen(LOCALITY_OPTION)) == 0) {
+            valid = parse_percent(arg + strlen(LOCALITY_OPTION), &options->locality);
+        } else if (strncmp(arg, GOLDEN_HITS_OPTION, strlen(GOLDEN_HITS_OPTION)) == 0) {
+            valid = parse_percent(arg + strlen(GOLDEN_HITS_OPTION),
+                                  &options->golden_hits);
+        } else if (strncmp(arg, INVALID_OPTION, strlen(INVALID_OPTION)) == 0) {
+            valid = parse_percent(arg + strlen(INVALID_OPTION), &options->invalid);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return INVALID_VALUE;
+        }
+
+        if (!valid) {
+            fprintf(stderr, "Invalid value in option %s\n", arg);
+            return INVALID_VALUE;
+        }
+    }
+
+    return NO_ERROR;
+}
+
+/** @brief Inicjuje stan generatora.
+ * @param[out] generator  – wskaźnik na inicjowaną strukturę,
+ * @param[in] options     – wskaźnik na parametry skryptu.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci.
+ */
+static io_error_t generator_init(generator_t *generator,
+                                 const generator_options_t *options) {
+    const uint32_t entries =
+        options->players < LOCALITY_TABLE_SIZE ? options->players : LOCALITY_TABLE_SIZE;
+    generator->options = options;
+    generator->random_state = options->seed;
+    generator->mix_total = 0;
+    for (unsigned i = 0; i < COMMANDS_COUNT; i++) {
+        generator->mix_total += options->mix[i];
+    }
+    generator->recent_count = 0;
+    generator->recent_next = 0;
+    generator->last_moves = malloc(entries * sizeof(position_t));
+    generator->has_last_move = calloc(entries, sizeof(bool));
+    if (generator->last_moves == NULL || generator->has_last_move == NULL) {
+        free(generator->last_moves);
+        free(generator->has_last_move);
+        return MEMORY_ERROR;
+    }
+    return NO_ERROR;
+}
+
+/** @brief Zwalnia pamięć zajmowaną przez stan generatora.
+ * @param[in,out] generator – wskaźnik na stan generatora.
+ */
+static void generator_free(generator_t *generator) {
+    free(generator->last_moves);
+    free(generator->has_last_move);
+}
+
+/** @brief Wypisuje skrypt trybu wsadowego o parametrach podanych w wierszu poleceń.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów.
+ * @return Zero, gdy wszystko przebiegło poprawnie, 1 w przeciwnym przypadku.
+ */
+int main(int argc, char *argv[]) {
+    generator_options_t options;
+    if (parse_options(argc, argv, &options) != NO_ERROR) {
+        return 1;
+    }
+
+    generator_t generator;
+    output_buffer_t out;
+    if (generator_init(&generator, &options) != NO_ERROR) {
+        return 1;
+    }
+    if (output_buffer_init_fd(&out, STDOUT_FILENO, BUFFERED_IO_DEFAULT_CAPACITY) !=
+        NO_ERROR) {
+        generator_free(&generator);
+        return 1;
+    }
+
+    io_error_t error = generate_script(&generator, &out);
+    output_buffer_free(&out);
+    generator_free(&generator);
+    return error == NO_ERROR ? 0 : 1;
+}
@@ -8,45 +8,205 @@
 
 #include "batch_mode.h"
 #include "interactive_mode.h"
+#include "server_mode.h"
 #include "text_input_handler.h"
+#include "uring_io.h"
+#include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 /** Wszystkie identyfikatory dozwolonych trybów rozgrywki. */
 #define GAME_MODE_IDENTIFIERS "BI"
+/** Przełącznik uruchamiający tryb serwera. */
+#define SERVER_OPTION "--server="
+/** Przełącznik włączający wejście i wyjście oparte na io_uring. */
+#define IO_URING_OPTION "--io-uring"
+/** Przełącznik wybierający format wyników trybu wsadowego. */
+#define FORMAT_OPTION "--format="
+/** Przełącznik dołączający czas wykonania poleceń do wyników w formacie NDJSON. */
+#define TIMING_OPTION "--timing"
+/** Przełącznik zastępujący wyniki poleceń trybu wsadowego podsumowaniem. */
+#define QUIET_OPTION "--quiet"
+/** Przełącznik włączający histogramy opóźnień poleceń trybu wsadowego; po znaku
+ * = można podać plik, do którego zostaną zapisane percentyle. */
+#define LATENCY_OPTION "--latency"
+/** Przełącznik zapisujący ślad wykonania trybu wsadowego w formacie Chrome Trace
+ * do podanego pliku. */
+#define TRACE_OPTION "--trace="
+/** Przełącznik zapisujący polecenia wykonywane dłużej niż próg do podanego pliku. */
+#define SLOW_LOG_OPTION "--slow-log="
+/** Przełącznik ustawiający próg dziennika wolnych poleceń w mikrosekundach. */
+#define SLOW_THRESHOLD_OPTION "--slow-threshold="
+/** Przełącznik ograniczający pamięć jednej gry; wartość w bajtach może mieć
+ * przyrostek K, M lub G. */
+#define MAX_MEMORY_OPTION "--max-memory="
+/** Przełącznik alokujący planszę z dużych stron pamięci. */
+#define HUGE_PAGES_OPTION "--huge-pages"
+/** Domyślny próg dziennika wolnych poleceń w mikrosekundach. */
+#define DEFAULT_SLOW_THRESHOLD_US 1000
+
+/**
+ * Struktura przechowująca opcje przekazane w wierszu poleceń.
+ */
+typedef struct program_options {
+    const char *server_address; /**< Adres serwera lub NULL, jeżeli gra ma być
+                                 * prowadzona na standardowym wejściu. */
+    bool io_uring; /**< Informacja czy korzystać z wejścia i wyjścia opartego
+                    * na io_uring. */
+    batch_options_t batch; /**< Opcje trybu wsadowego. */
+    const char *latency_file; /**< Plik, do którego zapisane zostaną percentyle
+                               * opóźnień, lub NULL dla standardowego wyjścia
+                               * diagnostycznego. */
+    const char *trace_file; /**< Plik, do którego zapisany zostanie ślad wykonania,
+                             * lub NULL, jeżeli ślad nie jest zapisywany. */
+    const char *slow_log_file; /**< Plik dziennika wolnych poleceń lub NULL,
+                                * jeżeli dziennik nie jest zapisywany. */
+} program_options_t;
+
+/** @brief Wczytuje liczbę mikrosekund i zamienia ją na nanosekundy.
+ * @param[in] text         – tekst liczby,
+ * @param[out] value       – wskaźnik na wczytaną wartość w nanosekundach.
+ * @return Wartość @p true, jeżeli tekst jest poprawną liczbą, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_microseconds(const char *text, uint64_t *value) {
+    char *end;
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    errno = 0;
+    unsigned long long number = strtoull(text, &end, 10);
+    if (errno == ERANGE || *end != '\0' || number > UINT64_MAX / 1000) {
+        return false;
+    }
+    *value = (uint64_t)number * 1000;
+    return true;
+}
+
+/** @brief Wczytuje rozmiar pamięci z opcjonalnym przyrostkiem K, M lub G.
+ * @param[in] text         – tekst rozmiaru,
+ * @param[out] value       – wskaźnik na wczytany rozmiar w bajtach.
+ * @return Wartość @p true, jeżeli tekst jest poprawnym, dodatnim rozmiarem,
+ * @p false w przeciwnym przypadku.
+ */
+static bool parse_memory_size(const char *text, uint64_t *value) {
+    char *end;
+    if (*text < '0' || *text > '9') {
+        return false;
+    }
+    errno = 0;
+    unsigned long long number = strtoull(text, &end, 10);
+    unsigned shift = 0;
+    if (*end == 'K' || *end == 'M' || *end == 'G') {
+        shift = *end == 'K' ? 10 : *end == 'M' ? 20 : 30;
+        end++;
+    }
+    if (errno == ERANGE || *end != '\0' || number == 0 ||
+        number > (UINT64_MAX >> shift)) {
+        return false;
+    }
+    *value = (uint64_t)number << shift;
+    return true;
+}
+
+/** @brief Wczytuje opcje z wiersza poleceń.
+ * @param[in] argc         – liczba argumentów,
+ * @param[in] argv         – tablica argumentów,
+ * @param[out] options     – wskaźnik na strukturę, do której zapisane zostaną opcje.
+ * @return Kod @p NO_ERROR jeżeli opcje są poprawne, @p INVALID_VALUE w przeciwnym
+ * przypadku.
+ */
+static io_error_t parse_program_options(int argc, char *argv[],
+                                        program_options_t *options) {
+    options->server_address = NULL;
+    options->io_uring = false;
+    options->batch.format = BATCH_FORMAT_TEXT;
+    options->batch.timing = false;
+    options->batch.quiet = false;
+    options->batch.latency = false;
+    options->latency_file = NULL;
+    options->trace_file = NULL;
+    options->slow_log_file = NULL;
+    options->batch.slow_threshold_ns = DEFAULT_SLOW_THRESHOLD_US * 1000;
+    options->batch.max_memory = 0;
+    options->batch.huge_pages = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], SERVER_OPTION, strlen(SERVER_OPTION)) == 0) {
+            options->server_address = argv[i] + strlen(SERVER_OPTION);
+        } else if (strcmp(argv[i], IO_URING_OPTION) == 0) {
+            options->io_uring = true;
+        } else if (strcmp(argv[i], FORMAT_OPTION "text") == 0) {
+            options->batch.format = BATCH_FORMAT_TEXT;
+        } else if (strcmp(argv[i], FORMAT_OPTION "ndjson") == 0) {
+            options->batch.format = BATCH_FORMAT_NDJSON;
+        } else if (strcmp(argv[i], TIMING_OPTION) == 0) {
+            options->batch.timing = true;
+        } else if (strcmp(argv[i], QUIET_OPTION) == 0) {
+            options->batch.quiet = true;
+        } else if (strcmp(argv[i], HUGE_PAGES_OPTION) == 0) {
+            options->batch.huge_pages = true;
+        } else if (strcmp(argv[i], LATENCY_OPTION) == 0) {
+            options->batch.latency = true;
+        } else if (strncmp(argv[i], LATENCY_OPTION "=", strlen(LATENCY_OPTION "=")) ==
+                   0) {
+            options->batch.latency = true;
+            options->latency_file = argv[i] + strlen(LATENCY_OPTION "=");
+        } else if (strncmp(argv[i], TRACE_OPTION, strlen(TRACE_OPTION)) == 0) {
+            options->trace_file = argv[i] + strlen(TRACE_OPTION);
+        } else if (strncmp(argv[i], SLOW_LOG_OPTION, strlen(SLOW_LOG_OPTION)) == 0) {
+            options->slow_log_file = argv[i] + strlen(SLOW_LOG_OPTION);
+        } else if (strncmp(argv[i], MAX_MEMORY_OPTION, strlen(MAX_MEMORY_OPTION)) ==
+                   0) {
+            if (!parse_memory_size(argv[i] + strlen(MAX_MEMORY_OPTION),
+                                   &options->batch.max_memory)) {
+                fprintf(stderr, "Invalid value in option %s\n", argv[i]);
+                return INVALID_VALUE;
+            }
+        } else if (strncmp(argv[i], SLOW_THRESHOLD_OPTION,
+                           strlen(SLOW_THRESHOLD_OPTION)) == 0) {
+            if (!parse_microseconds(argv[i] + strlen(SLOW_THRESHOLD_OPTION),
+                                    &options->batch.slow_threshold_ns)) {
+                fprintf(stderr, "Invalid value in option %s\n", argv[i]);
+                return INVALID_VALUE;
+            }
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return INVALID_VALUE;
+        }
+    }
+
+    return NO_ERROR;
+}
 
 /** @brief Wczytuje parametry gry z stdin.
- * Wczytuje wiersze z stdin tak długo aż nie uda się poprawnie utworzyć nowej gry.
- * Aktualizuje numer aktualnego wiersza.
- * @param[out] game        – wskaźnik na zmienną do której zapisany zostanie wskaźnik
- *                           na strukturę przechowującą dane gry.
- * @param[out] mode        – wskaźnik na znak oznaczający tryb gry (B lub I),
- * @param[in,out] line     – wskaźnik na aktualny numer wiersza wejścia.
+ * Wczytuje wiersze z wejścia tak długo aż nie uda się poprawnie utworzyć nowej gry.
+ * Aktualizuje numer aktualnego wiersza i zapisuje utworzoną grę w stanie rozgrywki.
+ * @param[in,out] session  – wskaźnik na stan rozgrywki,
+ * @param[out] mode        – wskaźnik na znak oznaczający tryb gry (B lub I).
  * @return Kod @p NO_ERROR jeżeli wczytane parametry są poprawne,
  * @p ENCOUNTERED_EOF, jeżeli dane na wejściu się skończyły (EOF).
  */
-static io_error_t create_game_struct(gamma_t **game, char *mode, unsigned long *line) {
+static io_error_t create_game_struct(batch_session_t *session, char *mode) {
     io_error_t error;
     uint32_t args[COMMAND_ARGUMENTS_UPPER_BOUND];
     do {
-        (*line)++;
-        error = text_input_read_next_command(mode, args, GAME_MODE_IDENTIFIERS);
+        session->line++;
+        error = text_input_read_next_command(session->in, mode, args,
+                                             GAME_MODE_IDENTIFIERS);
         if (error == NO_ERROR) {
-            if (!gamma_game_new_arguments_valid(args[0], args[1], args[2], args[3])) {
-                error = INVALID_VALUE;
-            } else {
-                *game = gamma_new(args[0], args[1], args[2], args[3]);
-                if (*game == NULL) {
-                    error = MEMORY_ERROR;
-                }
-            }
+            error = batch_create_game(session, args);
         }
         if (error != NO_ERROR) {
             if (error == ENCOUNTERED_EOF) {
                 return ENCOUNTERED_EOF;
             }
             if (error != LINE_IGNORED) {
-                fprintf(stderr, "ERROR %lu\n", *line);
+                batch_report_error(session);
             }
         }
     } while (error != NO_ERROR);
@@ -54,31 +214,127 @@ static io_error_t create_game_struct(gamma_t **game, char *mode, unsigned long *
     return NO_ERROR;
 }
 
+/** @brief Otwiera plik raportów o wydajności.
+ * Istniejący plik jest nadpisywany.
+ * @param[in] path         – ścieżka do pliku,
+ * @param[out] report      – wskaźnik na inicjowane wyjście raportów.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci, @p SYSTEM_ERROR jeżeli nie udało się
+ * otworzyć pliku.
+ */
+static io_error_t open_report_file(const char *path, output_buffer_t *report) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        perror(path);
+        return SYSTEM_ERROR;
+    }
+    io_error_t error = output_buffer_init_fd(report, fd, BUFFERED_IO_DEFAULT_CAPACITY);
+    if (error != NO_ERROR) {
+        close(fd);
+    }
+    return error;
+}
+
+/** @brief Zapisuje pozostałe dane i zamyka plik raportów o wydajności.
+ * @param[in,out] report   – wskaźnik na wyjście raportów.
+ */
+static void close_report_file(output_buffer_t *report) {
+    output_buffer_flush(report);
+    output_buffer_free(report);
+    close(report->fd);
+}
+
 /** @brief Koordynuje przebieg gry gamma.
  * Wczytuje dane gry, tworzy nową grę i uruchamia rozgrywkę w trybie wsadowym
  * lub w trybie interaktywnym. Zwalnia pamięć po zakończeniu rozgrywki.
+ * Z opcją @p --server=adres uruchamia zamiast tego serwer prowadzący wiele gier.
+ * @param[in] argc         – liczba argumentów,
+ * @param[in] argv         – tablica argumentów.
  * @return Zero, gdy wszystko przebiegło poprawnie,
  * a w przeciwnym przypadku kod zakończenia programu jest kodem błędu.
  * Kod 1 oznacza krytyczny błąd - na przykład błąd alokacji pamięci, lub błąd
  * wczytywania danych w trybie interaktywnym.
  */
-int main() {
-    char mode;
-    gamma_t *game = NULL;
-    unsigned long line = 0;
+int main(int argc, char *argv[]) {
+    program_options_t options;
+    if (parse_program_options(argc, argv, &options) != NO_ERROR) {
+        return 1;
+    }
+    if (options.server_address != NULL) {
+        return server_run_mode(options.server_address, &options.batch) == NO_ERROR
+                   ? 0
+                   : 1;
+    }
 
-    io_error_t error = create_game_struct(&game, &mode, &line);
-    if (error != NO_ERROR) {
-        return 0;
+    input_buffer_t in;
+    output_buffer_t out, err;
+    io_error_t (*init_input)(input_buffer_t *, int, size_t) =
+        options.io_uring ? input_buffer_init_uring : input_buffer_init_fd;
+    io_error_t (*init_output)(output_buffer_t *, int, size_t) =
+        options.io_uring ? output_buffer_init_uring : output_buffer_init_fd;
+    if (init_input(&in, STDIN_FILENO, BUFFERED_IO_DEFAULT_CAPACITY) != NO_ERROR) {
+        return 1;
+    }
+    if (init_output(&out, STDOUT_FILENO, BUFFERED_IO_DEFAULT_CAPACITY) != NO_ERROR) {
+        input_buffer_free(&in);
+        return 1;
     }
+    if (output_buffer_init_fd(&err, STDERR_FILENO, BUFFERED_IO_DEFAULT_CAPACITY) !=
+        NO_ERROR) {
+        output_buffer_free(&out);
+        input_buffer_free(&in);
+        return 1;
+    }
+    in.tied_output = &out;
 
-    if (mode == 'B') {
-        batch_run_mode(game, &line);
+    char mode;
+    batch_session_t session;
+    output_buffer_t report, trace, slow_log;
+    io_error_t error = batch_session_init(&session, &in, &out, &err, &options.batch);
+    if (error == NO_ERROR && options.latency_file != NULL) {
+        error = open_report_file(options.latency_file, &report);
+        if (error == NO_ERROR) {
+            session.report = &report;
+        }
+    }
+    if (error == NO_ERROR && options.trace_file != NULL) {
+        error = open_report_file(options.trace_file, &trace);
+        if (error == NO_ERROR) {
+            batch_trace_begin(&session, &trace);
+        }
+    }
+    if (error == NO_ERROR && options.slow_log_file != NULL) {
+        error = open_report_file(options.slow_log_file, &slow_log);
+        if (error == NO_ERROR) {
+            batch_slow_log_begin(&session, &slow_log);
+        }
+    }
+
+    if (error == NO_ERROR && create_game_struct(&session, &mode) == NO_ERROR) {
+        if (mode == 'B') {
+            batch_run_mode(&session);
+        } else {
+            error = interactive_run_mode(session.game, &in, &out);
+        }
     } else {
-        error = interactive_run_mode(game);
+        output_buffer_flush(&out);
     }
 
-    gamma_delete(game);
+    if (session.slow_log == &slow_log) {
+        close_report_file(&slow_log);
+    }
+    if (session.trace == &trace) {
+        batch_trace_end(&session);
+        close_report_file(&trace);
+    }
+    if (session.report == &report) {
+        close_report_file(&report);
+    }
+    batch_session_free(&session);
+    gamma_delete(session.game);
+    output_buffer_free(&err);
+    output_buffer_free(&out);
+    input_buffer_free(&in);
 
     if (error != NO_ERROR) {
         return 1;
@@ -0,0 +1,348 @@
+/** @file
+ * Wzorcowa implementacja gry gamma.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "gamma_reference.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Największa liczba znaków numeru gracza; 10 = ceil(log10(UINT32_MAX)). */
+#define PLAYER_DIGITS_UPPER_BOUND 10
+
+/**
+ * Struktura przechowująca stan gry wzorcowej.
+ */
+struct reference_game {
+    uint32_t width;         /**< Liczba kolumn planszy. */
+    uint32_t height;        /**< Liczba rzędów planszy. */
+    uint32_t players;       /**< Liczba graczy. */
+    uint32_t max_areas;     /**< Maksymalna liczba obszarów jednego gracza. */
+    uint32_t *owners;       /**< Numery graczy zajmujących kolejne pola planszy
+                             * (wierszami) lub 0 dla pól pustych. */
+    bool *golden_move_done; /**< Informacja czy gracz o danym numerze wykonał już
+                             * złoty ruch. */
+    uint32_t *areas;        /**< Liczby obszarów graczy wyznaczone przez ostatnie
+                             * wywołanie @ref count_areas. */
+    bool *visited;          /**< Pola odwiedzone przez @ref count_areas. */
+    uint64_t *stack;        /**< Stos pól do odwiedzenia w @ref count_areas. */
+};
+
+reference_game_t *reference_new(uint32_t width, uint32_t height, uint32_t players,
+                                uint32_t areas) {
+    if (width == 0 || height == 0 || players == 0 || areas == 0) {
+        return NULL;
+    }
+    reference_game_t *game = malloc(sizeof(reference_game_t));
+    if (game == NULL) {
+        return NULL;
+    }
+    const uint64_t fields = (uint64_t)width * height;
+    game->width = width;
+    game->height = height;
+    game->players = players;
+    game->max_areas = areas;
+    game->owners = calloc(fields, sizeof(uint32_t));
+    game->golden_move_done = calloc((uint64_t)players + 1, sizeof(bool));
+    game->areas = calloc((uint64_t)players + 1, sizeof(uint32_t));
+    game->visited = malloc(fields * sizeof(bool));
+    game->stack = malloc(fields * sizeof(uint64_t));
+    if (game->owners == NULL || game->golden_move_done == NULL ||
+        game->areas == NULL || game->visited == NULL || game->stack == NULL) {
+        reference_delete(game);
+        return NULL;
+    }
+    return game;
+}
+
+void reference_delete(reference_game_t *game) {
+    if (game == NULL) {
+        return;
+    }
+    free(game->owners);
+    free(game->golden_move_done);
+    free(game->areas);
+    free(game->visited);
+    free(game->stack);
+    free(game);
+}
+
+/** @brief Zlicza od nowa obszary wszystkich graczy.
+ * Przeszukuje planszę wgłąb od każdego nieodwiedzonego zajętego pola i zapisuje
+ * wyniki w tablicy @p game->areas.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej.
+ */
+static void count_areas(reference_game_t *game) {
+    const uint64_t fields = (uint64_t)game->width * game->height;
+    memset(game->areas, 0, ((uint64_t)game->players + 1) * sizeof(uint32_t));
+    memset(game->visited, 0, fields * sizeof(bool));
+
+    for (uint64_t start = 0; start < fields; start++) {
+        const uint32_t player = game->owners[start];
+        if (player == 0 || game->visited[start]) {
+            continue;
+        }
+        game->areas[player]++;
+        uint64_t stack_size = 0;
+        game->stack[stack_size++] = start;
+        game->visited[start] = true;
+        while (stack_size > 0) {
+            const uint64_t field = game->stack[--stack_size];
+            const uint64_t x = field % game->width, y = field / game->width;
+            const uint64_t neighbors[] = {field - 1, field + 1, field - game->width,
+                                          field + game->width};
+            const bool exists[] = {x > 0, x + 1 < game->width, y > 0,
+                                   y + 1 < game->height};
+            for (unsigned i = 0; i < 4; i++) {
+                if (exists[i] && !game->visited[neighbors[i]] &&
+                    game->owners[neighbors[i]] == player) {
+                    game->visited[neighbors[i]] = true;
+                    game->stack[stack_size++] = neighbors[i];
+                }
+            }
+        }
+    }
+}
+
+/** @brief Sprawdza, czy żaden gracz nie przekracza limitu obszarów.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej.
+ * @return Wartość @p true, jeżeli limit nie jest przekroczony, @p false
+ * w przeciwnym przypadku.
+ */
+static bool areas_within_limit(reference_game_t *game) {
+    count_areas(game);
+    for (uint32_t player = 1; player <= game->players; player++) {
+        if (game->areas[player] > game->max_areas) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Sprawdza poprawność numeru gracza i współrzędnych pola.
+ * @param[in] game     – wskaźnik na stan gry wzorcowej,
+ * @param[in] player   – numer gracza,
+ * @param[in] x        – numer kolumny,
+ * @param[in] y        – numer wiersza.
+ * @return Wartość @p true, jeżeli argumenty są poprawne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool arguments_valid(const reference_game_t *game, uint32_t player, uint32_t x,
+                            uint32_t y) {
+    return game != NULL && player != 0 && player <= game->players && x < game->width &&
+           y < game->height;
+}
+
+bool reference_move(reference_game_t *game, uint32_t player, uint32_t x, uint32_t y) {
+    if (!arguments_valid(game, player, x, y)) {
+        return false;
+    }
+    uint32_t *owner = &game->owners[(uint64_t)y * game->width + x];
+    if (*owner != 0) {
+        return false;
+    }
+    *owner = player;
+    if (!areas_within_limit(game)) {
+        *owner = 0;
+        return false;
+    }
+    return true;
+}
+
+bool reference_golden_move(reference_game_t *game, uint32_t player, uint32_t x,
+                           uint32_t y) {
+    if (!arguments_valid(game, player, x, y) || game->golden_move_done[player]) {
+        return false;
+    }
+    uint32_t *owner = &game->owners[(uint64_t)y * game->width + x];
+    const uint32_t previous_owner = *owner;
+    if (previous_owner == 0 || previous_owner == player) {
+        return false;
+    }
+    *owner = player;
+    if (!areas_within_limit(game)) {
+        *owner = previous_owner;
+        return false;
+    }
+    game->golden_move_done[player] = true;
+    return true;
+}
+
+uint64_t reference_busy_fields(const reference_game_t *game, uint32_t player) {
+    if (game == NULL || player == 0 || player > game->players) {
+        return 0;
+    }
+    uint64_t busy = 0;
+    for (uint64_t i = 0; i < (uint64_t)game->width * game->height; i++) {
+        busy += game->owners[i] == player;
+    }
+    return busy;
+}
+
+uint64_t reference_free_fields(reference_game_t *game, uint32_t player) {
+    if (game == NULL || player == 0 || player > game->players) {
+        return 0;
+    }
+    uint64_t free_fields = 0;
+    for (uint32_t y = 0; y < game->height; y++) {
+        for (uint32_t x = 0; x < game->width; x++) {
+            uint32_t *owner = &game->owners[(uint64_t)y * game->width + x];
+            if (*owner != 0) {
+                continue;
+            }
+            *owner = player;
+            count_areas(game);
+            free_fields += game->areas[player] <= game->max_areas;
+            *owner = 0;
+        }
+    }
+    return free_fields;
+}
+
+bool reference_golden_possible(reference_game_t *game, uint32_t player) {
+    if (game == NULL || player == 0 || player > game->players ||
+        game->golden_move_done[player]) {
+        return false;
+    }
+    for (uint64_t i = 0; i < (uint64_t)game->width * game->height; i++) {
+        const uint32_t previous_owner = game->owners[i];
+        if (previous_owner == 0 || previous_owner == player) {
+            continue;
+        }
+        game->owners[i] = player;
+        const bool possible = areas_within_limit(game);
+        game->owners[i] = previous_owner;
+        if (possible) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Porównuje dwie liczby dla funkcji qsort.
+ * @param[in] a        – wskaźnik na pierwszą liczbę,
+ * @param[in] b        – wskaźnik na drugą liczbę.
+ * @return Liczba ujemna, zero lub dodatnia, gdy pierwsza liczba jest odpowiednio
+ * mniejsza, równa lub większa od drugiej.
+ */
+static int compare_uint64(const void *a, const void *b) {
+    const uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Zapisuje na stosie posortowane numery graczy zajmujących pola.
+ * Każdy numer występuje tyle razy, ile pól zajmuje gracz.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej.
+ * @return Liczba zapisanych numerów.
+ */
+static uint64_t sort_owners(reference_game_t *game) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < (uint64_t)game->width * game->height; i++) {
+        if (game->owners[i] != 0) {
+            game->stack[count++] = game->owners[i];
+        }
+    }
+    qsort(game->stack, count, sizeof(uint64_t), compare_uint64);
+    return count;
+}
+
+uint32_t reference_players_with_fields(reference_game_t *game) {
+    const uint64_t count = sort_owners(game);
+    uint32_t players = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        players += i == 0 || game->stack[i] != game->stack[i - 1];
+    }
+    return players;
+}
+
+uint32_t reference_max_player_with_fields(const reference_game_t *game) {
+    uint32_t max_player = 0;
+    for (uint64_t i = 0; i < (uint64_t)game->width * game->height; i++) {
+        max_player = game->owners[i] > max_player ? game->owners[i] : max_player;
+    }
+    return max_player;
+}
+
+uint32_t reference_leader(reference_game_t *game, uint64_t *busy_fields) {
+    const uint64_t count = sort_owners(game);
+    // Bez zajętych pól remisują wszyscy gracze.
+    uint32_t leader = game->players == 1 ? 1 : 0;
+    *busy_fields = 0;
+    for (uint64_t begin = 0, end; begin < count; begin = end) {
+        end = begin + 1;
+        while (end < count && game->stack[end] == game->stack[begin]) {
+            end++;
+        }
+        if (end - begin > *busy_fields) {
+            *busy_fields = end - begin;
+            leader = (uint32_t)game->stack[begin];
+        } else if (end - begin == *busy_fields) {
+            leader = 0;
+        }
+    }
+    return leader;
+}
+
+/** @brief Zwraca liczbę cyfr liczby nieujemnej.
+ * @param[in] value   – liczba nieujemna.
+ * @return Liczba cyfr.
+ */
+static unsigned digits(uint32_t value) {
+    unsigned count = 1;
+    while (value > 9) {
+        count++;
+        value /= 10;
+    }
+    return count;
+}
+
+char *reference_board(const reference_game_t *game) {
+    if (game == NULL) {
+        return NULL;
+    }
+    // Pola mają szerokość numeru największego gracza obecnego na planszy, a jeżeli
+    // ma on więcej niż jedną cyfrę - o jeden znak więcej. Pierwsza kolumna ma
+    // szerokość numeru największego gracza obecnego w tej kolumnie.
+    uint32_t max_player = 1, max_first_column_player = 1;
+    for (uint32_t y = 0; y < game->height; y++) {
+        for (uint32_t x = 0; x < game->width; x++) {
+            const uint32_t owner = game->owners[(uint64_t)y * game->width + x];
+            max_player = owner > max_player ? owner : max_player;
+            if (x == 0 && owner > max_first_column_player) {
+                max_first_column_player = owner;
+            }
+        }
+    }
+    const unsigned field_width = digits(max_player) == 1 ? 1 : digits(max_player) + 1;
+    const unsigned first_column_width = digits(max_first_column_player);
+
+    const size_t size = (size_t)game->height * ((size_t)game->width *
+                                                    (PLAYER_DIGITS_UPPER_BOUND + 1) +
+                                                1) +
+                        1;
+    char *board = malloc(size);
+    if (board == NULL) {
+        return NULL;
+    }
+    size_t length = 0;
+    for (uint32_t y = game->height; y-- > 0;) {
+        for (uint32_t x = 0; x < game->width; x++) {
+            const uint32_t owner = game->owners[(uint64_t)y * game->width + x];
+            const int width = (int)(x == 0 ? first_column_width : field_width);
+            if (owner == 0) {
+                length += (size_t)snprintf(board + length, size - length, "%*c", width,
+                                           '.');
+            } else {
+                length += (size_t)snprintf(board + length, size - length, "%*u", width,
+                                           owner);
+            }
+        }
+        board[length++] = '\n';
+    }
+    board[length] = '\0';
+    return board;
+}
@@ -0,0 +1,120 @@
+/** @file
+ * Interfejs wzorcowej implementacji gry gamma.
+ * Implementacja jest celowo możliwie prosta: nie przechowuje żadnych struktur
+ * pomocniczych, a legalność każdego ruchu sprawdza, wykonując go na próbę
+ * i zliczając od nowa obszary wszystkich graczy. Służy wyłącznie do porównywania
+ * wyników z silnikiem z pliku gamma.c na małych planszach.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef GAMMA_REFERENCE_H
+#define GAMMA_REFERENCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Struktura przechowująca stan gry wzorcowej.
+ */
+typedef struct reference_game reference_game_t;
+
+/** @brief Tworzy grę wzorcową.
+ * Odpowiada funkcji @ref gamma_new.
+ * @param[in] width   – szerokość planszy,
+ * @param[in] height  – wysokość planszy,
+ * @param[in] players – liczba graczy,
+ * @param[in] areas   – maksymalna liczba obszarów jednego gracza.
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ * zaalokować pamięci lub któryś z parametrów jest niepoprawny.
+ */
+reference_game_t *reference_new(uint32_t width, uint32_t height, uint32_t players,
+                                uint32_t areas);
+
+/** @brief Usuwa grę wzorcową.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] game    – wskaźnik na usuwaną strukturę.
+ */
+void reference_delete(reference_game_t *game);
+
+/** @brief Wykonuje ruch; odpowiada funkcji @ref gamma_move.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej,
+ * @param[in] player   – numer gracza,
+ * @param[in] x        – numer kolumny,
+ * @param[in] y        – numer wiersza.
+ * @return Wartość @p true, jeśli ruch został wykonany, a @p false w przeciwnym
+ * przypadku.
+ */
+bool reference_move(reference_game_t *game, uint32_t player, uint32_t x, uint32_t y);
+
+/** @brief Wykonuje złoty ruch; odpowiada funkcji @ref gamma_golden_move.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej,
+ * @param[in] player   – numer gracza,
+ * @param[in] x        – numer kolumny,
+ * @param[in] y        – numer wiersza.
+ * @return Wartość @p true, jeśli ruch został wykonany, a @p false w przeciwnym
+ * przypadku.
+ */
+bool reference_golden_move(reference_game_t *game, uint32_t player, uint32_t x,
+                           uint32_t y);
+
+/** @brief Podaje liczbę pól zajętych przez gracza; odpowiada
+ * @ref gamma_busy_fields.
+ * @param[in] game     – wskaźnik na stan gry wzorcowej,
+ * @param[in] player   – numer gracza.
+ * @return Liczba pól zajętych przez gracza lub zero, jeśli numer gracza jest
+ * niepoprawny.
+ */
+uint64_t reference_busy_fields(const reference_game_t *game, uint32_t player);
+
+/** @brief Podaje liczbę pól, jakie gracz może zająć w następnym ruchu; odpowiada
+ * @ref gamma_free_fields. Każde puste pole sprawdzane jest ruchem próbnym.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej,
+ * @param[in] player   – numer gracza.
+ * @return Liczba pól lub zero, jeśli numer gracza jest niepoprawny.
+ */
+uint64_t reference_free_fields(reference_game_t *game, uint32_t player);
+
+/** @brief Sprawdza, czy gracz może wykonać złoty ruch; odpowiada
+ * @ref gamma_golden_possible. Każde pole innego gracza sprawdzane jest złotym
+ * ruchem próbnym.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej,
+ * @param[in] player   – numer gracza.
+ * @return Wartość @p true, jeśli istnieje legalny złoty ruch gracza, a @p false
+ * w przeciwnym przypadku.
+ */
+bool reference_golden_possible(reference_game_t *game, uint32_t player);
+
+/** @brief Podaje liczbę graczy zajmujących pola; odpowiada
+ * @ref gamma_players_with_fields.
+ * @param[in,out] game – wskaźnik na stan gry wzorcowej.
+ * @return Liczba graczy.
+ */
+uint32_t reference_players_with_fields(reference_game_t *game);
+
+/** @brief Podaje największy numer gracza zajmującego pole; odpowiada
+ * @ref gamma_max_player_with_fields.
+ * @param[in] game     – wskaźnik na stan gry wzorcowej.
+ * @return Numer gracza lub zero, jeżeli plansza jest pusta.
+ */
+uint32_t reference_max_player_with_fields(const reference_game_t *game);
+
+/** @brief Podaje gracza zajmującego najwięcej pól; odpowiada @ref gamma_leader.
+ * @param[in,out] game     – wskaźnik na stan gry wzorcowej,
+ * @param[out] busy_fields – wskaźnik na komórkę, do której zapisana zostanie
+ *                           największa liczba pól zajętych przez jednego gracza.
+ * @return Numer jedynego gracza zajmującego najwięcej pól lub zero w przypadku
+ * remisu.
+ */
+uint32_t reference_leader(reference_game_t *game, uint64_t *busy_fields);
+
+/** @brief Daje napis opisujący stan planszy; odpowiada @ref gamma_board.
+ * Funkcja wywołująca musi zwolnić zwrócony bufor.
+ * @param[in] game     – wskaźnik na stan gry wzorcowej.
+ * @return Wskaźnik na napis lub NULL, jeśli nie udało się zaalokować pamięci.
+ */
+char *reference_board(const reference_game_t *game);
+
+#endif /* GAMMA_REFERENCE_H */
@@ -0,0 +1,367 @@
+/** @file
+ * Benchmark przepustowości trybu wsadowego programu gamma.
+ * Generuje stały zestaw dużych skryptów programem gamma_generator, uruchamia na
+ * każdym z nich program gamma i mierzy czas działania, liczbę wierszy na sekundę
+ * oraz szczytowe zużycie pamięci. Wyniki porównuje z zapisanymi wcześniej
+ * wynikami bazowymi i kończy się błędem, gdy któryś z nich pogorszył się
+ * o więcej niż zadany próg.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+/** _DEFAULT_SOURCE - wymagane, aby sys/wait.h deklarowało funkcję wait4 */
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Liczba uruchomień programu gamma na każdym skrypcie; liczy się najlepsze. */
+#define REPETITIONS 3
+/** Domyślny dopuszczalny spadek wydajności w procentach. */
+#define DEFAULT_THRESHOLD 30
+/** Maksymalna liczba argumentów przekazywanych do programu gamma_generator. */
+#define GENERATOR_ARGUMENTS_UPPER_BOUND 12
+/** Górne ograniczenie długości nazwy pliku skryptu. */
+#define PATH_LENGTH_UPPER_BOUND 256
+
+/** Przełącznik wskazujący program gamma. */
+#define GAMMA_OPTION "--gamma="
+/** Przełącznik wskazujący program gamma_generator. */
+#define GENERATOR_OPTION "--generator="
+/** Przełącznik wskazujący plik z wynikami bazowymi. */
+#define BASELINE_OPTION "--baseline="
+/** Przełącznik ustawiający dopuszczalny spadek wydajności w procentach. */
+#define THRESHOLD_OPTION "--threshold="
+/** Przełącznik nadpisujący wyniki bazowe bieżącymi wynikami. */
+#define UPDATE_BASELINE_OPTION "--update-baseline"
+
+/**
+ * Struktura opisująca jeden skrypt zestawu.
+ */
+typedef struct corpus_script {
+    const char *name;  /**< Nazwa skryptu, bez białych znaków. */
+    uint64_t lines;    /**< Liczba poleceń po poleceniu @p B. */
+    const char *arguments[GENERATOR_ARGUMENTS_UPPER_BOUND]; /**< Parametry generatora
+                                                             * zakończone NULL. */
+} corpus_script_t;
+
+/** Zestaw skryptów. Zmiana któregokolwiek z nich unieważnia wyniki bazowe. */
+static const corpus_script_t corpus[] = {
+    {"small-mixed", 1000000,
+     {"--seed=1", "--width=100", "--height=100", "--players=4", "--areas=16",
+      "--mix=90:2:2:3:3:0", "--locality=80", NULL}},
+    {"large-moves", 1000000,
+     {"--seed=2", "--width=2000", "--height=2000", "--players=16", "--areas=64",
+      "--mix=95:1:2:2:0:0", "--locality=90", NULL}},
+    {"golden-heavy", 2000000,
+     {"--seed=3", "--width=200", "--height=200", "--players=32", "--areas=8",
+      "--mix=50:40:5:5:0:0", "--golden-hits=90", NULL}},
+    {"invalid-heavy", 1000000,
+     {"--seed=4", "--width=500", "--height=500", "--players=8", "--areas=4",
+      "--mix=85:5:5:5:0:0", "--invalid=50", NULL}},
+};
+
+/** Liczba skryptów w zestawie. */
+#define CORPUS_SIZE (sizeof(corpus) / sizeof(corpus[0]))
+
+/**
+ * Struktura przechowująca opcje benchmarku.
+ */
+typedef struct throughput_options {
+    const char *gamma;     /**< Ścieżka do programu gamma. */
+    const char *generator; /**< Ścieżka do programu gamma_generator. */
+    const char *baseline;  /**< Ścieżka do pliku z wynikami bazowymi. */
+    uint32_t threshold;    /**< Dopuszczalny spadek wydajności w procentach. */
+    bool update_baseline;  /**< Informacja czy nadpisać wyniki bazowe. */
+} throughput_options_t;
+
+/**
+ * Struktura przechowująca wynik pomiaru jednego skryptu.
+ */
+typedef struct throughput_result {
+    double wall_seconds;     /**< Najkrótszy czas działania w sekundach. */
+    double lines_per_second; /**< Liczba wierszy na sekundę w najszybszym
+                              * uruchomieniu. */
+    uint64_t peak_rss_kib;   /**< Największe szczytowe zużycie pamięci w KiB. */
+    bool found;              /**< Informacja czy wynik bazowy istnieje. */
+} throughput_result_t;
+
+/** @brief Zwraca wskazanie zegara monotonicznego.
+ * @return Czas w sekundach liczony od nieokreślonego momentu w przeszłości.
+ */
+static double monotonic_time(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/** @brief Uruchamia program z przekierowanym wejściem i wyjściem.
+ * Standardowe wyjście błędów programu jest przekierowywane do /dev/null.
+ * @param[in] argv        – argumenty programu zakończone NULL, pierwszy to ścieżka,
+ * @param[in] input       – ścieżka do pliku wejściowego lub NULL dla /dev/null,
+ * @param[in] output      – ścieżka do pliku wyjściowego lub NULL dla /dev/null,
+ * @param[out] usage      – wskaźnik na strukturę, do której zapisane zostanie
+ *                          zużycie zasobów przez program.
+ * @return Wartość @p true, jeżeli program zakończył się z kodem 0, @p false
+ * w przeciwnym przypadku.
+ */
+static bool run_program(char *const argv[], const char *input, const char *output,
+                        struct rusage *usage) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return false;
+    }
+    if (pid == 0) {
+        int in = open(input != NULL ? input : "/dev/null", O_RDONLY);
+        int out = open(output != NULL ? output : "/dev/null",
+                       O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        int err = open("/dev/null", O_WRONLY);
+        if (in < 0 || out < 0 || err < 0 || dup2(in, STDIN_FILENO) < 0 ||
+            dup2(out, STDOUT_FILENO) < 0 || dup2(err, STDERR_FILENO) < 0) {
+            _exit(127);
+        }
+        execv(argv[0], argv);
+        _exit(127);
+    }
+
+    int status;
+    while (wait4(pid, &status, 0, usage) < 0) {
+        if (errno != EINTR) {
+            perror("wait4");
+            return false;
+        }
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/** @brief Generuje skrypt zestawu do pliku.
+ * @param[in] script      – wskaźnik na opis skryptu,
+ * @param[in] options     – wskaźnik na opcje benchmarku,
+ * @param[in] path        – ścieżka do pliku skryptu.
+ * @return Wartość @p true, jeżeli skrypt został wygenerowany, @p false
+ * w przeciwnym przypadku.
+ */
+static bool generate_script(const corpus_script_t *script,
+                            const throughput_options_t *options, const char *path) {
+    char lines[32];
+    snprintf(lines, sizeof(lines), "--lines=%" PRIu64, script->lines);
+    char *argv[GENERATOR_ARGUMENTS_UPPER_BOUND + 3];
+    unsigned argc = 0;
+    argv[argc++] = (char *)options->generator;
+    argv[argc++] = lines;
+    for (unsigned i = 0; script->arguments[i] != NULL; i++) {
+        argv[argc++] = (char *)script->arguments[i];
+    }
+    argv[argc] = NULL;
+
+    struct rusage usage;
+    return run_program(argv, NULL, path, &usage);
+}
+
+/** @brief Mierzy przepustowość programu gamma na jednym skrypcie.
+ * @param[in] script      – wskaźnik na opis skryptu,
+ * @param[in] options     – wskaźnik na opcje benchmarku,
+ * @param[out] result     – wskaźnik na strukturę, do której zapisany zostanie wynik.
+ * @return Wartość @p true, jeżeli pomiar się powiódł, @p false w przeciwnym
+ * przypadku.
+ */
+static bool measure_script(const corpus_script_t *script,
+                           const throughput_options_t *options,
+                           throughput_result_t *result) {
+    char path[PATH_LENGTH_UPPER_BOUND];
+    snprintf(path, sizeof(path), "throughput_%s.txt", script->name);
+    if (!generate_script(script, options, path)) {
+        fprintf(stderr, "Could not generate script %s\n", script->name);
+        return false;
+    }
+
+    char *argv[] = {(char *)options->gamma, NULL};
+    result->wall_seconds = 0;
+    result->peak_rss_kib = 0;
+    for (unsigned i = 0; i < REPETITIONS; i++) {
+        struct rusage usage;
+        const double start = monotonic_time();
+        if (!run_program(argv, path, NULL, &usage)) {
+            fprintf(stderr, "gamma failed on script %s\n", script->name);
+            unlink(path);
+            return false;
+        }
+        const double elapsed = monotonic_time() - start;
+        if (i == 0 || elapsed < result->wall_seconds) {
+            result->wall_seconds = elapsed;
+        }
+        if ((uint64_t)usage.ru_maxrss > result->peak_rss_kib) {
+            result->peak_rss_kib = (uint64_t)usage.ru_maxrss;
+        }
+    }
+
+    unlink(path);
+    result->lines_per_second = (double)(script->lines + 1) / result->wall_seconds;
+    return true;
+}
+
+/** @brief Wczytuje wyniki bazowe z pliku.
+ * Plik składa się z wierszy postaci @p nazwa @p wiersze_na_sekundę @p pamięć_KiB;
+ * wiersze zaczynające się od znaku # są pomijane.
+ * @param[in] path        – ścieżka do pliku,
+ * @param[out] baseline   – tablica wyników bazowych dla kolejnych skryptów zestawu.
+ * @return Wartość @p true, jeżeli plik istnieje, @p false w przeciwnym przypadku.
+ */
+static bool read_baseline(const char *path, throughput_result_t baseline[CORPUS_SIZE]) {
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        baseline[i].found = false;
+    }
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    char line[PATH_LENGTH_UPPER_BOUND], name[PATH_LENGTH_UPPER_BOUND];
+    double lines_per_second;
+    uint64_t peak_rss_kib;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#' || sscanf(line, "%255s %lf %" SCNu64, name,
+                                     &lines_per_second, &peak_rss_kib) != 3) {
+            continue;
+        }
+        for (size_t i = 0; i < CORPUS_SIZE; i++) {
+            if (strcmp(name, corpus[i].name) == 0) {
+                baseline[i].lines_per_second = lines_per_second;
+                baseline[i].peak_rss_kib = peak_rss_kib;
+                baseline[i].found = true;
+            }
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+/** @brief Zapisuje wyniki jako nowe wyniki bazowe.
+ * @param[in] path        – ścieżka do pliku,
+ * @param[in] results     – tablica wyników dla kolejnych skryptów zestawu.
+ * @return Wartość @p true, jeżeli zapis się powiódł, @p false w przeciwnym
+ * przypadku.
+ */
+static bool write_baseline(const char *path,
+                           const throughput_result_t results[CORPUS_SIZE]) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+    fprintf(file, "# script lines_per_second peak_rss_kib\n");
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        fprintf(file, "%s %.1f %" PRIu64 "\n", corpus[i].name,
+                results[i].lines_per_second, results[i].peak_rss_kib);
+    }
+    return fclose(file) == 0;
+}
+
+/** @brief Sprawdza, czy wynik mieści się w progu względem wyniku bazowego.
+ * @param[in] result      – wskaźnik na wynik,
+ * @param[in] baseline    – wskaźnik na wynik bazowy,
+ * @param[in] threshold   – dopuszczalny spadek wydajności w procentach.
+ * @return Wartość @p true, jeżeli wynik jest akceptowalny, @p false w przeciwnym
+ * przypadku.
+ */
+static bool within_threshold(const throughput_result_t *result,
+                             const throughput_result_t *baseline, uint32_t threshold) {
+    const double ratio = threshold / 100.0;
+    return result->lines_per_second >= baseline->lines_per_second * (1 - ratio) &&
+           result->peak_rss_kib <= baseline->peak_rss_kib * (1 + ratio);
+}
+
+/** @brief Wczytuje opcje z wiersza poleceń.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów,
+ * @param[out] options    – wskaźnik na strukturę, do której zapisane zostaną opcje.
+ * @return Wartość @p true, jeżeli opcje są poprawne, @p false w przeciwnym
+ * przypadku.
+ */
+static bool parse_options(int argc, char *argv[], throughput_options_t *options) {
+    options->gamma = "./gamma";
+    options->generator = "./gamma_generator";
+    options->baseline = "throughput_baseline.txt";
+    options->threshold = DEFAULT_THRESHOLD;
+    options->update_baseline = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], GAMMA_OPTION, strlen(GAMMA_OPTION)) == 0) {
+            options->gamma = argv[i] + strlen(GAMMA_OPTION);
+        } else if (strncmp(argv[i], GENERATOR_OPTION, strlen(GENERATOR_OPTION)) == 0) {
+            options->generator = argv[i] + strlen(GENERATOR_OPTION);
+        } else if (strncmp(argv[i], BASELINE_OPTION, strlen(BASELINE_OPTION)) == 0) {
+            options->baseline = argv[i] + strlen(BASELINE_OPTION);
+        } else if (strncmp(argv[i], THRESHOLD_OPTION, strlen(THRESHOLD_OPTION)) == 0) {
+            options->threshold = strtoul(argv[i] + strlen(THRESHOLD_OPTION), NULL, 10);
+        } else if (strcmp(argv[i], UPDATE_BASELINE_OPTION) == 0) {
+            options->update_baseline = true;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Uruchamia benchmark przepustowości.
+ * Jeżeli plik z wynikami bazowymi nie istnieje lub podano opcję
+ * @p --update-baseline, zapisuje do niego bieżące wyniki.
+ * @param[in] argc        – liczba argumentów,
+ * @param[in] argv        – tablica argumentów.
+ * @return Zero, gdy wszystkie wyniki mieszczą się w progu, 1 w przeciwnym
+ * przypadku lub gdy pomiar się nie powiódł.
+ */
+int main(int argc, char *argv[]) {
+    throughput_options_t options;
+    if (!parse_options(argc, argv, &options)) {
+        return 1;
+    }
+
+    throughput_result_t results[CORPUS_SIZE], baseline[CORPUS_SIZE];
+    const bool has_baseline = read_baseline(options.baseline, baseline);
+    bool passed = true;
+    printf("%-16s %10s %10s %14s %12s %14s %12s  %s\n", "script", "lines", "wall_s",
+           "lines/s", "peak_rss_kib", "base_lines/s", "base_rss_kib", "status");
+    for (size_t i = 0; i < CORPUS_SIZE; i++) {
+        if (!measure_script(&corpus[i], &options, &results[i])) {
+            return 1;
+        }
+
+        const char *status = "new";
+        if (baseline[i].found && !options.update_baseline) {
+            const bool ok =
+                within_threshold(&results[i], &baseline[i], options.threshold);
+            status = ok ? "ok" : "REGRESSION";
+            passed = passed && ok;
+        }
+        printf("%-16s %10" PRIu64 " %10.3f %14.1f %12" PRIu64 " %14.1f %12" PRIu64
+               "  %s\n",
+               corpus[i].name, corpus[i].lines + 1, results[i].wall_seconds,
+               results[i].lines_per_second, results[i].peak_rss_kib,
+               baseline[i].found ? baseline[i].lines_per_second : 0.0,
+               baseline[i].found ? baseline[i].peak_rss_kib : 0, status);
+        fflush(stdout);
+    }
+
+    if (!has_baseline || options.update_baseline) {
+        if (!write_baseline(options.baseline, results)) {
+            return 1;
+        }
+        printf("Baseline written to %s\n", options.baseline);
+    }
+    return passed ? 0 : 1;
+}
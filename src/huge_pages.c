@@ -0,0 +1,127 @@
+/** @file
+ * Implementacja alokatora gry korzystającego z dużych stron pamięci.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+/** _GNU_SOURCE - wymagane, aby sys/mman.h definiowało MAP_ANONYMOUS, MAP_HUGETLB
+ * i MADV_HUGEPAGE */
+#define _GNU_SOURCE
+
+#include "huge_pages.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+/** @brief Zaokrągla rozmiar w górę do wielokrotności dużej strony.
+ * @param[in] size        – rozmiar w bajtach.
+ * @return Zaokrąglony rozmiar.
+ */
+static inline size_t round_to_huge_pages(size_t size) {
+    return (size + HUGE_PAGE_SIZE - 1) & ~((size_t)HUGE_PAGE_SIZE - 1);
+}
+
+/** @brief Sprawdza, czy blok danego rozmiaru jest mapowany funkcją mmap.
+ * @param[in] size        – rozmiar bloku.
+ * @return Wartość @p true dla bloków mapowanych, @p false dla alokowanych funkcją
+ * malloc.
+ */
+static inline bool is_mapped(size_t size) {
+    return size >= HUGE_PAGE_SIZE;
+}
+
+/** @brief Mapuje pamięć anonimową wyrównaną do dużej strony.
+ * Próbuje kolejno jawnie zarezerwowanych dużych stron i zwykłych stron
+ * z MADV_HUGEPAGE.
+ * @param[in] size        – rozmiar, wielokrotność @ref HUGE_PAGE_SIZE.
+ * @return Wskaźnik na pamięć lub NULL, jeśli nie udało się jej zmapować.
+ */
+static void *map_huge_pages(size_t size) {
+    const int protection = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    int hugetlb_flags = flags | MAP_HUGETLB;
+#ifdef MAP_HUGE_SHIFT
+    // Domyślny rozmiar stron hugetlbfs może wynosić 1 GiB, a zwalniamy pamięć
+    // w wielokrotnościach 2 MiB.
+    hugetlb_flags |= 21 << MAP_HUGE_SHIFT;
+#endif
+    void *pages = mmap(NULL, size, protection, hugetlb_flags, -1, 0);
+    if (pages != MAP_FAILED) {
+        return pages;
+    }
+#endif
+
+    // Mapujemy o jedną dużą stronę więcej i odcinamy niewyrównane końce, aby jądro
+    // mogło pokryć cały blok dużymi stronami.
+    char *raw = mmap(NULL, size + HUGE_PAGE_SIZE, protection, flags, -1, 0);
+    if (raw == MAP_FAILED) {
+        return NULL;
+    }
+    char *aligned = (char *)round_to_huge_pages((uintptr_t)raw);
+    const size_t head = (size_t)(aligned - raw);
+    if (head > 0) {
+        munmap(raw, head);
+    }
+    munmap(aligned + size, HUGE_PAGE_SIZE - head);
+#ifdef MADV_HUGEPAGE
+    // Błąd (np. przezroczyste duże strony wyłączone) oznacza po prostu zwykłe strony.
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    return aligned;
+}
+
+/** @brief Alokuje blok pamięci.
+ * @param[in] context     – nieużywany,
+ * @param[in] size        – rozmiar bloku.
+ * @return Wskaźnik na blok lub NULL, jeśli nie udało się zaalokować pamięci.
+ */
+static void *huge_page_alloc(void *context, size_t size) {
+    (void)context;
+    return is_mapped(size) ? map_huge_pages(round_to_huge_pages(size)) : malloc(size);
+}
+
+/** @brief Zwalnia blok pamięci.
+ * @param[in] context     – nieużywany,
+ * @param[in] ptr         – wskaźnik na blok,
+ * @param[in] size        – rozmiar bloku.
+ */
+static void huge_page_free(void *context, void *ptr, size_t size) {
+    (void)context;
+    if (is_mapped(size)) {
+        munmap(ptr, round_to_huge_pages(size));
+    } else {
+        free(ptr);
+    }
+}
+
+/** @brief Zmienia rozmiar bloku pamięci.
+ * Bloki mapowane są przenoszone do nowego bloku.
+ * @param[in] context     – nieużywany,
+ * @param[in] ptr         – wskaźnik na blok,
+ * @param[in] old_size    – dotychczasowy rozmiar bloku,
+ * @param[in] new_size    – nowy rozmiar bloku.
+ * @return Wskaźnik na blok lub NULL, jeśli nie udało się zaalokować pamięci.
+ */
+static void *huge_page_realloc(void *context, void *ptr, size_t old_size,
+                               size_t new_size) {
+    if (!is_mapped(old_size) && !is_mapped(new_size)) {
+        return realloc(ptr, new_size);
+    }
+    if (is_mapped(old_size) && is_mapped(new_size) &&
+        round_to_huge_pages(old_size) == round_to_huge_pages(new_size)) {
+        return ptr;
+    }
+    void *resized = huge_page_alloc(context, new_size);
+    if (resized != NULL) {
+        memcpy(resized, ptr, old_size < new_size ? old_size : new_size);
+        huge_page_free(context, ptr, old_size);
+    }
+    return resized;
+}
+
+const gamma_allocator_t huge_page_allocator = {huge_page_alloc, huge_page_realloc,
+                                               huge_page_free, NULL};
@@ -0,0 +1,26 @@
+/** @file
+ * Interfejs alokatora gry korzystającego z dużych stron pamięci.
+ * Bloki o rozmiarze co najmniej @ref HUGE_PAGE_SIZE (w praktyce plansza dużej
+ * gry) są mapowane funkcją mmap: najpierw z jawnie zarezerwowanych dużych stron
+ * (hugetlbfs), a gdy ich brak - jako zwykła pamięć anonimowa wyrównana do dużej
+ * strony i oznaczona MADV_HUGEPAGE, aby jądro mogło ją pokryć przezroczystymi
+ * dużymi stronami. Mniejsze bloki alokowane są funkcją malloc.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef HUGE_PAGES_H
+#define HUGE_PAGES_H
+
+#include "gamma.h"
+
+/** Rozmiar dużej strony w bajtach (2 MiB). */
+#define HUGE_PAGE_SIZE (2u << 20u)
+
+/** Alokator do przekazania funkcji @ref gamma_new_ex. Jeżeli duże strony są
+ * niedostępne, alokator po cichu korzysta ze zwykłych stron. */
+extern const gamma_allocator_t huge_page_allocator;
+
+#endif /* HUGE_PAGES_H */
@@ -10,8 +10,11 @@
 #define _GNU_SOURCE
 
 #include "interactive_mode.h"
+#include <errno.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/ioctl.h>
@@ -37,8 +40,8 @@ typedef enum arrow_key_sequence_last_character {
 
 /** ANSI escape code - wyczyszczenie bufora terminala. */
 #define CLEAR_SCREEN "\x1b[2J"
-/** ANSI escape code - przesunięcie kursora na zadaną pozycję. */
-#define MOVE_CURSOR "\x1b[%u;%uH"
+/** ANSI escape code - wyczyszczenie wiersza od kursora do końca. */
+#define CLEAR_LINE "\x1b[K"
 /** ANSI escape code - ukrycie kursora. */
 #define HIDE_CURSOR "\x1b[?25l"
 /** ANSI escape code - przywrócenie widoczności kursora. */
@@ -66,85 +69,504 @@ typedef enum arrow_key_sequence_last_character {
  * 15 > ceil(log10(UINT32_MAX)) = 10 */
 #define FIELD_WIDTH_UPPER_BOUND 15
 
-/** @brief Wypisuje aktualny stan planszy.
+/** Liczba wierszy z informacjami o stanie gry wyświetlanych pod planszą. */
+#define STATUS_LINES 4
+/** Ograniczenie górne długości jednego wiersza z informacjami o stanie gry. */
+#define STATUS_LINE_LENGTH 192
+/** Ograniczenie górne liczby znaków zajmowanych przez jedno pole wraz z kodami
+ * kolorów i przesunięciem kursora. */
+#define RENDERED_FIELD_UPPER_BOUND (FIELD_WIDTH_UPPER_BOUND + 32)
+/** Ograniczenie górne rozmiaru bufora rezerwowanego na jedną klatkę ekranu. */
+#define FRAME_RESERVE_UPPER_BOUND (1u << 24u)
+/** Maksymalna liczba kolumn minimapy. */
+#define MINIMAP_MAX_COLUMNS 32
+/** Minimapa zajmuje co najwyżej tę część szerokości terminala (1/n). */
+#define MINIMAP_WIDTH_DIVISOR 4
+/** Najmniejsza szerokość terminala, przy której wyświetlana jest minimapa. */
+#define MINIMAP_MIN_TERMINAL_WIDTH 40
+/** Liczba kolumn odstępu między planszą a minimapą. */
+#define MINIMAP_GAP 2
+/** Znaki pól minimapy w kolejności rosnącego zapełnienia bloku. */
+#define MINIMAP_FILL_GLYPHS ".:+#@"
+/** Liczba poziomów zapełnienia bloku zajętego przez graczy. */
+#define MINIMAP_FILL_LEVELS 4
+/** ANSI escape code - zmiana koloru tła na szary */
+#define GREY_BACKGROUND "\x1b[100m"
+/** ANSI escape code - początek zmiany koloru tekstu na kolor z palety 256 kolorów */
+#define PALETTE_TEXT_PREFIX "\x1b[38;5;"
+
+/** Liczba wierszy terminala zajmowanych pod planszą - pusty wiersz oraz wiersze
+ * z informacjami o stanie gry. */
+#define ROWS_UNDER_BOARD (STATUS_LINES + 1)
+
+/**
+ * Enum opisujący sposób wyświetlania pola planszy.
+ */
+typedef enum cell_style {
+    CELL_EMPTY,          /**< Pole puste. */
+    CELL_OTHER_PLAYER,   /**< Pole zajęte przez gracza, który nie wykonuje ruchu. */
+    CELL_CURRENT_PLAYER, /**< Pole zajęte przez gracza wykonującego ruch. */
+    CELL_CURSOR,         /**< Pole, na którym znajduje się kursor. */
+} cell_style_t;
+
+/**
+ * Struktura opisująca wyświetlone pole planszy.
+ */
+typedef struct frame_cell {
+    uint32_t player; /**< Numer gracza zajmującego pole lub 0 dla pola pustego. */
+    uint32_t style;  /**< Sposób wyświetlenia pola (@ref cell_style_t). */
+} frame_cell_t;
+
+/**
+ * Struktura przechowująca zawartość ostatnio wyświetlonej klatki ekranu.
+ * Pozwala wypisywać jedynie te pola i wiersze, które zmieniły się od poprzedniej
+ * klatki. Wyświetlany jest jedynie fragment planszy mieszczący się w oknie
+ * terminala, przesuwany tak, aby zawierał pole z kursorem.
+ */
+typedef struct screen {
+    output_buffer_t *out;  /**< Wyjście terminala. */
+    frame_cell_t *cells;   /**< Wyświetlone pola widocznego fragmentu planszy,
+                            * wiersz po wierszu. */
+    bool drawn;            /**< Informacja czy ekran zawiera poprzednią klatkę. */
+    unsigned field_width;  /**< Liczba znaków zajmowanych przez jedno pole. */
+    uint32_t first_column; /**< Numer pierwszej widocznej kolumny planszy. */
+    uint32_t first_row;    /**< Numer najniższego widocznego wiersza planszy. */
+    uint32_t visible_columns; /**< Liczba widocznych kolumn planszy. */
+    uint32_t visible_rows;    /**< Liczba widocznych wierszy planszy. */
+    frame_cell_t *minimap_cells; /**< Wyświetlone pola minimapy, wiersz po wierszu. */
+    uint32_t minimap_block_size; /**< Bok bloku planszy odpowiadającego jednemu polu
+                                  * minimapy lub 0, jeżeli minimapa jest ukryta. */
+    uint32_t minimap_columns;    /**< Liczba kolumn minimapy. */
+    uint32_t minimap_rows;       /**< Liczba wierszy minimapy. */
+    char status[STATUS_LINES][STATUS_LINE_LENGTH]; /**< Wyświetlone wiersze
+                                                    * z informacjami o stanie gry. */
+} screen_t;
+
+/**
+ * Struktura przechowująca wyświetlany stan gracza wykonującego ruch.
+ * Stan wyznaczany jest raz po każdej zmianie planszy lub gracza, dzięki czemu
+ * samo przesuwanie kursora nie wymaga wywoływania funkcji silnika gry.
+ */
+typedef struct player_status {
+    bool valid;             /**< Informacja czy stan został wyznaczony. */
+    uint32_t player;        /**< Numer gracza, którego dotyczy stan. */
+    uint64_t board_version; /**< Wersja planszy, dla której wyznaczono stan. */
+    uint64_t busy_fields;   /**< Wynik @ref gamma_busy_fields. */
+    uint64_t free_fields;   /**< Wynik @ref gamma_free_fields. */
+    bool golden_possible;   /**< Wynik @ref gamma_golden_possible. */
+} player_status_t;
+
+/** Kolory graczy na minimapie (numery kolorów z palety 256 kolorów). */
+static const uint8_t player_colors[] = {196, 46, 33, 226, 201, 51,
+                                        208, 129, 118, 39, 160, 220};
+/** Liczba kolorów graczy na minimapie. */
+#define PLAYER_COLORS_COUNT (sizeof(player_colors) / sizeof(player_colors[0]))
+
+/** Informacja czy rozmiar okna terminala zmienił się od ostatniej klatki. */
+static volatile sig_atomic_t terminal_resized = 0;
+
+/** @brief Obsługuje sygnał SIGWINCH zmiany rozmiaru okna terminala.
+ * @param[in] signal_number   – numer sygnału.
+ */
+static void handle_terminal_resize(int signal_number) {
+    (void)signal_number;
+    terminal_resized = 1;
+}
+
+/** @brief Ustala rozmiar minimapy wyświetlanej obok widocznego fragmentu planszy.
+ * Minimapa wyświetlana jest jedynie wtedy, gdy plansza nie mieści się w oknie
+ * terminala, a okno jest dostatecznie szerokie.
+ * @param[in,out] screen      – wskaźnik na strukturę przechowującą zawartość ekranu,
  * @param[in,out] g           – wskaźnik na strukturę danych gry,
+ * @param[in] terminal_width  – liczba kolumn terminala,
+ * @param[in] board_rows      – liczba wierszy terminala przeznaczonych na planszę.
+ * @return Liczba kolumn terminala zajmowanych przez minimapę wraz z odstępem od
+ * planszy.
+ */
+static uint32_t screen_layout_minimap(screen_t *screen, gamma_t *g,
+                                      uint32_t terminal_width, uint32_t board_rows) {
+    const bool board_fits =
+        (uint64_t)gamma_board_width(g) * screen->field_width <= terminal_width &&
+        gamma_board_height(g) <= board_rows;
+    if (board_fits || terminal_width < MINIMAP_MIN_TERMINAL_WIDTH) {
+        return 0;
+    }
+
+    uint32_t max_columns = terminal_width / MINIMAP_WIDTH_DIVISOR;
+    max_columns = max_columns < MINIMAP_MAX_COLUMNS ? max_columns : MINIMAP_MAX_COLUMNS;
+    uint32_t block_size;
+    if (!gamma_minimap_block_size(g, max_columns, board_rows, &block_size)) {
+        return 0;
+    }
+    screen->minimap_block_size = block_size;
+    screen->minimap_columns =
+        (uint32_t)(((uint64_t)gamma_board_width(g) + block_size - 1) / block_size);
+    screen->minimap_rows =
+        (uint32_t)(((uint64_t)gamma_board_height(g) + block_size - 1) / block_size);
+    return screen->minimap_columns + MINIMAP_GAP;
+}
+
+/** @brief Dopasowuje widoczny fragment planszy do rozmiaru okna terminala.
+ * Jeżeli wyjście nie jest terminalem, widoczna jest cała plansza. Zmienia rozmiar
+ * bufora wyświetlonych pól i wymusza wypisanie całej następnej klatki. Rezerwuje
+ * w buforze wyjścia miejsce na pełną klatkę, tak aby każda klatka była wypisywana
+ * jednym wywołaniem systemowym.
+ * @param[in,out] screen      – wskaźnik na strukturę przechowującą zawartość ekranu,
+ * @param[in,out] g           – wskaźnik na strukturę danych gry.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli wystąpił błąd alokacji pamięci.
+ */
+static io_error_t screen_resize(screen_t *screen, gamma_t *g) {
+    uint32_t columns = gamma_board_width(g), rows = gamma_board_height(g);
+    screen->minimap_block_size = 0;
+    screen->minimap_columns = 0;
+    screen->minimap_rows = 0;
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+        uint32_t terminal_rows = ws.ws_row > ROWS_UNDER_BOARD
+                                     ? ws.ws_row - ROWS_UNDER_BOARD
+                                     : 1;
+        uint32_t minimap_width = screen_layout_minimap(screen, g, ws.ws_col, terminal_rows);
+        uint32_t terminal_columns = (ws.ws_col - minimap_width) / screen->field_width;
+        columns = columns < terminal_columns ? columns : terminal_columns;
+        rows = rows < terminal_rows ? rows : terminal_rows;
+        columns = columns > 0 ? columns : 1;
+    }
+
+    const uint64_t fields = (uint64_t)columns * rows;
+    frame_cell_t *cells = realloc(screen->cells, fields * sizeof(frame_cell_t));
+    if (cells == NULL) {
+        return MEMORY_ERROR;
+    }
+    screen->cells = cells;
+    const uint64_t minimap_fields = (uint64_t)screen->minimap_columns *
+                                    screen->minimap_rows;
+    cells = realloc(screen->minimap_cells,
+                    (minimap_fields > 0 ? minimap_fields : 1) * sizeof(frame_cell_t));
+    if (cells == NULL) {
+        return MEMORY_ERROR;
+    }
+    screen->minimap_cells = cells;
+    screen->visible_columns = columns;
+    screen->visible_rows = rows;
+    screen->drawn = false;
+
+    // Widoczny fragment nie może wychodzić poza planszę.
+    if (screen->first_column > gamma_board_width(g) - columns) {
+        screen->first_column = gamma_board_width(g) - columns;
+    }
+    if (screen->first_row > gamma_board_height(g) - rows) {
+        screen->first_row = gamma_board_height(g) - rows;
+    }
+
+    uint64_t frame_size = (fields + minimap_fields) * RENDERED_FIELD_UPPER_BOUND +
+                          STATUS_LINES * (STATUS_LINE_LENGTH + 16);
+    output_buffer_reserve(screen->out, frame_size < FRAME_RESERVE_UPPER_BOUND
+                                           ? frame_size
+                                           : FRAME_RESERVE_UPPER_BOUND);
+    return NO_ERROR;
+}
+
+/** @brief Inicjuje strukturę przechowującą zawartość ekranu.
+ * @param[out] screen         – wskaźnik na inicjowaną strukturę,
+ * @param[in,out] g           – wskaźnik na strukturę danych gry,
+ * @param[in,out] out         – wskaźnik na bufor wyjścia terminala.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli wystąpił błąd alokacji pamięci.
+ */
+static io_error_t screen_init(screen_t *screen, gamma_t *g, output_buffer_t *out) {
+    screen->out = out;
+    screen->cells = NULL;
+    screen->minimap_cells = NULL;
+    screen->field_width = snprintf(NULL, 0, "%" PRIu32, gamma_players_number(g)) + 1;
+    screen->first_column = 0;
+    screen->first_row = 0;
+    return screen_resize(screen, g);
+}
+
+/** @brief Przesuwa widoczny fragment planszy tak, aby zawierał pole z kursorem.
+ * Fragment przesuwany jest o najmniejszą możliwą liczbę pól.
+ * @param[in,out] screen      – wskaźnik na strukturę przechowującą zawartość ekranu,
+ * @param[in] field_x         – numer kolumny kursora,
+ * @param[in] field_y         – numer wiersza kursora.
+ */
+static void screen_follow_cursor(screen_t *screen, uint32_t field_x, uint32_t field_y) {
+    if (field_x < screen->first_column) {
+        screen->first_column = field_x;
+    } else if (field_x - screen->first_column >= screen->visible_columns) {
+        screen->first_column = field_x - screen->visible_columns + 1;
+    }
+    if (field_y < screen->first_row) {
+        screen->first_row = field_y;
+    } else if (field_y - screen->first_row >= screen->visible_rows) {
+        screen->first_row = field_y - screen->visible_rows + 1;
+    }
+}
+
+/** @brief Zwalnia pamięć zajmowaną przez strukturę przechowującą zawartość ekranu.
+ * @param[in,out] screen      – wskaźnik na strukturę.
+ */
+static void screen_free(screen_t *screen) {
+    free(screen->cells);
+    free(screen->minimap_cells);
+    screen->cells = NULL;
+    screen->minimap_cells = NULL;
+}
+
+/** @brief Zapisuje sekwencję przesuwającą kursor terminala na zadaną pozycję.
+ * @param[in,out] out         – wskaźnik na bufor wyjścia terminala,
+ * @param[in] row             – numer wiersza liczony od 1,
+ * @param[in] column          – numer kolumny liczony od 1.
+ */
+static void write_move_cursor(output_buffer_t *out, uint64_t row, uint64_t column) {
+    output_buffer_write_string(out, "\x1b[");
+    output_buffer_write_uint64(out, row);
+    output_buffer_write_char(out, ';');
+    output_buffer_write_uint64(out, column);
+    output_buffer_write_char(out, 'H');
+}
+
+/** @brief Zapisuje pole planszy wraz z kodami kolorów.
+ * @param[in,out] out         – wskaźnik na bufor wyjścia terminala,
+ * @param[in] field           – znakowa reprezentacja pola,
+ * @param[in] field_length    – długość reprezentacji pola,
+ * @param[in] style           – sposób wyświetlenia pola.
+ */
+static void write_cell(output_buffer_t *out, const char *field, size_t field_length,
+                       cell_style_t style) {
+    if (style == CELL_CURSOR) {
+        output_buffer_write_string(out, WHITE_BACKGROUND BLACK_TEXT);
+    } else if (style == CELL_CURRENT_PLAYER) {
+        output_buffer_write_string(out, GREEN_BACKGROUND BLACK_TEXT);
+    } else if (style == CELL_EMPTY) {
+        output_buffer_write_string(out, YELLOW_TEXT);
+    }
+
+    output_buffer_write(out, field, field_length);
+    if (style != CELL_OTHER_PLAYER) {
+        output_buffer_write_string(out, RESET_COLORS);
+    }
+}
+
+/** @brief Wypisuje widoczne pola planszy, które zmieniły się od poprzedniej klatki.
+ * Kolejne zmienione pola w tym samym wierszu wypisywane są bez przesuwania
+ * kursora. Koszt jest proporcjonalny do rozmiaru widocznego fragmentu planszy.
+ * @param[in,out] screen      – wskaźnik na strukturę przechowującą zawartość ekranu,
+ * @param[in] g               – wskaźnik na strukturę danych gry,
  * @param[in] field_x         – numer kolumny kursora,
  * @param[in] field_y         – numer wiersza kursora,
  * @param[in] player          – numer gracza dokonującego ruch.
  */
-static void board_print(gamma_t *g, uint32_t field_x, uint32_t field_y,
-                        uint32_t player) {
-    const int field_width = snprintf(NULL, 0, "%" PRIu32, gamma_players_number(g)) + 1;
-    const uint32_t board_width = gamma_board_width(g);
-
-    for (uint32_t y = gamma_board_height(g); y-- > 0;) {
-        for (uint32_t x = 0; x < board_width; x++) {
+static void redraw_board(screen_t *screen, const gamma_t *g, uint32_t field_x,
+                         uint32_t field_y, uint32_t player) {
+    const uint32_t end_column = screen->first_column + screen->visible_columns;
+    const uint32_t end_row = screen->first_row + screen->visible_rows;
+
+    frame_cell_t *cell = screen->cells;
+    for (uint32_t y = end_row; y-- > screen->first_row;) {
+        // Kolumna, w której znajduje się kursor terminala, lub 0 jeżeli kursor
+        // znajduje się w innym wierszu.
+        uint64_t terminal_column = 0;
+        for (uint32_t x = screen->first_column; x < end_column; x++, cell++) {
             int written_chars;
             char buffer[FIELD_WIDTH_UPPER_BOUND];
             uint32_t player_number;
-            gamma_render_field(g, buffer, x, y, field_width, &written_chars,
+            gamma_render_field(g, buffer, x, y, screen->field_width, &written_chars,
                                &player_number);
+
+            cell_style_t style = CELL_OTHER_PLAYER;
             if (y == field_y && x == field_x) {
-                printf(WHITE_BACKGROUND BLACK_TEXT "%s" RESET_COLORS, buffer);
+                style = CELL_CURSOR;
             } else if (player_number == player) {
-                printf(GREEN_BACKGROUND BLACK_TEXT "%s" RESET_COLORS, buffer);
+                style = CELL_CURRENT_PLAYER;
             } else if (player_number == 0) {
-                printf(YELLOW_TEXT "%s" RESET_COLORS, buffer);
-            } else {
-                printf("%s", buffer);
+                style = CELL_EMPTY;
+            }
+            if (screen->drawn && cell->player == player_number && cell->style == style) {
+                continue;
+            }
+            cell->player = player_number;
+            cell->style = style;
+
+            const uint64_t column =
+                (uint64_t)(x - screen->first_column) * screen->field_width + 1;
+            if (terminal_column != column) {
+                write_move_cursor(screen->out, end_row - y, column);
+            }
+            write_cell(screen->out, buffer, (size_t)written_chars, style);
+            terminal_column = column + screen->field_width;
+        }
+    }
+}
+
+/** @brief Wyznacza stan gracza, jeżeli zapamiętany stan jest nieaktualny.
+ * @param[in,out] status      – wskaźnik na zapamiętany stan gracza,
+ * @param[in,out] g           – wskaźnik na strukturę danych gry,
+ * @param[in] player          – numer gracza dokonującego ruch,
+ * @param[in] board_version   – liczba zmian planszy od początku rozgrywki.
+ */
+static void update_player_status(player_status_t *status, gamma_t *g, uint32_t player,
+                                 uint64_t board_version) {
+    if (status->valid && status->player == player &&
+        status->board_version == board_version) {
+        return;
+    }
+    status->valid = true;
+    status->player = player;
+    status->board_version = board_version;
+    status->busy_fields = gamma_busy_fields(g, player);
+    status->free_fields = gamma_free_fields(g, player);
+    status->golden_possible = gamma_golden_possible(g, player);
+}
+
+/** @brief Wypisuje pola minimapy, które zmieniły się od poprzedniej klatki.
+ * Każde pole minimapy odpowiada blokowi planszy: znak oznacza stopień zapełnienia
+ * bloku, kolor dominującego gracza, a szare tło bloki widoczne na ekranie.
+ * Koszt jest proporcjonalny do rozmiaru minimapy.
+ * @param[in,out] screen      – wskaźnik na strukturę przechowującą zawartość ekranu,
+ * @param[in] g               – wskaźnik na strukturę danych gry.
+ */
+static void redraw_minimap(screen_t *screen, const gamma_t *g) {
+    const uint32_t block_size = screen->minimap_block_size;
+    const uint64_t first_terminal_column =
+        (uint64_t)screen->visible_columns * screen->field_width + MINIMAP_GAP + 1;
+    const uint64_t viewport_end_column =
+        (uint64_t)screen->first_column + screen->visible_columns;
+    const uint64_t viewport_end_row = (uint64_t)screen->first_row + screen->visible_rows;
+
+    frame_cell_t *cell = screen->minimap_cells;
+    for (uint32_t row = screen->minimap_rows; row-- > 0;) {
+        uint64_t terminal_column = 0;
+        for (uint32_t column = 0; column < screen->minimap_columns; column++, cell++) {
+            gamma_block_summary_t block;
+            gamma_minimap_block(g, block_size, column, row, &block);
+
+            unsigned glyph = 0;
+            if (block.occupied > 0) {
+                glyph = 1 + (unsigned)((block.occupied * MINIMAP_FILL_LEVELS - 1) /
+                                       block.fields);
             }
+            const uint64_t first_x = (uint64_t)column * block_size;
+            const uint64_t first_y = (uint64_t)row * block_size;
+            const bool in_viewport = first_x < viewport_end_column &&
+                                     first_x + block_size > screen->first_column &&
+                                     first_y < viewport_end_row &&
+                                     first_y + block_size > screen->first_row;
+            const uint32_t style = glyph | (uint32_t)in_viewport << 8u;
+            if (screen->drawn && cell->player == block.owner && cell->style == style) {
+                continue;
+            }
+            cell->player = block.owner;
+            cell->style = style;
+
+            output_buffer_t *out = screen->out;
+            if (terminal_column != first_terminal_column + column) {
+                write_move_cursor(out, screen->minimap_rows - row,
+                                  first_terminal_column + column);
+            }
+            if (in_viewport) {
+                output_buffer_write_string(out, GREY_BACKGROUND);
+            }
+            if (block.owner != 0) {
+                output_buffer_write_string(out, PALETTE_TEXT_PREFIX);
+                output_buffer_write_uint64(
+                    out, player_colors[(block.owner - 1) % PLAYER_COLORS_COUNT]);
+                output_buffer_write_char(out, 'm');
+            }
+            output_buffer_write_char(out, MINIMAP_FILL_GLYPHS[glyph]);
+            output_buffer_write_string(out, RESET_COLORS);
+            terminal_column = first_terminal_column + column + 1;
         }
-        printf("\n");
     }
 }
 
 /** @brief Aktualizuje planszę i wyświetlane informacje na ekranie terminala.
- * Czyści aktualny bufor terminala i wypisuje aktualny stan planszy, wiersz
- * zachęcający gracza do dokonania ruchu, oraz ewentualny komunikat błędu.
+ * Wypisuje jedynie zmienione pola planszy oraz zmienione wiersze zachęcające gracza
+ * do dokonania ruchu i zawierające ewentualny komunikat błędu. Cała klatka jest
+ * wysyłana do terminala jednym zapisem.
+ * @param[in,out] screen      – wskaźnik na strukturę przechowującą zawartość ekranu,
  * @param[in,out] g           – wskaźnik na strukturę danych gry,
  * @param[in] field_x         – numer kolumny kursora,
  * @param[in] field_y         – numer wiersza kursora,
- * @param[in] player          – numer gracza dokonującego ruch,
- * @param[out] error_message  – wskaźnik na bufor znakowy zawierający komunikat błędu.
+ * @param[in] status          – wskaźnik na aktualny stan gracza dokonującego ruch,
+ * @param[in] error_message   – wskaźnik na bufor znakowy zawierający komunikat błędu.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p SYSTEM_ERROR
+ * jeżeli zapis do terminala się nie powiódł.
  */
-static void rerender_screen(gamma_t *g, uint32_t field_x, uint32_t field_y,
-                            uint32_t player, char *error_message) {
-    printf(CLEAR_SCREEN);
-    printf(MOVE_CURSOR, 1, 1);
-
-    board_print(g, field_x, field_y, player);
+static io_error_t rerender_screen(screen_t *screen, const gamma_t *g, uint32_t field_x,
+                                  uint32_t field_y, const player_status_t *status,
+                                  const char *error_message) {
+    const uint32_t player = status->player;
+    if (!screen->drawn) {
+        output_buffer_write_string(screen->out, CLEAR_SCREEN);
+    }
+    screen_follow_cursor(screen, field_x, field_y);
+    redraw_board(screen, g, field_x, field_y, player);
+    if (screen->minimap_block_size != 0) {
+        redraw_minimap(screen, g);
+    }
 
-    printf("\nPlayer %" PRIu32 "\n", player);
-    printf("Busy fields %" PRIu64 "\tFree fields %" PRIu64 "\n",
-           gamma_busy_fields(g, player), gamma_free_fields(g, player));
-    if (gamma_golden_possible(g, player)) {
-        printf(GOLDEN_TEXT "Golden move possible" RESET_COLORS);
+    char lines[STATUS_LINES][STATUS_LINE_LENGTH];
+    int length = snprintf(lines[0], STATUS_LINE_LENGTH, "Player %" PRIu32, player);
+    if (screen->visible_columns < gamma_board_width(g) ||
+        screen->visible_rows < gamma_board_height(g)) {
+        snprintf(lines[0] + length, STATUS_LINE_LENGTH - length,
+                 "\tColumns %" PRIu32 "-%" PRIu32 " of %" PRIu32 "\tRows %" PRIu32
+                 "-%" PRIu32 " of %" PRIu32,
+                 screen->first_column, screen->first_column + screen->visible_columns - 1,
+                 gamma_board_width(g), screen->first_row,
+                 screen->first_row + screen->visible_rows - 1, gamma_board_height(g));
     }
+    snprintf(lines[1], STATUS_LINE_LENGTH,
+             "Busy fields %" PRIu64 "\tFree fields %" PRIu64, status->busy_fields,
+             status->free_fields);
+    snprintf(lines[2], STATUS_LINE_LENGTH, "%s",
+             status->golden_possible ? GOLDEN_TEXT "Golden move possible" RESET_COLORS
+                                     : "");
     if (error_message[0] != '\0') {
-        printf(RED_TEXT "\n%s\n" RESET_COLORS, error_message);
+        snprintf(lines[3], STATUS_LINE_LENGTH, RED_TEXT "%s" RESET_COLORS,
+                 error_message);
+    } else {
+        lines[3][0] = '\0';
+    }
+
+    // Pod planszą znajduje się jeden pusty wiersz.
+    const uint64_t first_status_row = (uint64_t)screen->visible_rows + 2;
+    for (unsigned i = 0; i < STATUS_LINES; i++) {
+        if (screen->drawn && strcmp(screen->status[i], lines[i]) == 0) {
+            continue;
+        }
+        strcpy(screen->status[i], lines[i]);
+        write_move_cursor(screen->out, first_status_row + i, 1);
+        output_buffer_write_string(screen->out, lines[i]);
+        output_buffer_write_string(screen->out, CLEAR_LINE);
     }
+
+    screen->drawn = true;
+    return output_buffer_flush(screen->out);
 }
 
 /** @brief Przesuwa kursor na podstawie wciśniętego klawisza strzałki.
  * Jeżeli niemożliwe jest wczytanie pełnej sekwencji strzałki, początkowe znaki zostaną
  * zignorowane.
+ * @param[in,out] in          – wskaźnik na strukturę wejścia,
  * @param[in] g               – wskaźnik na strukturę danych gry,
  * @param[in,out] field_x     – wskaźnik na numer kolumny kursora,
  * @param[in,out] field_y     – wskaźnik na numer wiersza kursora.
  */
-static inline void respond_to_arrow_key(const gamma_t *g, uint32_t *field_x,
-                                        uint32_t *field_y) {
+static inline void respond_to_arrow_key(input_buffer_t *in, const gamma_t *g,
+                                        uint32_t *field_x, uint32_t *field_y) {
     // Sekwencja strzałki to 3 znaki ESC [ ARROW_UP|ARROW_DOWN|ARROW_RIGHT|ARROW_LEFT
     int key;
-    if ((key = getchar()) != ESCAPE) {
-        ungetc(key, stdin);
+    if ((key = input_buffer_getc(in)) != ESCAPE) {
+        input_buffer_ungetc(in, key);
         return;
     }
-    if ((key = getchar()) != OPENING_SQUARE_BRACKET) {
-        ungetc(key, stdin);
+    if ((key = input_buffer_getc(in)) != OPENING_SQUARE_BRACKET) {
+        input_buffer_ungetc(in, key);
         return;
     }
-    key = getchar();
+    key = input_buffer_getc(in);
     if (key == ARROW_UP) {
         *field_y = *field_y + 1 < gamma_board_height(g) ? *field_y + 1 : *field_y;
     } else if (key == ARROW_DOWN) {
@@ -154,12 +576,13 @@ static inline void respond_to_arrow_key(const gamma_t *g, uint32_t *field_x,
     } else if (key == ARROW_LEFT) {
         *field_x = *field_x > 0 ? *field_x - 1 : 0;
     } else {
-        ungetc(key, stdin);
+        input_buffer_ungetc(in, key);
     }
 }
 
 /** @brief Reaguje na działanie użytkownika.
  * Wykonuje odpowiednią akcję na podstawie klawisza wciśniętego przez gracza.
+ * @param[in,out] in          – wskaźnik na strukturę wejścia,
  * @param[in] key             – kod znaku odpowiadającego wciśniętemu klawiszowi,
  * @param[in,out] game        – wskaźnik na strukturę danych gry,
  * @param[in,out] field_x     – wskaźnik na numer kolumny kursora,
@@ -167,19 +590,24 @@ static inline void respond_to_arrow_key(const gamma_t *g, uint32_t *field_x,
  * @param[in] player          – numer gracza dokonującego ruch,
  * @param[out] advance_player – wskaźnik na wartość logiczną oznaczającą, czy należy
  *                              przesunąć kolejkę na następnego gracza,
+ * @param[out] board_changed  – wskaźnik na wartość logiczną oznaczającą, czy
+ *                              zmienił się stan planszy,
  * @param[out] error_message  – wskaźnik na bufor znakowy, do którego zapisany może
  *                              zostać ewentualny kod błędu; bufor musi być odpowiednio
  *                              duży, aby pomieścić cały komunikat.
  */
-static void respond_to_key(char key, gamma_t *game, uint32_t *field_x,
-                           uint32_t *field_y, uint32_t player, bool *advance_player,
+static void respond_to_key(input_buffer_t *in, char key, gamma_t *game,
+                           uint32_t *field_x, uint32_t *field_y, uint32_t player,
+                           bool *advance_player, bool *board_changed,
                            char *error_message) {
     *advance_player = false;
+    *board_changed = false;
     error_message[0] = '\0';
     if (key == ' ') {
         bool success = gamma_move(game, player, *field_x, *field_y);
         if (success) {
             *advance_player = true;
+            *board_changed = true;
         } else {
             sprintf(error_message, "Can't make this move.");
         }
@@ -189,17 +617,54 @@ static void respond_to_key(char key, gamma_t *game, uint32_t *field_x,
         bool success = gamma_golden_move(game, player, *field_x, *field_y);
         if (success) {
             *advance_player = true;
+            *board_changed = true;
         } else {
             sprintf(error_message, "Can't make this golden move.");
         }
     } else if (key == ESCAPE) {
-        ungetc(key, stdin);
-        respond_to_arrow_key(game, field_x, field_y);
+        input_buffer_ungetc(in, key);
+        respond_to_arrow_key(in, game, field_x, field_y);
     }
 }
 
+/** @brief Sprawdza, czy gracz może wykonać złoty ruch.
+ * Przy pierwszym wywołaniu dla danego stanu gry wyznacza jednym przejściem planszy
+ * wyniki wszystkich graczy i zapisuje je w @p possible. Tablica nie jest alokowana,
+ * gdy graczy jest więcej niż @ref GAMMA_DENSE_PLAYERS_LIMIT, a wtedy lub gdy
+ * alokacja się nie powiedzie wynik wyznaczany jest funkcją
+ * @ref gamma_golden_possible.
+ * @param[in] g             – wskaźnik na strukturę danych gry,
+ * @param[in] player        – numer gracza,
+ * @param[in,out] possible  – wskaźnik na wskaźnik na tablicę wyników lub NULL,
+ *                            jeżeli nie została jeszcze wyznaczona,
+ * @param[in,out] computed  – wskaźnik na znacznik, czy próbowano już wyznaczyć
+ *                            tablicę wyników.
+ * @return Wartość logiczną @p true, jeżeli gracz może wykonać złoty ruch, @p false
+ * w przeciwnym przypadku.
+ */
+static bool cached_golden_possible(gamma_t *g, uint32_t player, bool **possible,
+                                   bool *computed) {
+    if (!*computed) {
+        *computed = true;
+        const uint32_t players = gamma_players_number(g);
+        if (players <= GAMMA_DENSE_PLAYERS_LIMIT) {
+            *possible = malloc((size_t)players * sizeof(bool));
+            if (*possible != NULL && !gamma_golden_possible_all(g, *possible)) {
+                free(*possible);
+                *possible = NULL;
+            }
+        }
+    }
+    if (*possible != NULL) {
+        return (*possible)[player - 1];
+    }
+    return gamma_golden_possible(g, player);
+}
+
 /** @brief Wyznacza następnego w kolejności gracza, który może dokonać ruchu.
  * Przesuwa kolejkę na następnego w kolejności gracza, który może dokonać ruchu.
+ * Możliwość złotego ruchu sprawdzana jest tylko dla graczy bez wolnych pól, a dla
+ * wszystkich graczy wyznaczana jest co najwyżej jednym przejściem planszy.
  * Jeżeli żaden gracz nie może dokonać ruchu zwraca wartość @p false, a wartość
  * wskaźnika jest niezdefiniowana.
  * @param[in] g             – wskaźnik na strukturę danych gry,
@@ -208,56 +673,96 @@ static void respond_to_key(char key, gamma_t *game, uint32_t *field_x,
  * @return Wartość logiczną @p true, jeżeli znaleziono następnego gracza, lub
  * @p false, jeżeli żaden gracz nie może dokonać ruchu i należy zakończyć grę.
  */
-static inline bool advance_player_number(gamma_t *g, uint32_t *player) {
+static bool advance_player_number(gamma_t *g, uint32_t *player) {
     const uint32_t players = gamma_players_number(g);
-    uint32_t next_player = (*player % players) + 1;
-    const uint32_t next_player_guard = next_player;
+    uint32_t next_player = *player;
+    bool *golden_possible = NULL;
+    bool golden_computed = false;
+    bool found = false;
 
-    if (gamma_free_fields(g, next_player) != 0 ||
-        gamma_golden_possible(g, next_player)) {
-        *player = next_player;
-        return true;
-    }
     do {
         next_player = (next_player % players) + 1;
         if (gamma_free_fields(g, next_player) != 0 ||
-            gamma_golden_possible(g, next_player)) {
+            cached_golden_possible(g, next_player, &golden_possible,
+                                   &golden_computed)) {
             *player = next_player;
-            return true;
+            found = true;
+            break;
         }
-    } while (next_player != next_player_guard);
+    } while (next_player != *player);
 
-    // Żaden gracz nie może wykonać już ruchu.
-    return false;
+    free(golden_possible);
+    // Wartość false oznacza, że żaden gracz nie może wykonać już ruchu.
+    return found;
+}
+
+/** @brief Czeka na dane na wejściu lub na sygnał.
+ * Sygnały zablokowane w wątku są odblokowywane wyłącznie na czas oczekiwania, dzięki
+ * czemu sygnał zmiany rozmiaru okna nie zostanie pominięty.
+ * @param[in] in              – wskaźnik na strukturę wejścia,
+ * @param[in] wait_mask       – maska sygnałów obowiązująca podczas oczekiwania.
+ * @return Wartość @p false, jeżeli oczekiwanie zostało przerwane przez sygnał,
+ * @p true w przeciwnym przypadku.
+ */
+static bool wait_for_input(const input_buffer_t *in, const sigset_t *wait_mask) {
+    if (input_buffer_has_buffered_data(in)) {
+        return true;
+    }
+    struct pollfd pfd = {.fd = in->fd, .events = POLLIN};
+    return ppoll(&pfd, 1, NULL, wait_mask) >= 0 || errno != EINTR;
 }
 
 /** @brief Wczytuje ruchy użytkownika, reaguje na nie i aktualizuje planszę.
  * Funkcja kończy się gdy zakończą się dane na wejściu, napotkany zostanie symbol
  * kończący rozgrywkę, lub gdy żaden z graczy nie może wykonać już ruchu.
+ * @param[in,out] in          – wskaźnik na strukturę wejścia,
+ * @param[in,out] screen      – wskaźnik na strukturę przechowującą zawartość ekranu,
  * @param[in,out] g           – wskaźnik na strukturę danych gry,
  * @param[out] error_message  – wskaźnik na bufor znakowy, do którego zapisywane będą
- *                              zostać ewentualne komunikaty błędów.
+ *                              zostać ewentualne komunikaty błędów,
+ * @param[in] wait_mask       – maska sygnałów obowiązująca podczas oczekiwania na
+ *                              klawisz.
  * @return Kod @p NO_ERROR jeżeli gra została zakończona poprawnie, @p ENCOUNTERED_EOF
- * jeżeli wejście zostało zamknięte przed poprawnym zakończeniem gry.
+ * jeżeli wejście zostało zamknięte przed poprawnym zakończeniem gry, @p SYSTEM_ERROR
+ * jeżeli zapis do terminala się nie powiódł, @p MEMORY_ERROR jeżeli wystąpił błąd
+ * alokacji pamięci.
  */
-static io_error_t run_io_loop(gamma_t *g, char *error_message) {
+static io_error_t run_io_loop(input_buffer_t *in, screen_t *screen, gamma_t *g,
+                              char *error_message, const sigset_t *wait_mask) {
     uint32_t field_x = (gamma_board_width(g) - 1) / 2,
              field_y = (gamma_board_height(g) - 1) / 2;
     uint32_t current_player = 1;
+    uint64_t board_version = 0;
+    player_status_t status = {.valid = false};
 
     while (true) {
-        rerender_screen(g, field_x, field_y, current_player, error_message);
+        io_error_t error = NO_ERROR;
+        if (terminal_resized) {
+            terminal_resized = 0;
+            error = screen_resize(screen, g);
+        }
+        if (error == NO_ERROR) {
+            update_player_status(&status, g, current_player, board_version);
+            error = rerender_screen(screen, g, field_x, field_y, &status, error_message);
+        }
+        if (error != NO_ERROR) {
+            return error;
+        }
+        if (!wait_for_input(in, wait_mask)) {
+            continue;
+        }
 
-        int c = getchar();
+        int c = input_buffer_getc(in);
         if (c == END_OF_TRANSMISSION) {
             return NO_ERROR;
         } else if (c == EOF) {
             return ENCOUNTERED_EOF;
         }
 
-        bool advance_player;
-        respond_to_key((char)c, g, &field_x, &field_y, current_player, &advance_player,
-                       error_message);
+        bool advance_player, board_changed;
+        respond_to_key(in, (char)c, g, &field_x, &field_y, current_player,
+                       &advance_player, &board_changed, error_message);
+        board_version += board_changed;
         if (advance_player) {
             bool game_continues = advance_player_number(g, &current_player);
             if (!game_continues) {
@@ -267,52 +772,19 @@ static io_error_t run_io_loop(gamma_t *g, char *error_message) {
     }
 }
 
-/** @brief Ustawia komunikat błędu jeżeli okno terminala jest zbyt małe.
- * Jeżeli rozmiar okna terminala jest zbyt mały, aby poprawnie wyświetlić cały
- * interfejs zapisuje do bufora komunikat ostrzeżenia.
- * @param[out] error_message  – wskaźnik na bufor znakowy, do którego zapisany zostanie
- *                              ewentualny komunikat błędu,
- * @param[in] game            – wskaźnik na strukturę przechowującą stan gry.
- * Kod @p NO_ERROR jeżeli okno jest dostatecznie duże, @p TERMINAL_ERROR
- * jeżeli wywołanie systemowe zakończyło się błędem lub terminal jest zbyt mały.
- */
-static inline io_error_t check_if_terminal_window_is_big_enough(char *error_message,
-                                                                const gamma_t *game) {
-    struct winsize ws;
-    int error = ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws);
-    if (error != 0) {
-        return TERMINAL_ERROR;
-    }
-    static unsigned const extra_rows_under_board = 4;
-    const unsigned board_field_width =
-        snprintf(NULL, 0, "%" PRIu32, gamma_players_number(game)) + 1;
-    if (ws.ws_row < gamma_board_height(game) + extra_rows_under_board ||
-        ws.ws_col < gamma_board_width(game) * board_field_width) {
-        sprintf(error_message, "Terminal size is too small to display the "
-                               "whole board.");
-        return TERMINAL_ERROR;
-    }
-
-    return NO_ERROR;
-}
-
 /** @brief Dostosowuje ustawienia terminala do wymagań trybu interaktywnego.
- * Jeżeli rozmiar okna terminala jest zbyt mały, aby poprawnie wyświetlić cały
- * interfejs zapisuje do bufora komunikat ostrzeżenia.
  * Jeżeli stdin nie jest podłączony do interaktywnego terminala, struktury old i new
  * nie zostaną uzupełnione danymi.
  * @param[out] old            – wskaźnik na strukturę, w której zapisane zostaną
  *                              oryginalne ustawienia terminala,
  * @param[out] new            – wskaźnik na strukturę, w której zapisane zostaną nowe
  *                              ustawienia terminala,
- * @param[out] error_message  – wskaźnik na bufor znakowy, do którego zapisany zostanie
- *                              ewentualny komunikat błędu,
- * @param[in] game            – wskaźnik na strukturę przechowującą stan gry.
+ * @param[in,out] out         – wskaźnik na bufor wyjścia terminala.
  * Kod @p NO_ERROR operacja została wykonana pomyślnie, @p TERMINAL_ERROR
  * jeżeli wywołanie systemowe zakończyło się błędem.
  */
 static io_error_t adjust_terminal_settings(struct termios *old, struct termios *new,
-                                           char *error_message, const gamma_t *game) {
+                                           output_buffer_t *out) {
     bool is_interactive_terminal = isatty(fileno(stdin)) == 1;
     if (is_interactive_terminal) {
         int error = tcgetattr(STDIN_FILENO, old);
@@ -328,12 +800,7 @@ static io_error_t adjust_terminal_settings(struct termios *old, struct termios *
         }
     }
 
-    printf(SET_ALTERNATIVE_BUFFER CLEAR_SCREEN HIDE_CURSOR);
-
-    if (is_interactive_terminal) {
-        return check_if_terminal_window_is_big_enough(error_message, game);
-    }
-
+    output_buffer_write_string(out, SET_ALTERNATIVE_BUFFER CLEAR_SCREEN HIDE_CURSOR);
     return NO_ERROR;
 }
 
@@ -341,11 +808,13 @@ static io_error_t adjust_terminal_settings(struct termios *old, struct termios *
  * Jeżeli stdin nie jest podłączony do interaktywnego terminala, funkcja nie zmienia
  * ustawień terminala.
  * @param[in] old          – wskaźnik na strukturę przechowującą oryginalne
- *                           ustawienia terminala.
+ *                           ustawienia terminala,
+ * @param[in,out] out      – wskaźnik na bufor wyjścia terminala.
  * Kod @p NO_ERROR operacja została wykonana pomyślnie, @p TERMINAL_ERROR
  * jeżeli wywołanie systemowe zakończyło się błędem.
  */
-static inline io_error_t restore_terminal_settings(struct termios *old) {
+static inline io_error_t restore_terminal_settings(struct termios *old,
+                                                   output_buffer_t *out) {
     bool is_interactive_terminal = isatty(fileno(stdin)) == 1;
     if (is_interactive_terminal) {
         int error = tcsetattr(STDIN_FILENO, TCSANOW, old);
@@ -354,84 +823,103 @@ static inline io_error_t restore_terminal_settings(struct termios *old) {
         }
     }
 
-    printf(CLEAR_SCREEN SET_NORMAL_BUFFER SHOW_CURSOR);
+    output_buffer_write_string(out, CLEAR_SCREEN SET_NORMAL_BUFFER SHOW_CURSOR);
     return NO_ERROR;
 }
 
 /** @brief Wyświetla informację o zwycięzcy gry lub o remisie.
- * @param[in] g          – wskaźnik na strukturę danych gry.
+ * @param[in] g          – wskaźnik na strukturę danych gry,
+ * @param[in,out] out    – wskaźnik na bufor wyjścia.
  */
-static inline void print_game_winner(gamma_t *g) {
-    uint32_t players_count = gamma_players_number(g);
-
-    uint32_t winner = 1;
-    uint64_t winner_fields = gamma_busy_fields(g, 1);
-    bool sole_winner = true;
-    for (uint32_t p = 1; p++ < players_count;) {
-        uint32_t player_fields = gamma_busy_fields(g, p);
-        if (player_fields > winner_fields) {
-            winner = p;
-            winner_fields = player_fields;
-            sole_winner = true;
-        } else if (player_fields == winner_fields) {
-            sole_winner = false;
-        }
-    }
+static inline void print_game_winner(gamma_t *g, output_buffer_t *out) {
+    uint64_t winner_fields;
+    const uint32_t winner = gamma_leader(g, &winner_fields);
 
-    if (!sole_winner) {
-        printf("\nThe game ended in a tie.\n\n");
+    if (winner == 0) {
+        output_buffer_write_string(out, "\nThe game ended in a tie.\n\n");
     } else {
-        printf("\nPlayer %" PRIu32 " wins the game with %" PRIu64 " fields.\n\n",
-               winner, winner_fields);
+        output_buffer_write_string(out, "\nPlayer ");
+        output_buffer_write_uint64(out, winner);
+        output_buffer_write_string(out, " wins the game with ");
+        output_buffer_write_uint64(out, winner_fields);
+        output_buffer_write_string(out, " fields.\n\n");
     }
 }
 
 /** @brief Wyświetla planszę, statystyki graczy oraz informację o zwycięzcy.
- * @param[in] g          – wskaźnik na strukturę danych gry.
+ * @param[in] g          – wskaźnik na strukturę danych gry,
+ * @param[in,out] out    – wskaźnik na bufor wyjścia.
  * @return Kod @p MEMORY_ERROR, jeżeli wystąpił błąd alokacji pamięci, @p NO_ERROR
  * w przeciwnym przypadku.
  */
-static inline io_error_t print_game_summary(gamma_t *g) {
+static inline io_error_t print_game_summary(gamma_t *g, output_buffer_t *out) {
     char *rendered_board = gamma_board(g);
     if (rendered_board == NULL) {
         return MEMORY_ERROR;
     }
-    printf("\n%s\n", rendered_board);
-    free(rendered_board);
+    output_buffer_write_char(out, '\n');
+    output_buffer_write_string(out, rendered_board);
+    output_buffer_write_char(out, '\n');
+    gamma_board_free(g, rendered_board);
 
     uint32_t players_count = gamma_players_number(g);
     for (uint32_t p = 0; p++ < players_count;) {
-        uint64_t player_points = gamma_busy_fields(g, p);
-        printf("Player %" PRIu32 ",\tbusy fields %" PRIu64 "\n", p, player_points);
+        output_buffer_write_string(out, "Player ");
+        output_buffer_write_uint64(out, p);
+        output_buffer_write_string(out, ",\tbusy fields ");
+        output_buffer_write_uint64(out, gamma_busy_fields(g, p));
+        output_buffer_write_char(out, '\n');
     }
 
-    print_game_winner(g);
+    print_game_winner(g, out);
     return NO_ERROR;
 }
 
-io_error_t interactive_run_mode(gamma_t *g) {
+io_error_t interactive_run_mode(gamma_t *g, input_buffer_t *in, output_buffer_t *out) {
     struct termios old_settings, new_settings;
     memset(&old_settings, 0, sizeof(struct termios));
     static char error_message[100];
     error_message[0] = '\0';
 
-    io_error_t error =
-        adjust_terminal_settings(&old_settings, &new_settings, error_message, g);
+    screen_t screen;
+    if (screen_init(&screen, g, out) != NO_ERROR) {
+        screen_free(&screen);
+        return MEMORY_ERROR;
+    }
+
+    io_error_t error = adjust_terminal_settings(&old_settings, &new_settings, out);
     if (error == TERMINAL_ERROR) {
-        restore_terminal_settings(&old_settings);
-        if (error_message[0] != '\0') {
-            printf(RED_TEXT "%s\n" RESET_COLORS, error_message);
-        }
+        restore_terminal_settings(&old_settings, out);
+        screen_free(&screen);
+        output_buffer_flush(out);
         return TERMINAL_ERROR;
     }
 
-    error = run_io_loop(g, error_message);
-
-    io_error_t cleanup_error = restore_terminal_settings(&old_settings);
+    // SIGWINCH jest odblokowywany jedynie na czas oczekiwania na klawisz.
+    struct sigaction resize_action, old_resize_action;
+    memset(&resize_action, 0, sizeof(struct sigaction));
+    resize_action.sa_handler = handle_terminal_resize;
+    sigemptyset(&resize_action.sa_mask);
+    sigaction(SIGWINCH, &resize_action, &old_resize_action);
+    sigset_t resize_signals, old_mask, wait_mask;
+    sigemptyset(&resize_signals);
+    sigaddset(&resize_signals, SIGWINCH);
+    sigprocmask(SIG_BLOCK, &resize_signals, &old_mask);
+    wait_mask = old_mask;
+    sigdelset(&wait_mask, SIGWINCH);
+
+    error = run_io_loop(in, &screen, g, error_message, &wait_mask);
+    screen_free(&screen);
+
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+    sigaction(SIGWINCH, &old_resize_action, NULL);
+
+    io_error_t cleanup_error = restore_terminal_settings(&old_settings, out);
     if (error == NO_ERROR && cleanup_error == NO_ERROR) {
-        error = print_game_summary(g);
+        error = print_game_summary(g, out);
     } else {
-        return TERMINAL_ERROR;
+        error = TERMINAL_ERROR;
     }
+    output_buffer_flush(out);
     return error;
 }
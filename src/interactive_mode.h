@@ -9,15 +9,22 @@
 #ifndef INTERACTIVE_MODE_H
 #define INTERACTIVE_MODE_H
 
+#include "buffered_io.h"
 #include "gamma.h"
 
 /** @brief Przeprowadza rozgrywkę w trybie interaktywnym.
- * @param[in] g      – wskaźnik na strukturę danych gry.
+ * Plansza odświeżana jest różnicowo - po każdym klawiszu do terminala wysyłane są
+ * jedynie zmienione pola i wiersze z informacjami o stanie gry.
+ * Plansza większa niż okno terminala wyświetlana jest fragmentami - widoczny
+ * fragment podąża za kursorem i dopasowuje się do zmian rozmiaru okna (SIGWINCH).
+ * @param[in] g       – wskaźnik na strukturę danych gry,
+ * @param[in,out] in  – wskaźnik na strukturę wejścia,
+ * @param[in,out] out – wskaźnik na bufor wyjścia terminala.
  * @return Kod @p NO_ERROR jeżeli wszystko przebiegło poprawnie, @p ENCOUNTERED_EOF
  * jeżeli wejście zostało zamknięte przed poprawnym zakończeniem gry, @p MEMORY_ERROR,
  * jeżeli wystąpił błąd alokacji pamięci, @p TERMINAL_ERROR jeżeli wystąpił błąd podczas
  * zmieniania parametrów terminala.
  */
-io_error_t interactive_run_mode(gamma_t *g);
+io_error_t interactive_run_mode(gamma_t *g, input_buffer_t *in, output_buffer_t *out);
 
 #endif /* INTERACTIVE_MODE_H */
@@ -0,0 +1,116 @@
+/** @file
+ * Implementacja modułu zapisującego dane w formacie JSON.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "json_writer.h"
+
+/** Cyfry szesnastkowe używane w sekwencjach \\u00XX. */
+static const char hex_digits[] = "0123456789abcdef";
+
+/** @brief Wstawia przecinek, jeżeli poprzedza go inna wartość.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ */
+static inline void write_separator(json_writer_t *writer) {
+    if (writer->needs_separator) {
+        output_buffer_write_char(writer->out, ',');
+    }
+}
+
+void json_writer_init(json_writer_t *writer, output_buffer_t *out) {
+    writer->out = out;
+    writer->needs_separator = false;
+}
+
+void json_begin_object(json_writer_t *writer) {
+    write_separator(writer);
+    output_buffer_write_char(writer->out, '{');
+    writer->needs_separator = false;
+}
+
+void json_end_object(json_writer_t *writer) {
+    output_buffer_write_char(writer->out, '}');
+    writer->needs_separator = true;
+}
+
+void json_begin_array(json_writer_t *writer) {
+    write_separator(writer);
+    output_buffer_write_char(writer->out, '[');
+    writer->needs_separator = false;
+}
+
+void json_end_array(json_writer_t *writer) {
+    output_buffer_write_char(writer->out, ']');
+    writer->needs_separator = true;
+}
+
+void json_key(json_writer_t *writer, const char *key) {
+    write_separator(writer);
+    output_buffer_write_char(writer->out, '"');
+    output_buffer_write_string(writer->out, key);
+    output_buffer_write(writer->out, "\":", 2);
+    writer->needs_separator = false;
+}
+
+void json_uint(json_writer_t *writer, uint64_t value) {
+    write_separator(writer);
+    output_buffer_write_uint64(writer->out, value);
+    writer->needs_separator = true;
+}
+
+void json_decimal(json_writer_t *writer, uint64_t value, unsigned fraction_digits) {
+    uint64_t scale = 1;
+    for (unsigned i = 0; i < fraction_digits; i++) {
+        scale *= 10;
+    }
+    write_separator(writer);
+    output_buffer_write_uint64(writer->out, value / scale);
+    if (fraction_digits > 0) {
+        char fraction[20];
+        uint64_t remainder = value % scale;
+        fraction[0] = '.';
+        for (unsigned i = fraction_digits; i > 0; i--) {
+            fraction[i] = (char)('0' + remainder % 10);
+            remainder /= 10;
+        }
+        output_buffer_write(writer->out, fraction, fraction_digits + 1);
+    }
+    writer->needs_separator = true;
+}
+
+void json_bool(json_writer_t *writer, bool value) {
+    write_separator(writer);
+    output_buffer_write_string(writer->out, value ? "true" : "false");
+    writer->needs_separator = true;
+}
+
+void json_string(json_writer_t *writer, const char *str, size_t size) {
+    json_begin_raw_string(writer);
+    for (size_t i = 0; i < size; i++) {
+        unsigned char ch = (unsigned char)str[i];
+        if (ch == '"' || ch == '\\') {
+            output_buffer_write_char(writer->out, '\\');
+            output_buffer_write_char(writer->out, (char)ch);
+        } else if (ch < 0x20) {
+            char escaped[] = {'\\', 'u', '0', '0', hex_digits[ch >> 4u],
+                              hex_digits[ch & 0xFu]};
+            output_buffer_write(writer->out, escaped, sizeof(escaped));
+        } else {
+            output_buffer_write_char(writer->out, (char)ch);
+        }
+    }
+    json_end_raw_string(writer);
+}
+
+void json_begin_raw_string(json_writer_t *writer) {
+    write_separator(writer);
+    output_buffer_write_char(writer->out, '"');
+}
+
+void json_end_raw_string(json_writer_t *writer) {
+    output_buffer_write_char(writer->out, '"');
+    writer->needs_separator = true;
+}
@@ -0,0 +1,96 @@
+/** @file
+ * Interfejs modułu zapisującego dane w formacie JSON.
+ * Dane zapisywane są bezpośrednio do bufora wyjścia, bez dodatkowych alokacji.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include "buffered_io.h"
+
+/**
+ * Struktura przechowująca stan zapisu danych JSON.
+ */
+typedef struct json_writer {
+    output_buffer_t *out;  /**< Bufor, do którego zapisywane są dane. */
+    bool needs_separator;  /**< Informacja czy przed następną wartością należy
+                            * wstawić przecinek. */
+} json_writer_t;
+
+/** @brief Inicjuje strukturę zapisu danych JSON.
+ * @param[out] writer     – wskaźnik na inicjowaną strukturę,
+ * @param[in] out         – wskaźnik na bufor wyjścia.
+ */
+void json_writer_init(json_writer_t *writer, output_buffer_t *out);
+
+/** @brief Rozpoczyna obiekt.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ */
+void json_begin_object(json_writer_t *writer);
+
+/** @brief Kończy obiekt.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ */
+void json_end_object(json_writer_t *writer);
+
+/** @brief Rozpoczyna tablicę.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ */
+void json_begin_array(json_writer_t *writer);
+
+/** @brief Kończy tablicę.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ */
+void json_end_array(json_writer_t *writer);
+
+/** @brief Zapisuje klucz pola obiektu.
+ * Klucz nie jest poprzedzany znakami ucieczki - musi składać się ze zwykłych
+ * znaków ASCII.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu,
+ * @param[in] key         – nazwa pola.
+ */
+void json_key(json_writer_t *writer, const char *key);
+
+/** @brief Zapisuje liczbę nieujemną.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu,
+ * @param[in] value       – liczba.
+ */
+void json_uint(json_writer_t *writer, uint64_t value);
+
+/** @brief Zapisuje liczbę nieujemną o stałej liczbie cyfr po przecinku.
+ * Zapisywana jest wartość @p value / 10^@p fraction_digits.
+ * @param[in,out] writer     – wskaźnik na strukturę zapisu,
+ * @param[in] value          – liczba pomnożona przez 10^@p fraction_digits,
+ * @param[in] fraction_digits – liczba cyfr po przecinku, nie większa niż 19.
+ */
+void json_decimal(json_writer_t *writer, uint64_t value, unsigned fraction_digits);
+
+/** @brief Zapisuje wartość logiczną.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu,
+ * @param[in] value       – wartość logiczna.
+ */
+void json_bool(json_writer_t *writer, bool value);
+
+/** @brief Zapisuje napis, poprzedzając znaki specjalne znakami ucieczki.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu,
+ * @param[in] str         – wskaźnik na znaki,
+ * @param[in] size        – liczba znaków.
+ */
+void json_string(json_writer_t *writer, const char *str, size_t size);
+
+/** @brief Rozpoczyna napis, którego treść zostanie dopisana bezpośrednio do bufora.
+ * Treść nie może zawierać znaków wymagających znaków ucieczki.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ */
+void json_begin_raw_string(json_writer_t *writer);
+
+/** @brief Kończy napis rozpoczęty przez @ref json_begin_raw_string.
+ * @param[in,out] writer  – wskaźnik na strukturę zapisu.
+ */
+void json_end_raw_string(json_writer_t *writer);
+
+#endif /* JSON_WRITER_H */
@@ -0,0 +1,46 @@
+/** @file
+ * Implementacja histogramu opóźnień o stałej względnej dokładności.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "latency_histogram.h"
+
+/** @brief Zwraca największą wartość należącą do przedziału.
+ * @param[in] bucket      – numer przedziału.
+ * @return Największa wartość w przedziale.
+ */
+static uint64_t bucket_highest_value(unsigned bucket) {
+    if (bucket < (1u << LATENCY_HISTOGRAM_PRECISION_BITS)) {
+        return bucket;
+    }
+    const unsigned offset = bucket - (1u << LATENCY_HISTOGRAM_PRECISION_BITS);
+    const unsigned shift = offset / LATENCY_HISTOGRAM_SUB_BUCKETS + 1;
+    const uint64_t top =
+        offset % LATENCY_HISTOGRAM_SUB_BUCKETS + LATENCY_HISTOGRAM_SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+uint64_t latency_histogram_quantile(const latency_histogram_t *histogram,
+                                    double quantile) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(quantile * (double)histogram->count);
+    if ((double)rank < quantile * (double)histogram->count) {
+        rank++;
+    }
+    rank = rank == 0 ? 1 : rank;
+
+    uint64_t seen = 0;
+    for (unsigned bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++) {
+        seen += histogram->buckets[bucket];
+        if (seen >= rank) {
+            const uint64_t value = bucket_highest_value(bucket);
+            return value < histogram->max ? value : histogram->max;
+        }
+    }
+    return histogram->max;
+}
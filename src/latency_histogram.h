@@ -0,0 +1,74 @@
+/** @file
+ * Interfejs histogramu opóźnień o stałej względnej dokładności.
+ * Wartości mniejsze niż 2^@ref LATENCY_HISTOGRAM_PRECISION_BITS zliczane są
+ * dokładnie, a większe - w przedziałach, których szerokość rośnie wraz z wartością
+ * tak, że błąd względny nie przekracza 2^(1 - @ref LATENCY_HISTOGRAM_PRECISION_BITS).
+ * Zapis wartości nie alokuje pamięci i wykonuje stałą liczbę operacji.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+/** Liczba bitów znaczących, z którymi zapamiętywane są wartości. */
+#define LATENCY_HISTOGRAM_PRECISION_BITS 6
+/** Liczba przedziałów o jednakowej szerokości w obrębie jednej potęgi dwójki. */
+#define LATENCY_HISTOGRAM_SUB_BUCKETS (1u << (LATENCY_HISTOGRAM_PRECISION_BITS - 1))
+/** Liczba przedziałów histogramu pokrywających wszystkie wartości 64-bitowe. */
+#define LATENCY_HISTOGRAM_BUCKETS                                                      \
+    ((1u << LATENCY_HISTOGRAM_PRECISION_BITS) +                                        \
+     (64 - LATENCY_HISTOGRAM_PRECISION_BITS) * LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+/**
+ * Struktura przechowująca histogram opóźnień.
+ */
+typedef struct latency_histogram {
+    uint64_t count;                              /**< Liczba zapisanych wartości. */
+    uint64_t max;                                /**< Największa zapisana wartość. */
+    uint64_t buckets[LATENCY_HISTOGRAM_BUCKETS]; /**< Liczności przedziałów. */
+} latency_histogram_t;
+
+/** @brief Zwraca numer przedziału zawierającego wartość.
+ * @param[in] value       – wartość.
+ * @return Numer przedziału.
+ */
+static inline unsigned latency_histogram_bucket(uint64_t value) {
+    if (value < (1u << LATENCY_HISTOGRAM_PRECISION_BITS)) {
+        return (unsigned)value;
+    }
+    const unsigned shift =
+        63 - (unsigned)__builtin_clzll(value) - (LATENCY_HISTOGRAM_PRECISION_BITS - 1);
+    return (1u << LATENCY_HISTOGRAM_PRECISION_BITS) +
+           (shift - 1) * LATENCY_HISTOGRAM_SUB_BUCKETS +
+           (unsigned)(value >> shift) - LATENCY_HISTOGRAM_SUB_BUCKETS;
+}
+
+/** @brief Zapisuje wartość w histogramie.
+ * @param[in,out] histogram – wskaźnik na histogram,
+ * @param[in] value         – wartość.
+ */
+static inline void latency_histogram_record(latency_histogram_t *histogram,
+                                            uint64_t value) {
+    histogram->count++;
+    histogram->buckets[latency_histogram_bucket(value)]++;
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+/** @brief Zwraca kwantyl zapisanych wartości.
+ * Wynikiem jest największa wartość należąca do przedziału, w którym leży kwantyl,
+ * ale nie większa od największej zapisanej wartości.
+ * @param[in] histogram   – wskaźnik na histogram,
+ * @param[in] quantile    – rząd kwantyla z przedziału [0, 1].
+ * @return Kwantyl lub 0, jeżeli histogram jest pusty.
+ */
+uint64_t latency_histogram_quantile(const latency_histogram_t *histogram,
+                                    double quantile);
+
+#endif /* LATENCY_HISTOGRAM_H */
@@ -0,0 +1,223 @@
+/** @file
+ * Implementacja piramidy zajętości planszy gry gamma.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#include "ownership_pyramid.h"
+#include <string.h>
+
+/** Maksymalna liczba bloków łączonych w jeden blok wyższego poziomu. */
+#define CHILDREN_UPPER_BOUND 4
+
+/** @brief Zwraca liczbę bloków o boku 2^level potrzebnych do pokrycia odcinka.
+ * @param[in] length      – długość odcinka,
+ * @param[in] level       – numer poziomu.
+ * @return Liczba bloków.
+ */
+static inline uint32_t blocks_count(uint32_t length, unsigned level) {
+    return (uint32_t)(((uint64_t)length + (1ull << level) - 1) >> level);
+}
+
+/** @brief Wyznacza podsumowanie bloku na podstawie podsumowań jego części.
+ * Dominującym graczem zostaje gracz o największej łącznej liczbie pól wśród
+ * dominujących graczy części; przy remisie gracz o mniejszym numerze.
+ * @param[out] node       – wskaźnik na wyznaczane podsumowanie,
+ * @param[in] children    – podsumowania części bloku,
+ * @param[in] count       – liczba części bloku.
+ */
+static void combine(pyramid_node_t *node, const pyramid_node_t *children, unsigned count) {
+    node->occupied = 0;
+    node->owner = 0;
+    node->owner_fields = 0;
+    for (unsigned i = 0; i < count; i++) {
+        node->occupied += children[i].occupied;
+        const uint32_t owner = children[i].owner;
+        if (owner == 0) {
+            continue;
+        }
+
+        uint64_t owner_fields = 0;
+        for (unsigned j = 0; j < count; j++) {
+            if (children[j].owner == owner) {
+                owner_fields += children[j].owner_fields;
+            }
+        }
+        if (owner_fields > node->owner_fields ||
+            (owner_fields == node->owner_fields && owner < node->owner)) {
+            node->owner = owner;
+            node->owner_fields = owner_fields;
+        }
+    }
+}
+
+/** @brief Wyznacza podsumowanie bloku na podstawie bloków niższego poziomu.
+ * @param[in,out] pyramid – wskaźnik na piramidę,
+ * @param[in] level       – numer poziomu bloku, co najmniej 2,
+ * @param[in] column      – numer kolumny bloku,
+ * @param[in] row         – numer wiersza bloku.
+ */
+static void update_node(ownership_pyramid_t *pyramid, unsigned level, uint32_t column,
+                        uint32_t row) {
+    const uint32_t lower_columns = ownership_pyramid_columns(pyramid, level - 1);
+    const uint32_t lower_rows = ownership_pyramid_rows(pyramid, level - 1);
+    pyramid_node_t children[CHILDREN_UPPER_BOUND];
+    unsigned count = 0;
+    for (uint64_t y = 2ull * row; y < 2ull * row + 2 && y < lower_rows; y++) {
+        for (uint64_t x = 2ull * column; x < 2ull * column + 2 && x < lower_columns;
+             x++) {
+            children[count++] = *ownership_pyramid_node(pyramid, level - 1, x, y);
+        }
+    }
+
+    const uint64_t index = (uint64_t)row * ownership_pyramid_columns(pyramid, level) +
+                           column;
+    combine(&pyramid->nodes[level - 1][index], children, count);
+}
+
+/** @brief Alokuje wyzerowaną tablicę.
+ * @param[in] allocator   – wskaźnik na alokator,
+ * @param[in] size        – rozmiar tablicy w bajtach.
+ * @return Wskaźnik na tablicę lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+static void *allocate_zeroed(const gamma_allocator_t *allocator, size_t size) {
+    void *array = allocator->alloc(allocator->context, size);
+    if (array != NULL) {
+        memset(array, 0, size);
+    }
+    return array;
+}
+
+/** @brief Zwraca rozmiar tablicy bloków poziomu w bajtach.
+ * @param[in] pyramid     – wskaźnik na piramidę,
+ * @param[in] level       – numer poziomu.
+ * @return Rozmiar tablicy.
+ */
+static size_t level_size(const ownership_pyramid_t *pyramid, unsigned level) {
+    return (size_t)ownership_pyramid_columns(pyramid, level) *
+           ownership_pyramid_rows(pyramid, level) * sizeof(pyramid_node_t);
+}
+
+ownership_pyramid_t *ownership_pyramid_new(uint32_t width, uint32_t height,
+                                           const gamma_allocator_t *allocator) {
+    ownership_pyramid_t *pyramid =
+        allocator->alloc(allocator->context, sizeof(ownership_pyramid_t));
+    if (pyramid == NULL) {
+        return NULL;
+    }
+    pyramid->width = width;
+    pyramid->height = height;
+    pyramid->allocator = allocator;
+    pyramid->levels = 1;
+    while (blocks_count(width, pyramid->levels) > 1 ||
+           blocks_count(height, pyramid->levels) > 1) {
+        pyramid->levels++;
+    }
+
+    pyramid->nodes =
+        allocate_zeroed(allocator, pyramid->levels * sizeof(pyramid_node_t *));
+    if (pyramid->nodes == NULL) {
+        allocator->free(allocator->context, pyramid, sizeof(ownership_pyramid_t));
+        return NULL;
+    }
+    for (unsigned level = 1; level <= pyramid->levels; level++) {
+        pyramid->nodes[level - 1] =
+            allocate_zeroed(allocator, level_size(pyramid, level));
+        if (pyramid->nodes[level - 1] == NULL) {
+            ownership_pyramid_delete(pyramid);
+            return NULL;
+        }
+    }
+
+    return pyramid;
+}
+
+void ownership_pyramid_delete(ownership_pyramid_t *pyramid) {
+    if (pyramid == NULL) {
+        return;
+    }
+    const gamma_allocator_t *allocator = pyramid->allocator;
+    for (unsigned level = 1; level <= pyramid->levels; level++) {
+        if (pyramid->nodes[level - 1] != NULL) {
+            allocator->free(allocator->context, pyramid->nodes[level - 1],
+                            level_size(pyramid, level));
+        }
+    }
+    allocator->free(allocator->context, pyramid->nodes,
+                    pyramid->levels * sizeof(pyramid_node_t *));
+    allocator->free(allocator->context, pyramid, sizeof(ownership_pyramid_t));
+}
+
+uint64_t ownership_pyramid_estimate_memory(uint32_t width, uint32_t height) {
+    uint64_t bytes = sizeof(ownership_pyramid_t);
+    unsigned level = 0;
+    do {
+        level++;
+        bytes += sizeof(pyramid_node_t *) + (uint64_t)blocks_count(width, level) *
+                                                blocks_count(height, level) *
+                                                sizeof(pyramid_node_t);
+    } while (blocks_count(width, level) > 1 || blocks_count(height, level) > 1);
+    return bytes;
+}
+
+uint64_t ownership_pyramid_memory_usage(const ownership_pyramid_t *pyramid) {
+    if (pyramid == NULL) {
+        return 0;
+    }
+    return ownership_pyramid_estimate_memory(pyramid->width, pyramid->height);
+}
+
+uint32_t ownership_pyramid_columns(const ownership_pyramid_t *pyramid, unsigned level) {
+    return blocks_count(pyramid->width, level);
+}
+
+uint32_t ownership_pyramid_rows(const ownership_pyramid_t *pyramid, unsigned level) {
+    return blocks_count(pyramid->height, level);
+}
+
+void ownership_pyramid_set_block(ownership_pyramid_t *pyramid, uint32_t column,
+                                 uint32_t row, const uint32_t *owners, unsigned count) {
+    pyramid_node_t fields[CHILDREN_UPPER_BOUND];
+    for (unsigned i = 0; i < count; i++) {
+        fields[i].occupied = owners[i] != 0;
+        fields[i].owner_fields = owners[i] != 0;
+        fields[i].owner = owners[i];
+    }
+
+    const uint64_t index = (uint64_t)row * ownership_pyramid_columns(pyramid, 1) + column;
+    combine(&pyramid->nodes[0][index], fields, count);
+}
+
+void ownership_pyramid_propagate(ownership_pyramid_t *pyramid, uint32_t column,
+                                 uint32_t row) {
+    for (unsigned level = 2; level <= pyramid->levels; level++) {
+        column /= 2;
+        row /= 2;
+        update_node(pyramid, level, column, row);
+    }
+}
+
+void ownership_pyramid_rebuild(ownership_pyramid_t *pyramid) {
+    for (unsigned level = 2; level <= pyramid->levels; level++) {
+        const uint32_t columns = ownership_pyramid_columns(pyramid, level);
+        const uint32_t rows = ownership_pyramid_rows(pyramid, level);
+        for (uint32_t row = 0; row < rows; row++) {
+            for (uint32_t column = 0; column < columns; column++) {
+                update_node(pyramid, level, column, row);
+            }
+        }
+    }
+}
+
+unsigned ownership_pyramid_fitting_level(const ownership_pyramid_t *pyramid,
+                                         uint32_t max_columns, uint32_t max_rows) {
+    unsigned level = 1;
+    while (level < pyramid->levels &&
+           (ownership_pyramid_columns(pyramid, level) > max_columns ||
+            ownership_pyramid_rows(pyramid, level) > max_rows)) {
+        level++;
+    }
+    return level;
+}
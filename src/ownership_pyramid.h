@@ -0,0 +1,136 @@
+/** @file
+ * Interfejs piramidy zajętości planszy gry gamma.
+ * Piramida przechowuje podsumowania kwadratowych bloków planszy o bokach będących
+ * kolejnymi potęgami dwójki: liczbę zajętych pól oraz przybliżonego dominującego
+ * gracza. Zmiana jednego pola aktualizuje po jednym bloku na każdym poziomie.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef OWNERSHIP_PYRAMID_H
+#define OWNERSHIP_PYRAMID_H
+
+#include "gamma.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Struktura przechowująca podsumowanie bloku planszy.
+ */
+typedef struct pyramid_node {
+    uint64_t occupied;     /**< Liczba zajętych pól w bloku. */
+    uint64_t owner_fields; /**< Przybliżona liczba pól dominującego gracza. */
+    uint32_t owner;        /**< Przybliżony dominujący gracz lub 0 dla bloku
+                            * bez zajętych pól. */
+} pyramid_node_t;
+
+/**
+ * Struktura przechowująca piramidę zajętości planszy.
+ * Poziom @p k (liczony od 1) składa się z bloków o boku 2^k.
+ */
+typedef struct ownership_pyramid {
+    uint32_t width;         /**< Szerokość planszy. */
+    uint32_t height;        /**< Wysokość planszy. */
+    unsigned levels;        /**< Liczba poziomów; najwyższy ma jeden blok. */
+    pyramid_node_t **nodes; /**< Tablice bloków kolejnych poziomów, wiersz po
+                             * wierszu; @p nodes[k - 1] to poziom @p k. */
+    const gamma_allocator_t *allocator; /**< Alokator pamięci piramidy. */
+} ownership_pyramid_t;
+
+/** @brief Tworzy piramidę pustej planszy.
+ * @param[in] width       – szerokość planszy, liczba dodatnia,
+ * @param[in] height      – wysokość planszy, liczba dodatnia,
+ * @param[in] allocator   – wskaźnik na alokator, który musi istnieć do czasu
+ *                          usunięcia piramidy.
+ * @return Wskaźnik na utworzoną piramidę lub NULL, gdy nie udało się zaalokować
+ * pamięci.
+ */
+ownership_pyramid_t *ownership_pyramid_new(uint32_t width, uint32_t height,
+                                           const gamma_allocator_t *allocator);
+
+/** @brief Usuwa piramidę.
+ * @param[in] pyramid     – wskaźnik na piramidę lub NULL.
+ */
+void ownership_pyramid_delete(ownership_pyramid_t *pyramid);
+
+/** @brief Szacuje liczbę bajtów, które zaalokuje piramida planszy o zadanych
+ * wymiarach.
+ * @param[in] width       – szerokość planszy,
+ * @param[in] height      – wysokość planszy.
+ * @return Liczba bajtów równa wynikowi @ref ownership_pyramid_memory_usage dla
+ * utworzonej piramidy.
+ */
+uint64_t ownership_pyramid_estimate_memory(uint32_t width, uint32_t height);
+
+/** @brief Zwraca liczbę bajtów zaalokowanych przez piramidę.
+ * @param[in] pyramid     – wskaźnik na piramidę lub NULL.
+ * @return Liczba bajtów lub zero, jeżeli piramida nie istnieje.
+ */
+uint64_t ownership_pyramid_memory_usage(const ownership_pyramid_t *pyramid);
+
+/** @brief Zwraca liczbę kolumn bloków na zadanym poziomie.
+ * @param[in] pyramid     – wskaźnik na piramidę,
+ * @param[in] level       – numer poziomu.
+ * @return Liczba kolumn bloków.
+ */
+uint32_t ownership_pyramid_columns(const ownership_pyramid_t *pyramid, unsigned level);
+
+/** @brief Zwraca liczbę wierszy bloków na zadanym poziomie.
+ * @param[in] pyramid     – wskaźnik na piramidę,
+ * @param[in] level       – numer poziomu.
+ * @return Liczba wierszy bloków.
+ */
+uint32_t ownership_pyramid_rows(const ownership_pyramid_t *pyramid, unsigned level);
+
+/** @brief Ustawia podsumowanie bloku 2x2 na najniższym poziomie.
+ * Nie aktualizuje wyższych poziomów.
+ * @param[in,out] pyramid – wskaźnik na piramidę,
+ * @param[in] column      – numer kolumny bloku,
+ * @param[in] row         – numer wiersza bloku,
+ * @param[in] owners      – numery graczy zajmujących pola bloku (0 dla pola pustego),
+ * @param[in] count       – liczba pól bloku należących do planszy, od 1 do 4.
+ */
+void ownership_pyramid_set_block(ownership_pyramid_t *pyramid, uint32_t column,
+                                 uint32_t row, const uint32_t *owners, unsigned count);
+
+/** @brief Aktualizuje bloki wyższych poziomów zawierające zadany blok 2x2.
+ * Złożoność O(log(max(width, height))).
+ * @param[in,out] pyramid – wskaźnik na piramidę,
+ * @param[in] column      – numer kolumny bloku najniższego poziomu,
+ * @param[in] row         – numer wiersza bloku najniższego poziomu.
+ */
+void ownership_pyramid_propagate(ownership_pyramid_t *pyramid, uint32_t column,
+                                 uint32_t row);
+
+/** @brief Wyznacza na nowo wszystkie poziomy powyżej najniższego.
+ * Złożoność O(width * height).
+ * @param[in,out] pyramid – wskaźnik na piramidę.
+ */
+void ownership_pyramid_rebuild(ownership_pyramid_t *pyramid);
+
+/** @brief Zwraca najniższy poziom, który mieści się w zadanym obszarze.
+ * @param[in] pyramid     – wskaźnik na piramidę,
+ * @param[in] max_columns – maksymalna liczba kolumn bloków, liczba dodatnia,
+ * @param[in] max_rows    – maksymalna liczba wierszy bloków, liczba dodatnia.
+ * @return Numer poziomu.
+ */
+unsigned ownership_pyramid_fitting_level(const ownership_pyramid_t *pyramid,
+                                         uint32_t max_columns, uint32_t max_rows);
+
+/** @brief Zwraca podsumowanie bloku.
+ * @param[in] pyramid     – wskaźnik na piramidę,
+ * @param[in] level       – numer poziomu,
+ * @param[in] column      – numer kolumny bloku,
+ * @param[in] row         – numer wiersza bloku.
+ * @return Wskaźnik na podsumowanie bloku.
+ */
+static inline const pyramid_node_t *ownership_pyramid_node(
+    const ownership_pyramid_t *pyramid, unsigned level, uint32_t column, uint32_t row) {
+    return &pyramid->nodes[level - 1]
+                          [(uint64_t)row * ownership_pyramid_columns(pyramid, level) +
+                           column];
+}
+
+#endif /* OWNERSHIP_PYRAMID_H */
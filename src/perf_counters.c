@@ -0,0 +1,159 @@
+/** @file
+ * Implementacja sprzętowych liczników wydajności odczytywanych przez
+ * perf_event_open. Bez makra GAMMA_PERF_EVENTS żaden licznik nie jest dostępny.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+/** _GNU_SOURCE - wymagane, aby dostępna była funkcja syscall */
+#define _GNU_SOURCE
+
+#include "perf_counters.h"
+
+const char *const perf_counter_names[PERF_COUNTERS_COUNT] = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"};
+
+#ifdef GAMMA_PERF_EVENTS
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** Konfiguracja zdarzenia pamięci podręcznej zliczającego chybienia odczytów. */
+#define CACHE_READ_MISSES(cache)                                                       \
+    ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8u) |                                   \
+     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16u))
+
+/** Typy zdarzeń kolejnych liczników. */
+static const uint32_t counter_types[PERF_COUNTERS_COUNT] = {
+    PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE,
+    PERF_TYPE_HARDWARE};
+/** Konfiguracje zdarzeń kolejnych liczników. */
+static const uint64_t counter_configs[PERF_COUNTERS_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    CACHE_READ_MISSES(PERF_COUNT_HW_CACHE_L1D),
+    CACHE_READ_MISSES(PERF_COUNT_HW_CACHE_LL), PERF_COUNT_HW_BRANCH_MISSES};
+
+/**
+ * Struktura odczytywana z deskryptora licznika.
+ */
+typedef struct counter_reading {
+    uint64_t value;        /**< Wartość licznika. */
+    uint64_t time_enabled; /**< Czas, przez który licznik był włączony. */
+    uint64_t time_running; /**< Czas, przez który licznik faktycznie zliczał. */
+} counter_reading_t;
+
+/** @brief Otwiera zatrzymany licznik bieżącego wątku.
+ * @param[in] counter     – otwierany licznik.
+ * @return Deskryptor licznika lub -1, jeżeli licznik jest niedostępny.
+ */
+static int open_counter(perf_counter_t counter) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter_types[counter];
+    attr.config = counter_configs[counter];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    return fd < 0 ? -1 : (int)fd;
+}
+
+/** @brief Wykonuje operację ioctl na wszystkich dostępnych licznikach.
+ * @param[in,out] counters – wskaźnik na liczniki,
+ * @param[in] request      – kod operacji.
+ */
+static void control_counters(perf_counters_t *counters, unsigned long request) {
+    for (unsigned i = 0; i < PERF_COUNTERS_COUNT; i++) {
+        if (counters->fds[i] >= 0) {
+            ioctl(counters->fds[i], request, 0);
+        }
+    }
+}
+
+bool perf_counters_open(perf_counters_t *counters) {
+    bool any_open = false;
+    for (unsigned i = 0; i < PERF_COUNTERS_COUNT; i++) {
+        counters->fds[i] = open_counter((perf_counter_t)i);
+        any_open |= counters->fds[i] >= 0;
+    }
+    return any_open;
+}
+
+void perf_counters_close(perf_counters_t *counters) {
+    for (unsigned i = 0; i < PERF_COUNTERS_COUNT; i++) {
+        if (counters->fds[i] >= 0) {
+            close(counters->fds[i]);
+            counters->fds[i] = -1;
+        }
+    }
+}
+
+void perf_counters_reset(perf_counters_t *counters) {
+    control_counters(counters, PERF_EVENT_IOC_RESET);
+}
+
+void perf_counters_start(perf_counters_t *counters) {
+    control_counters(counters, PERF_EVENT_IOC_ENABLE);
+}
+
+void perf_counters_stop(perf_counters_t *counters) {
+    control_counters(counters, PERF_EVENT_IOC_DISABLE);
+}
+
+bool perf_counters_read(const perf_counters_t *counters, perf_counter_t counter,
+                        uint64_t *value) {
+    counter_reading_t reading;
+    if (counters->fds[counter] < 0 ||
+        read(counters->fds[counter], &reading, sizeof(reading)) !=
+            (ssize_t)sizeof(reading) ||
+        reading.time_running == 0) {
+        return false;
+    }
+    *value = reading.time_running == reading.time_enabled
+                 ? reading.value
+                 : (uint64_t)((double)reading.value * (double)reading.time_enabled /
+                              (double)reading.time_running);
+    return true;
+}
+
+#else /* GAMMA_PERF_EVENTS */
+
+bool perf_counters_open(perf_counters_t *counters) {
+    for (unsigned i = 0; i < PERF_COUNTERS_COUNT; i++) {
+        counters->fds[i] = -1;
+    }
+    return false;
+}
+
+void perf_counters_close(perf_counters_t *counters) {
+    (void)counters;
+}
+
+void perf_counters_reset(perf_counters_t *counters) {
+    (void)counters;
+}
+
+void perf_counters_start(perf_counters_t *counters) {
+    (void)counters;
+}
+
+void perf_counters_stop(perf_counters_t *counters) {
+    (void)counters;
+}
+
+bool perf_counters_read(const perf_counters_t *counters, perf_counter_t counter,
+                        uint64_t *value) {
+    (void)counters;
+    (void)counter;
+    (void)value;
+    return false;
+}
+
+#endif /* GAMMA_PERF_EVENTS */
@@ -0,0 +1,85 @@
+/** @file
+ * Interfejs sprzętowych liczników wydajności odczytywanych przez perf_event_open.
+ * Liczniki mierzą wyłącznie kod bieżącego wątku wykonywany w przestrzeni
+ * użytkownika. Każdy licznik otwierany jest osobno, więc brak obsługi jednego
+ * z nich (np. w maszynie wirtualnej) nie wyłącza pozostałych.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Enum opisujący odczytywane liczniki wydajności.
+ */
+typedef enum perf_counter {
+    PERF_COUNTER_CYCLES,        /**< Cykle procesora. */
+    PERF_COUNTER_INSTRUCTIONS,  /**< Wykonane instrukcje. */
+    PERF_COUNTER_L1D_MISSES,    /**< Chybienia odczytów w pamięci podręcznej L1
+                                 * danych. */
+    PERF_COUNTER_LLC_MISSES,    /**< Chybienia w pamięci podręcznej ostatniego
+                                 * poziomu. */
+    PERF_COUNTER_BRANCH_MISSES, /**< Błędnie przewidziane skoki. */
+    PERF_COUNTERS_COUNT,        /**< Liczba liczników. */
+} perf_counter_t;
+
+/**
+ * Struktura przechowująca otwarte liczniki wydajności.
+ */
+typedef struct perf_counters {
+    int fds[PERF_COUNTERS_COUNT]; /**< Deskryptory liczników lub -1 dla liczników
+                                   * niedostępnych. */
+} perf_counters_t;
+
+/** Krótkie nazwy liczników w kolejności @ref perf_counter_t. */
+extern const char *const perf_counter_names[PERF_COUNTERS_COUNT];
+
+/** @brief Otwiera liczniki wydajności bieżącego wątku.
+ * Liczniki są początkowo zatrzymane. Niedostępne liczniki - z powodu braku
+ * uprawnień (kernel.perf_event_paranoid), braku obsługi przez procesor lub
+ * kompilacji bez makra @p GAMMA_PERF_EVENTS - są pomijane.
+ * @param[out] counters   – wskaźnik na inicjowaną strukturę.
+ * @return Wartość @p true, jeżeli udało się otworzyć co najmniej jeden licznik,
+ * @p false w przeciwnym przypadku.
+ */
+bool perf_counters_open(perf_counters_t *counters);
+
+/** @brief Zamyka liczniki wydajności.
+ * @param[in,out] counters – wskaźnik na liczniki.
+ */
+void perf_counters_close(perf_counters_t *counters);
+
+/** @brief Zeruje wartości liczników.
+ * @param[in,out] counters – wskaźnik na liczniki.
+ */
+void perf_counters_reset(perf_counters_t *counters);
+
+/** @brief Wznawia zliczanie.
+ * @param[in,out] counters – wskaźnik na liczniki.
+ */
+void perf_counters_start(perf_counters_t *counters);
+
+/** @brief Wstrzymuje zliczanie.
+ * @param[in,out] counters – wskaźnik na liczniki.
+ */
+void perf_counters_stop(perf_counters_t *counters);
+
+/** @brief Odczytuje wartość licznika.
+ * Jeżeli jądro współdzieliło sprzętowy licznik z innymi zdarzeniami, wartość jest
+ * przeskalowana do całego czasu zliczania.
+ * @param[in] counters    – wskaźnik na liczniki,
+ * @param[in] counter     – odczytywany licznik,
+ * @param[out] value      – wskaźnik na odczytaną wartość.
+ * @return Wartość @p true, jeżeli licznik jest dostępny i był zliczany,
+ * @p false w przeciwnym przypadku.
+ */
+bool perf_counters_read(const perf_counters_t *counters, perf_counter_t counter,
+                        uint64_t *value);
+
+#endif /* PERF_COUNTERS_H */
@@ -0,0 +1,549 @@
+/** @file
+ * Implementacja trybu serwera obsługującego wiele gier gamma jednocześnie.
+ * Wszystkie połączenia obsługiwane są w jednym wątku przy pomocy epoll.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+/** _GNU_SOURCE - wymagane, aby string.h definiowało funkcję memrchr */
+#define _GNU_SOURCE
+
+#include "server_mode.h"
+#include "batch_mode.h"
+#include "text_input_handler.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/** Identyfikatory trybów rozgrywki dozwolonych w trybie serwera. */
+#define SERVER_GAME_MODE_IDENTIFIERS "B"
+/** Prefiks adresu gniazda domeny uniksowej. */
+#define UNIX_ADDRESS_PREFIX "unix:"
+/** Prefiks adresu gniazda TCP. */
+#define TCP_ADDRESS_PREFIX "tcp:"
+/** Początkowy rozmiar buforów połączenia. */
+#define CONNECTION_BUFFER_CAPACITY 4096
+/** Maksymalna długość wiersza wejścia przyjmowanego od klienta. */
+#define MAX_LINE_LENGTH (1u << 20u)
+/** Liczba bajtów oczekujących na wysłanie, po której przestajemy czytać polecenia. */
+#define OUTPUT_HIGH_WATERMARK (1u << 20u)
+/** Maksymalna liczba poleceń klienta wykonywanych w jednym zdarzeniu, aby jeden
+ * klient nie wstrzymywał obsługi pozostałych. */
+#define LINES_PER_EVENT 1024
+/** Maksymalna liczba zdarzeń obsługiwanych w jednym wywołaniu epoll_wait. */
+#define MAX_EVENTS 256
+/** Czas w milisekundach, po którym serwer ponawia przyjmowanie połączeń wstrzymane
+ * z braku deskryptorów lub pamięci, jeżeli wcześniej nie zamknięto połączenia. */
+#define ACCEPT_RETRY_TIMEOUT_MS 100
+
+/**
+ * Struktura przechowująca stan połączenia z klientem.
+ */
+typedef struct connection {
+    int fd;              /**< Deskryptor gniazda. */
+    batch_session_t session; /**< Stan gry klienta; błędy trafiają do tego samego
+                              * bufora co wyniki. */
+    char *input;         /**< Wczytane, jeszcze nieprzetworzone znaki. */
+    size_t input_length; /**< Liczba znaków w buforze @p input. */
+    size_t input_capacity; /**< Rozmiar bufora @p input. */
+    size_t input_pending; /**< Liczba znaków na początku bufora @p input tworzących
+                           * kompletne, jeszcze niewykonane wiersze. */
+    bool input_closed;   /**< Informacja czy klient zakończył wysyłanie danych. */
+    bool reading_paused; /**< Informacja czy czytanie jest wstrzymane do czasu
+                          * wysłania zaległych odpowiedzi i wykonania
+                          * wczytanych wierszy. */
+    bool output_failed;  /**< Informacja czy nie udało się wysłać lub zapisać
+                          * odpowiedzi, więc połączenie należy zamknąć. */
+    output_buffer_t out; /**< Odpowiedzi oczekujące na wysłanie. */
+    struct connection *prev; /**< Poprzednie połączenie na liście. */
+    struct connection *next; /**< Następne połączenie na liście. */
+} connection_t;
+
+/**
+ * Struktura przechowująca stan serwera.
+ */
+typedef struct server {
+    int listen_fd;             /**< Deskryptor gniazda nasłuchującego. */
+    int epoll_fd;              /**< Deskryptor instancji epoll. */
+    connection_t *connections; /**< Lista aktywnych połączeń. */
+    bool accepting_paused;     /**< Informacja czy gniazdo nasłuchujące jest
+                                * wyłączone z epoll z braku zasobów. */
+    const batch_options_t *options; /**< Opcje trybu wsadowego. */
+} server_t;
+
+/** Informacja czy otrzymano sygnał kończący pracę serwera. */
+static volatile sig_atomic_t stop_requested = 0;
+
+/** @brief Obsługuje sygnał kończący pracę serwera.
+ * @param[in] signal_number   – numer sygnału.
+ */
+static void request_stop(int signal_number) {
+    (void)signal_number;
+    stop_requested = 1;
+}
+
+/** @brief Wysyła tyle odpowiedzi, ile gniazdo przyjmie bez blokowania.
+ * Niewysłane dane pozostają na początku bufora. Zerwanie połączenia zaznaczane
+ * jest w połączeniu wskazywanym przez @p out->backend, ponieważ wyniki zapisu
+ * wyników poleceń nie są sprawdzane.
+ * @param[in,out] out     – wskaźnik na bufor wyjścia połączenia.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p SYSTEM_ERROR
+ * jeżeli połączenie zostało zerwane.
+ */
+static io_error_t flush_connection_output(output_buffer_t *out) {
+    size_t sent = 0;
+    while (sent < out->length) {
+        ssize_t result = send(out->fd, out->data + sent, out->length - sent,
+                              MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            out->length = 0;
+            ((connection_t *)out->backend)->output_failed = true;
+            return SYSTEM_ERROR;
+        }
+        sent += (size_t)result;
+    }
+
+    memmove(out->data, out->data + sent, out->length - sent);
+    out->length -= sent;
+    return NO_ERROR;
+}
+
+/** @brief Ustawia zdarzenia, na które oczekuje połączenie.
+ * Niewykonane wiersze wstrzymują czytanie i są wykonywane, gdy gniazdo przyjmie
+ * kolejne odpowiedzi.
+ * @param[in] server      – wskaźnik na strukturę serwera,
+ * @param[in,out] conn    – wskaźnik na połączenie.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p SYSTEM_ERROR
+ * w przeciwnym przypadku.
+ */
+static io_error_t update_connection_events(const server_t *server, connection_t *conn) {
+    struct epoll_event event = {.events = 0, .data.ptr = conn};
+    conn->reading_paused =
+        conn->out.length > OUTPUT_HIGH_WATERMARK || conn->input_pending > 0;
+    if (!conn->input_closed && !conn->reading_paused) {
+        event.events |= EPOLLIN;
+    }
+    if (conn->out.length > 0 || conn->input_pending > 0) {
+        event.events |= EPOLLOUT;
+    }
+    if (epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &event) != 0) {
+        return SYSTEM_ERROR;
+    }
+    return NO_ERROR;
+}
+
+/** @brief Wznawia przyjmowanie połączeń, jeżeli było wstrzymane.
+ * Jeżeli nie uda się przywrócić gniazda nasłuchującego do epoll, przyjmowanie
+ * pozostaje wstrzymane i zostanie ponowione później.
+ * @param[in,out] server  – wskaźnik na strukturę serwera.
+ */
+static void resume_accepting(server_t *server) {
+    if (!server->accepting_paused) {
+        return;
+    }
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = NULL};
+    if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &event) == 0) {
+        server->accepting_paused = false;
+    }
+}
+
+/** @brief Zamyka połączenie i zwalnia jego zasoby.
+ * Zwolniony deskryptor pozwala wznowić przyjmowanie połączeń.
+ * @param[in,out] server  – wskaźnik na strukturę serwera,
+ * @param[in] conn        – wskaźnik na zamykane połączenie.
+ */
+static void close_connection(server_t *server, connection_t *conn) {
+    if (conn->prev != NULL) {
+        conn->prev->next = conn->next;
+    } else {
+        server->connections = conn->next;
+    }
+    if (conn->next != NULL) {
+        conn->next->prev = conn->prev;
+    }
+
+    close(conn->fd);
+    batch_session_free(&conn->session);
+    gamma_delete(conn->session.game);
+    output_buffer_free(&conn->out);
+    free(conn->input);
+    free(conn);
+    resume_accepting(server);
+}
+
+/** @brief Przetwarza wiersz tworzący nową grę.
+ * @param[in,out] session – wskaźnik na stan gry połączenia.
+ */
+static void run_game_creation_line(batch_session_t *session) {
+    char mode;
+    uint32_t args[COMMAND_ARGUMENTS_UPPER_BOUND];
+
+    session->line++;
+    io_error_t error = text_input_read_next_command(session->in, &mode, args,
+                                                    SERVER_GAME_MODE_IDENTIFIERS);
+    if (error == NO_ERROR) {
+        error = batch_create_game(session, args);
+    }
+
+    if (error == NO_ERROR) {
+        batch_report_game_started(session);
+    } else if (error != LINE_IGNORED && error != ENCOUNTERED_EOF) {
+        batch_report_error(session);
+    }
+}
+
+/** @brief Wykonuje polecenia z zadanego fragmentu wejścia.
+ * Fragment musi kończyć się znakiem nowej linii, chyba że klient zakończył
+ * wysyłanie danych. Przerywa wykonywanie po @ref LINES_PER_EVENT wierszach, gdy
+ * zaległe odpowiedzi przekroczą @ref OUTPUT_HIGH_WATERMARK bajtów lub jeżeli nie
+ * udało się wysłać lub zapisać odpowiedzi.
+ * @param[in,out] conn    – wskaźnik na połączenie,
+ * @param[in] data        – wskaźnik na fragment wejścia,
+ * @param[in] length      – długość fragmentu.
+ * @return Liczba znaków wykonanych wierszy.
+ */
+static size_t run_lines(connection_t *conn, char *data, size_t length) {
+    input_buffer_t in;
+    input_buffer_init_memory(&in, data, length);
+    conn->session.in = &in;
+
+    unsigned lines = 0;
+    while (input_buffer_has_buffered_data(&in) && !conn->output_failed &&
+           lines < LINES_PER_EVENT && conn->out.length <= OUTPUT_HIGH_WATERMARK) {
+        if (conn->session.game == NULL) {
+            run_game_creation_line(&conn->session);
+        } else {
+            const io_error_t error = batch_run_next_command(&conn->session);
+            conn->output_failed |= error == MEMORY_ERROR || error == SYSTEM_ERROR;
+        }
+        lines++;
+    }
+    conn->session.in = NULL;
+    return in.position;
+}
+
+/** @brief Zgłasza podsumowanie rozgrywki klienta, który zakończył wysyłanie
+ * danych.
+ * @param[in,out] conn    – wskaźnik na połączenie.
+ */
+static void report_session_end(connection_t *conn) {
+    if (conn->session.options.quiet && conn->session.game != NULL) {
+        batch_report_summary(&conn->session);
+    }
+    batch_report_latency(&conn->session);
+}
+
+/** @brief Wykonuje kolejną porcję wczytanych, niewykonanych wierszy.
+ * Wykonane znaki usuwane są z bufora wejścia. Po wykonaniu ostatniego wiersza
+ * klienta, który zakończył wysyłanie danych, zgłasza podsumowanie rozgrywki.
+ * @param[in,out] conn    – wskaźnik na połączenie.
+ */
+static void run_pending_lines(connection_t *conn) {
+    size_t consumed = run_lines(conn, conn->input, conn->input_pending);
+    conn->input_pending -= consumed;
+    conn->input_length -= consumed;
+    memmove(conn->input, conn->input + consumed, conn->input_length);
+    if (conn->input_closed && conn->input_pending == 0) {
+        report_session_end(conn);
+    }
+}
+
+/** @brief Wczytuje dane od klienta i oznacza kompletne wiersze do wykonania.
+ * @param[in,out] conn    – wskaźnik na połączenie.
+ * @return Kod @p NO_ERROR jeżeli połączenie może być dalej obsługiwane,
+ * @p MEMORY_ERROR lub @p SYSTEM_ERROR jeżeli należy je zamknąć.
+ */
+static io_error_t read_from_connection(connection_t *conn) {
+    if (conn->input_capacity - conn->input_length < CONNECTION_BUFFER_CAPACITY) {
+        size_t new_capacity = conn->input_capacity * 2;
+        if (new_capacity > MAX_LINE_LENGTH + CONNECTION_BUFFER_CAPACITY) {
+            return MEMORY_ERROR;
+        }
+        char *new_input = realloc(conn->input, new_capacity);
+        if (new_input == NULL) {
+            return MEMORY_ERROR;
+        }
+        conn->input = new_input;
+        conn->input_capacity = new_capacity;
+    }
+
+    ssize_t read_bytes = recv(conn->fd, conn->input + conn->input_length,
+                              conn->input_capacity - conn->input_length, 0);
+    if (read_bytes < 0) {
+        if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
+            return NO_ERROR;
+        }
+        return SYSTEM_ERROR;
+    }
+
+    if (read_bytes == 0) {
+        // Klient zakończył wysyłanie - ostatni wiersz może nie kończyć się znakiem
+        // nowej linii.
+        conn->input_closed = true;
+        conn->input_pending = conn->input_length;
+        if (conn->input_pending == 0) {
+            report_session_end(conn);
+        }
+        return NO_ERROR;
+    }
+
+    size_t previous_length = conn->input_length;
+    conn->input_length += (size_t)read_bytes;
+    char *last_newline = memrchr(conn->input + previous_length, '\n', (size_t)read_bytes);
+    if (last_newline == NULL) {
+        return conn->input_length > MAX_LINE_LENGTH ? MEMORY_ERROR : NO_ERROR;
+    }
+
+    conn->input_pending = (size_t)(last_newline - conn->input) + 1;
+    return NO_ERROR;
+}
+
+/** @brief Obsługuje zdarzenie na gnieździe połączenia.
+ * Wczytane wiersze wykonywane są porcjami, o ile po wysłaniu tego, co przyjmie
+ * gniazdo, zaległe odpowiedzi nie przekraczają @ref OUTPUT_HIGH_WATERMARK bajtów.
+ * @param[in,out] server  – wskaźnik na strukturę serwera,
+ * @param[in,out] conn    – wskaźnik na połączenie,
+ * @param[in] events      – maska zdarzeń zgłoszonych przez epoll.
+ */
+static void handle_connection_event(server_t *server, connection_t *conn,
+                                    uint32_t events) {
+    io_error_t error = NO_ERROR;
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !conn->input_closed &&
+        !conn->reading_paused) {
+        error = read_from_connection(conn);
+    }
+    if (error == NO_ERROR) {
+        error = output_buffer_flush(&conn->out);
+    }
+    if (error == NO_ERROR && conn->input_pending > 0 &&
+        conn->out.length <= OUTPUT_HIGH_WATERMARK && !conn->output_failed) {
+        run_pending_lines(conn);
+        error = output_buffer_flush(&conn->out);
+    }
+    if (error == NO_ERROR && conn->output_failed) {
+        error = SYSTEM_ERROR;
+    }
+    if (error == NO_ERROR && conn->input_closed && conn->input_pending == 0 &&
+        conn->out.length == 0) {
+        error = ENCOUNTERED_EOF;
+    }
+    if (error == NO_ERROR) {
+        error = update_connection_events(server, conn);
+    }
+
+    if (error != NO_ERROR) {
+        close_connection(server, conn);
+    }
+}
+
+/** @brief Przyjmuje wszystkie oczekujące połączenia.
+ * Gniazdo nasłuchujące zgłaszane jest przez epoll, dopóki czekają na nim
+ * połączenia, więc błąd, który by się powtarzał (np. brak wolnych deskryptorów),
+ * wyłącza je z epoll do czasu zamknięcia któregoś połączenia lub upływu
+ * @ref ACCEPT_RETRY_TIMEOUT_MS milisekund. Błędy dotyczące pojedynczego połączenia
+ * są pomijane.
+ * @param[in,out] server  – wskaźnik na strukturę serwera.
+ */
+static void accept_connections(server_t *server) {
+    while (true) {
+        int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO ||
+                errno == EPERM) {
+                continue;
+            }
+            const int listen_fd = server->listen_fd;
+            server->accepting_paused =
+                epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, listen_fd, NULL) == 0;
+            return;
+        }
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        connection_t *conn = calloc(1, sizeof(connection_t));
+        if (conn == NULL) {
+            close(fd);
+            continue;
+        }
+        conn->fd = fd;
+        conn->input = malloc(CONNECTION_BUFFER_CAPACITY);
+        conn->input_capacity = CONNECTION_BUFFER_CAPACITY;
+        io_error_t error = output_buffer_init_fd(&conn->out, fd, CONNECTION_BUFFER_CAPACITY);
+        struct epoll_event event = {.events = EPOLLIN, .data.ptr = conn};
+        if (conn->input == NULL || error != NO_ERROR ||
+            epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            output_buffer_free(&conn->out);
+            free(conn->input);
+            free(conn);
+            continue;
+        }
+        conn->out.flush = flush_connection_output;
+        conn->out.backend = conn;
+        if (batch_session_init(&conn->session, NULL, &conn->out, &conn->out,
+                               server->options) != NO_ERROR) {
+            epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+            close(fd);
+            output_buffer_free(&conn->out);
+            free(conn->input);
+            free(conn);
+            continue;
+        }
+
+        conn->next = server->connections;
+        if (server->connections != NULL) {
+            server->connections->prev = conn;
+        }
+        server->connections = conn;
+    }
+}
+
+/** @brief Tworzy gniazdo nasłuchujące na zadanym adresie.
+ * @param[in] address     – adres w postaci @p unix:ścieżka lub @p tcp:port.
+ * @param[out] listen_fd  – wskaźnik na komórkę, do której zapisany zostanie
+ *                          deskryptor gniazda.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p INVALID_VALUE
+ * jeżeli adres jest niepoprawny, @p SYSTEM_ERROR jeżeli wywołanie systemowe
+ * zakończyło się błędem.
+ */
+static io_error_t open_listening_socket(const char *address, int *listen_fd) {
+    struct sockaddr_un unix_address;
+    struct sockaddr_in tcp_address;
+    struct sockaddr *socket_address;
+    socklen_t address_length;
+    int domain;
+
+    if (strncmp(address, UNIX_ADDRESS_PREFIX, strlen(UNIX_ADDRESS_PREFIX)) == 0) {
+        const char *path = address + strlen(UNIX_ADDRESS_PREFIX);
+        if (path[0] == '\0' || strlen(path) >= sizeof(unix_address.sun_path)) {
+            return INVALID_VALUE;
+        }
+        memset(&unix_address, 0, sizeof(unix_address));
+        unix_address.sun_family = AF_UNIX;
+        strcpy(unix_address.sun_path, path);
+        unlink(path);
+        domain = AF_UNIX;
+        socket_address = (struct sockaddr *)&unix_address;
+        address_length = sizeof(unix_address);
+    } else if (strncmp(address, TCP_ADDRESS_PREFIX, strlen(TCP_ADDRESS_PREFIX)) == 0) {
+        char *end;
+        errno = 0;
+        unsigned long port = strtoul(address + strlen(TCP_ADDRESS_PREFIX), &end, 10);
+        if (errno != 0 || *end != '\0' || port == 0 || port > UINT16_MAX) {
+            return INVALID_VALUE;
+        }
+        memset(&tcp_address, 0, sizeof(tcp_address));
+        tcp_address.sin_family = AF_INET;
+        tcp_address.sin_port = htons((uint16_t)port);
+        tcp_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        domain = AF_INET;
+        socket_address = (struct sockaddr *)&tcp_address;
+        address_length = sizeof(tcp_address);
+    } else {
+        return INVALID_VALUE;
+    }
+
+    int fd = socket(domain, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return SYSTEM_ERROR;
+    }
+    int enable = 1;
+    if (domain == AF_INET) {
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    }
+    if (bind(fd, socket_address, address_length) != 0 || listen(fd, SOMAXCONN) != 0) {
+        close(fd);
+        return SYSTEM_ERROR;
+    }
+
+    *listen_fd = fd;
+    return NO_ERROR;
+}
+
+/** @brief Ustawia obsługę sygnałów kończących pracę serwera.
+ * Sygnały nie wznawiają przerwanych wywołań systemowych, dzięki czemu
+ * epoll_wait kończy się z błędem EINTR.
+ */
+static void install_signal_handlers(void) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+}
+
+io_error_t server_run_mode(const char *address, const batch_options_t *options) {
+    server_t server = {.listen_fd = -1,
+                       .epoll_fd = -1,
+                       .connections = NULL,
+                       .accepting_paused = false,
+                       .options = options};
+
+    io_error_t error = open_listening_socket(address, &server.listen_fd);
+    if (error != NO_ERROR) {
+        return error;
+    }
+
+    server.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event listen_event = {.events = EPOLLIN, .data.ptr = NULL};
+    if (server.epoll_fd < 0 ||
+        epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &listen_event) != 0) {
+        error = SYSTEM_ERROR;
+    }
+
+    install_signal_handlers();
+    struct epoll_event events[MAX_EVENTS];
+    while (error == NO_ERROR && !stop_requested) {
+        int ready = epoll_wait(server.epoll_fd, events, MAX_EVENTS,
+                               server.accepting_paused ? ACCEPT_RETRY_TIMEOUT_MS : -1);
+        if (ready == 0) {
+            resume_accepting(&server);
+        }
+        if (ready < 0) {
+            if (errno != EINTR) {
+                error = SYSTEM_ERROR;
+            }
+            continue;
+        }
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.ptr == NULL) {
+                accept_connections(&server);
+            } else {
+                handle_connection_event(&server, events[i].data.ptr, events[i].events);
+            }
+        }
+    }
+
+    while (server.connections != NULL) {
+        close_connection(&server, server.connections);
+    }
+    if (server.epoll_fd >= 0) {
+        close(server.epoll_fd);
+    }
+    close(server.listen_fd);
+    if (strncmp(address, UNIX_ADDRESS_PREFIX, strlen(UNIX_ADDRESS_PREFIX)) == 0) {
+        unlink(address + strlen(UNIX_ADDRESS_PREFIX));
+    }
+
+    return error;
+}
@@ -0,0 +1,31 @@
+/** @file
+ * Interfejs trybu serwera obsługującego wiele gier gamma jednocześnie.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef SERVER_MODE_H
+#define SERVER_MODE_H
+
+#include "batch_mode.h"
+#include "errors.h"
+
+/** @brief Uruchamia serwer gier w trybie wsadowym.
+ * Serwer nasłuchuje na gnieździe domeny uniksowej (adres postaci @p unix:ścieżka)
+ * lub na gnieździe TCP interfejsu loopback (adres postaci @p tcp:port).
+ * Każde połączenie to osobna gra: pierwszy poprawny wiersz @p B tworzy grę,
+ * a kolejne wiersze są poleceniami trybu wsadowego. Odpowiedzi i komunikaty
+ * o błędach są odsyłane tym samym połączeniem. Serwer działa do otrzymania
+ * sygnału SIGINT lub SIGTERM.
+ * @param[in] address    – adres, na którym serwer ma nasłuchiwać,
+ * @param[in] options    – wskaźnik na opcje trybu wsadowego wspólne dla wszystkich
+ *                         połączeń.
+ * @return Kod @p NO_ERROR jeżeli serwer zakończył się poprawnie, @p INVALID_VALUE
+ * jeżeli adres jest niepoprawny, @p MEMORY_ERROR jeżeli wystąpił błąd alokacji
+ * pamięci, @p SYSTEM_ERROR jeżeli wywołanie systemowe zakończyło się błędem.
+ */
+io_error_t server_run_mode(const char *address, const batch_options_t *options);
+
+#endif /* SERVER_MODE_H */
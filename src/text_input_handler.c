@@ -17,18 +17,19 @@
  * 13 > ceil(log10(UINT32_MAX)) = 10 */
 #define UINT32_LENGTH_UPPER_BOUND 13
 
-/** @brief Pomija znaki z stdin aż do znaku końca linii (włącznie).
+/** @brief Pomija znaki z wejścia aż do znaku końca linii (włącznie).
+ * @param[in,out] in      – wskaźnik na strukturę wejścia.
  * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p ENCOUNTERED_EOF
  * jeżeli dane wejściowe kończą się przed napotkaniem znaku nowej linii,
  * @p INVALID_CHARACTER, jeżeli przed znakiem nowej linii napotkano znaki inne niż
  * znaki białe.
  */
-static inline io_error_t skip_until_next_line() {
+static inline io_error_t skip_until_next_line(input_buffer_t *in) {
     int ch;
     io_error_t errcode = NO_ERROR;
 
     do {
-        ch = getchar();
+        ch = input_buffer_getc(in);
         if (ch == EOF) {
             return ENCOUNTERED_EOF;
         }
@@ -40,42 +41,45 @@ static inline io_error_t skip_until_next_line() {
     return errcode;
 }
 
-/** @brief Pomija białe znaki z stdin aż do następnego niebiałego znaku lub EOF. */
-static inline void skip_white_characters() {
+/** @brief Pomija białe znaki z wejścia aż do następnego niebiałego znaku lub EOF.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia.
+ */
+static inline void skip_white_characters(input_buffer_t *in) {
     int ch;
     do {
-        ch = getchar();
+        ch = input_buffer_getc(in);
         if (ch == EOF) {
             return;
         }
         if (!isspace(ch) || ch == '\n') {
-            ungetc(ch, stdin);
+            input_buffer_ungetc(in, ch);
         }
     } while (isspace(ch) && ch != '\n');
 }
 
-/** @brief Wczytuje zera wiodące i do 11 cyfr liczby z stdin.
+/** @brief Wczytuje zera wiodące i do 11 cyfr liczby z wejścia.
  * Bufor @p buffer musi mieć odpowiednio dużo miejsca na pomieszczenie wszystkich
  * znaków. Wynik zostaje automatycznie zakończony znakiem \0.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia,
  * @param[out] buffer      – wskaźnik na bufor wyjściowy.
  * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p ENCOUNTERED_EOF
  * jeżeli dane wejściowe kończą się przed napotkaniem znaku nowej linii,
  * @p INVALID_VALUE, jeżeli napotkany zostanie niespodziewany znak.
  */
-static io_error_t read_uint32_digits(char *buffer) {
+static io_error_t read_uint32_digits(input_buffer_t *in, char *buffer) {
     static const unsigned max_digits = 11;
     int ch;
     unsigned i = 0;
     bool first_char_zero = false;
     do {
-        ch = getchar();
+        ch = input_buffer_getc(in);
         if (ch == EOF) {
             return ENCOUNTERED_EOF;
         }
         if (i == 0 && ch == '0') {
             first_char_zero = true;
         } else if (!isdigit(ch)) {
-            ungetc(ch, stdin);
+            input_buffer_ungetc(in, ch);
             if (!isspace(ch)) {
                 return INVALID_VALUE;
             }
@@ -98,16 +102,18 @@ static io_error_t read_uint32_digits(char *buffer) {
     return NO_ERROR;
 }
 
-/** @brief Wczytuje następny int bez znaku z stdin.
+/** @brief Wczytuje następny int bez znaku z wejścia.
  * Pomija białe znaki przed liczbą oraz zera wiodące.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia,
+ * @param[out] ptr        – wskaźnik na komórkę, do której zapisana zostanie liczba.
  * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p ENCOUNTERED_EOF
  * jeżeli dane wejściowe kończą się przed napotkaniem znaku nowej linii,
  * @p INVALID_VALUE, jeżeli napotkany zostanie niespodziewany znak.
  */
-static inline io_error_t read_uint32(uint32_t *ptr) {
+static inline io_error_t read_uint32(input_buffer_t *in, uint32_t *ptr) {
     char buffer[UINT32_LENGTH_UPPER_BOUND];
-    skip_white_characters();
-    int error = read_uint32_digits(buffer);
+    skip_white_characters(in);
+    int error = read_uint32_digits(in, buffer);
     if (error != NO_ERROR) {
         return error;
     }
@@ -121,29 +127,30 @@ static inline io_error_t read_uint32(uint32_t *ptr) {
     return NO_ERROR;
 }
 
-/** @brief Wczytuje znak identyfikujący komendę z stdin.
+/** @brief Wczytuje znak identyfikujący komendę z wejścia.
+ * @param[in,out] in             – wskaźnik na strukturę wejścia,
  * @param[out] command           – wskaźnik na komórkę, gdzie ma zostać zapisany
  *                                 wczytany znak,
  * @param[in] allowed_commands   – ciąg dozwolonych identyfikatorów komend.
  * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p ENCOUNTERED_EOF
- * jeżeli na stdin nie ma żadnego znaku, @p LINE_IGNORED, jeżeli linijka jest pusta,
+ * jeżeli na wejściu nie ma żadnego znaku, @p LINE_IGNORED, jeżeli linijka jest pusta,
  * @p LINE_IGNORED, jeżeli linijka zaczyna się od znaku #, lub @p INVALID_VALUE,
  * jeżeli wczytany znak nie jest poprawnym identyfikatorem komendy.
  */
-static inline io_error_t read_command_char(char *command,
+static inline io_error_t read_command_char(input_buffer_t *in, char *command,
                                            const char *allowed_commands) {
-    int read_command = getchar();
+    int read_command = input_buffer_getc(in);
     switch (read_command) {
     case EOF:
         return ENCOUNTERED_EOF;
     case '\n':
         return LINE_IGNORED;
     case '#':
-        skip_until_next_line();
+        skip_until_next_line(in);
         return LINE_IGNORED;
     default:
         if (strchr(allowed_commands, read_command) == NULL) {
-            skip_until_next_line();
+            skip_until_next_line(in);
             return INVALID_VALUE;
         }
         *command = (char)read_command;
@@ -167,33 +174,34 @@ static inline unsigned get_command_arguments_count(char command) {
 }
 
 /** @brief Wczytuje argumenty komendy.
- * Wczytuje argumenty komendy ze standardowego wejścia. W razie wystąpienia problemu
+ * Wczytuje argumenty komendy z wejścia. W razie wystąpienia problemu
  * pomija wszystkie znaki do końca wiersza.
+ * @param[in,out] in     – wskaźnik na strukturę wejścia,
  * @param[in] command    – znak identyfikujący komendę,
  * @param[out] args      – wskaźnik na tablicę argumentów (co najmniej 4 pola).
  * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p ENCOUNTERED_EOF
  * jeżeli dane wejściowe kończą się przed wczytaniem wszystkich argumentów,
  * @p INVALID_VALUE, jeżeli napotkany zostanie niespodziewany znak.
  */
-static io_error_t read_arguments(char command,
+static io_error_t read_arguments(input_buffer_t *in, char command,
                                  uint32_t args[COMMAND_ARGUMENTS_UPPER_BOUND]) {
     unsigned arguments_count = get_command_arguments_count(command);
     if (arguments_count) {
-        int ch = getchar();
+        int ch = input_buffer_getc(in);
         if (!isspace(ch) || ch == '\n') {
-            ungetc(ch, stdin);
-            skip_until_next_line();
+            input_buffer_ungetc(in, ch);
+            skip_until_next_line(in);
             return INVALID_VALUE;
         }
     }
 
     io_error_t error;
     for (unsigned i = 0; i < arguments_count; i++) {
-        if ((error = read_uint32(&args[i])) != NO_ERROR) {
+        if ((error = read_uint32(in, &args[i])) != NO_ERROR) {
             if (error == ENCOUNTERED_EOF) {
                 return ENCOUNTERED_EOF;
             } else {
-                skip_until_next_line();
+                skip_until_next_line(in);
                 return error;
             }
         }
@@ -202,16 +210,16 @@ static io_error_t read_arguments(char command,
     return NO_ERROR;
 }
 
-io_error_t text_input_read_next_command(char *command, uint32_t *args,
-                                        const char *allowed_commands) {
+io_error_t text_input_read_next_command(input_buffer_t *in, char *command,
+                                        uint32_t *args, const char *allowed_commands) {
     io_error_t error;
-    if ((error = read_command_char(command, allowed_commands)) != NO_ERROR) {
+    if ((error = read_command_char(in, command, allowed_commands)) != NO_ERROR) {
         return error;
     }
-    if (read_arguments(*command, args) != NO_ERROR) {
+    if (read_arguments(in, *command, args) != NO_ERROR) {
         return INVALID_VALUE;
     }
-    if (skip_until_next_line() != NO_ERROR) {
+    if (skip_until_next_line(in) != NO_ERROR) {
         return INVALID_VALUE;
     }
 
@@ -9,6 +9,7 @@
 #ifndef TEXT_INPUT_HANDLER_H
 #define TEXT_INPUT_HANDLER_H
 
+#include "buffered_io.h"
 #include "errors.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -17,6 +18,7 @@
 #define COMMAND_ARGUMENTS_UPPER_BOUND 4
 
 /** @brief Wczytuje parametry następnej komendy.
+ * @param[in,out] in           – wskaźnik na strukturę wejścia,
  * @param[out] command         – wskaźnik na znak oznaczający typ komendy,
  * @param[out] args            – wskaźnik na tablicę argumentów (co najmniej 4 pola),
  * @param[in] allowed_commands – ciąg dozwolonych identyfikatorów komend.
@@ -25,7 +27,7 @@
  * jeżeli wartości parametrów lub polecenie są niepoprawne, @p LINE_IGNORED,
  * jeżeli wiersz jest pusty lub zaczyna się znakiem #.
  */
-io_error_t text_input_read_next_command(char *command, uint32_t *args,
-                                        const char *allowed_commands);
+io_error_t text_input_read_next_command(input_buffer_t *in, char *command,
+                                        uint32_t *args, const char *allowed_commands);
 
 #endif /* TEXT_INPUT_HANDLER_H */
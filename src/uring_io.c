@@ -0,0 +1,490 @@
+/** @file
+ * Implementacja buforowanego wejścia i wyjścia opartej na io_uring.
+ * Moduł korzysta bezpośrednio z wywołań systemowych io_uring_setup
+ * i io_uring_enter, więc nie wymaga biblioteki liburing. Bez makra
+ * GAMMA_IO_URING funkcje inicjujące zawsze wybierają zwykłe wejście i wyjście.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+/** _GNU_SOURCE - wymagane, aby dostępne były funkcja syscall i flaga MAP_POPULATE */
+#define _GNU_SOURCE
+
+#include "uring_io.h"
+
+#ifdef GAMMA_IO_URING
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/** Liczba odczytów będących jednocześnie w toku. */
+#define URING_READ_AHEAD 4
+/** Liczba pozycji kolejki zgłoszeń. */
+#define URING_ENTRIES 8
+/** Oznaczenie braku bufora odczytu udostępnionego parserowi. */
+#define NO_SLOT URING_READ_AHEAD
+/** Przesunięcie oznaczające zapis na aktualnej pozycji pliku. */
+#define CURRENT_POSITION ((uint64_t)-1)
+
+/**
+ * Struktura przechowująca odwzorowane w pamięci kolejki io_uring.
+ */
+typedef struct uring {
+    int fd;                     /**< Deskryptor instancji io_uring. */
+    unsigned *sq_tail;          /**< Koniec kolejki zgłoszeń. */
+    unsigned *sq_mask;          /**< Maska indeksów kolejki zgłoszeń. */
+    unsigned *sq_array;         /**< Tablica indeksów zgłoszeń. */
+    unsigned *cq_head;          /**< Początek kolejki zakończeń. */
+    unsigned *cq_tail;          /**< Koniec kolejki zakończeń. */
+    unsigned *cq_mask;          /**< Maska indeksów kolejki zakończeń. */
+    struct io_uring_sqe *sqes;  /**< Tablica zgłoszeń. */
+    struct io_uring_cqe *cqes;  /**< Tablica zakończeń. */
+    void *sq_ring;              /**< Odwzorowanie kolejki zgłoszeń. */
+    void *cq_ring;              /**< Odwzorowanie kolejki zakończeń. */
+    size_t sq_ring_size;        /**< Rozmiar odwzorowania kolejki zgłoszeń. */
+    size_t cq_ring_size;        /**< Rozmiar odwzorowania kolejki zakończeń. */
+    size_t sqes_size;           /**< Rozmiar odwzorowania tablicy zgłoszeń. */
+    unsigned features;          /**< Funkcje obsługiwane przez jądro. */
+} uring_t;
+
+/**
+ * Struktura przechowująca stan wejścia czytającego z wyprzedzeniem.
+ * Bufory odczytu zlecane są cyklicznie; parser dostaje je w tej samej kolejności.
+ */
+typedef struct uring_input {
+    uring_t ring;                          /**< Kolejki io_uring. */
+    char *slots[URING_READ_AHEAD];         /**< Bufory odczytu. */
+    uint64_t offsets[URING_READ_AHEAD];    /**< Przesunięcia odczytów w pliku. */
+    int32_t results[URING_READ_AHEAD];     /**< Wyniki zakończonych odczytów. */
+    bool completed[URING_READ_AHEAD];      /**< Informacja czy odczyt się zakończył. */
+    unsigned current;      /**< Bufor udostępniony parserowi lub @p NO_SLOT. */
+    unsigned next;         /**< Bufor, który parser dostanie jako następny. */
+    unsigned in_flight;    /**< Liczba odczytów w toku. */
+    uint64_t next_offset;  /**< Przesunięcie następnego zlecanego odczytu. */
+    bool eof;              /**< Informacja czy osiągnięto koniec pliku. */
+} uring_input_t;
+
+/**
+ * Struktura przechowująca stan wyjścia z podwójnym buforowaniem.
+ */
+typedef struct uring_output {
+    uring_t ring;              /**< Kolejki io_uring. */
+    char *spare;               /**< Bufor niewykorzystywany w danej chwili. */
+    size_t spare_capacity;     /**< Rozmiar bufora @p spare. */
+    bool write_in_flight;      /**< Informacja czy zapis bufora @p spare trwa. */
+    size_t in_flight_length;   /**< Długość trwającego zapisu. */
+} uring_output_t;
+
+/** @brief Tworzy instancję io_uring i odwzorowuje jej kolejki w pamięci.
+ * @param[out] ring       – wskaźnik na inicjowaną strukturę.
+ * @return Wartość @p true, jeżeli operacja się powiodła, @p false jeżeli io_uring
+ * jest niedostępny.
+ */
+static bool uring_setup(uring_t *ring) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, URING_ENTRIES, &params);
+    if (fd < 0) {
+        return false;
+    }
+
+    ring->fd = fd;
+    ring->features = params.features;
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap && ring->cq_ring_size > ring->sq_ring_size) {
+        ring->sq_ring_size = ring->cq_ring_size;
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = single_mmap ? ring->sq_ring
+                                : mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    void *sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED ||
+        sqes == MAP_FAILED) {
+        if (ring->sq_ring != MAP_FAILED) {
+            munmap(ring->sq_ring, ring->sq_ring_size);
+        }
+        if (!single_mmap && ring->cq_ring != MAP_FAILED) {
+            munmap(ring->cq_ring, ring->cq_ring_size);
+        }
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, ring->sqes_size);
+        }
+        close(fd);
+        return false;
+    }
+
+    char *sq = ring->sq_ring, *cq = ring->cq_ring;
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    ring->sqes = sqes;
+    return true;
+}
+
+/** @brief Zamyka instancję io_uring.
+ * @param[in,out] ring    – wskaźnik na strukturę kolejek.
+ */
+static void uring_close(uring_t *ring) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+}
+
+/** @brief Zleca operację odczytu lub zapisu.
+ * @param[in,out] ring    – wskaźnik na strukturę kolejek,
+ * @param[in] opcode      – kod operacji (IORING_OP_READ lub IORING_OP_WRITE),
+ * @param[in] fd          – deskryptor pliku,
+ * @param[in] data        – wskaźnik na bufor,
+ * @param[in] length      – długość bufora,
+ * @param[in] offset      – przesunięcie w pliku,
+ * @param[in] user_data   – wartość zwracana wraz z wynikiem operacji.
+ * @return Wartość @p true, jeżeli zlecenie zostało przyjęte.
+ */
+static bool uring_submit(uring_t *ring, uint8_t opcode, int fd, char *data,
+                         size_t length, uint64_t offset, uint64_t user_data) {
+    unsigned tail = *ring->sq_tail;
+    unsigned index = tail & *ring->sq_mask;
+    struct io_uring_sqe *sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)data;
+    sqe->len = (uint32_t)length;
+    sqe->off = offset;
+    sqe->user_data = user_data;
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    long submitted;
+    do {
+        submitted = syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0);
+    } while (submitted < 0 && errno == EINTR);
+    return submitted == 1;
+}
+
+/** @brief Czeka na zakończenie dowolnej zleconej operacji.
+ * @param[in,out] ring    – wskaźnik na strukturę kolejek,
+ * @param[out] user_data  – wartość przekazana przy zleceniu operacji,
+ * @param[out] result     – wynik operacji.
+ * @return Wartość @p true, jeżeli odebrano wynik operacji.
+ */
+static bool uring_wait(uring_t *ring, uint64_t *user_data, int32_t *result) {
+    while (true) {
+        unsigned head = *ring->cq_head;
+        if (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            *user_data = cqe->user_data;
+            *result = cqe->res;
+            __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+        long error = syscall(__NR_io_uring_enter, ring->fd, 0, 1,
+                             IORING_ENTER_GETEVENTS, NULL, 0);
+        if (error < 0 && errno != EINTR) {
+            return false;
+        }
+    }
+}
+
+/** @brief Zleca odczyt następnego fragmentu pliku do zadanego bufora.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia,
+ * @param[in] slot        – numer bufora odczytu.
+ */
+static void submit_read(input_buffer_t *in, unsigned slot) {
+    uring_input_t *backend = in->backend;
+    backend->offsets[slot] = backend->next_offset;
+    backend->completed[slot] = false;
+    if (uring_submit(&backend->ring, IORING_OP_READ, in->fd, backend->slots[slot],
+                     in->capacity, backend->next_offset, slot)) {
+        backend->in_flight++;
+    } else {
+        // Nieudane zlecenie traktujemy jak koniec pliku w tym miejscu.
+        backend->completed[slot] = true;
+        backend->results[slot] = 0;
+    }
+    backend->next_offset += in->capacity;
+}
+
+/** @brief Czeka na zakończenie odczytu do zadanego bufora.
+ * @param[in,out] backend – wskaźnik na stan wejścia,
+ * @param[in] slot        – numer bufora odczytu.
+ */
+static void wait_for_slot(uring_input_t *backend, unsigned slot) {
+    while (!backend->completed[slot]) {
+        uint64_t finished;
+        int32_t result;
+        if (!uring_wait(&backend->ring, &finished, &result)) {
+            backend->completed[slot] = true;
+            backend->results[slot] = 0;
+            return;
+        }
+        backend->completed[finished] = true;
+        backend->results[finished] = result;
+        backend->in_flight--;
+    }
+}
+
+/** @brief Ponawia odczyty z wyprzedzeniem po krótkim odczycie.
+ * Krótki odczyt przed końcem pliku unieważnia przesunięcia kolejnych odczytów,
+ * więc czekamy na wszystkie odczyty w toku i zlecamy je od nowa.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia,
+ * @param[in] slot        – numer bufora, którego odczyt był krótki.
+ */
+static void resynchronize_reads(input_buffer_t *in, unsigned slot) {
+    uring_input_t *backend = in->backend;
+    for (unsigned i = 0; i < URING_READ_AHEAD; i++) {
+        wait_for_slot(backend, i);
+    }
+    backend->next_offset = backend->offsets[slot] + (uint64_t)backend->results[slot];
+    for (unsigned i = 1; i < URING_READ_AHEAD; i++) {
+        submit_read(in, (slot + i) % URING_READ_AHEAD);
+    }
+}
+
+/** @brief Udostępnia parserowi następny wczytany fragment pliku.
+ * Bufor oddany przez parser jest od razu zlecany do ponownego odczytu.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia.
+ * @return Kod @p NO_ERROR jeżeli wczytano nowe dane, @p ENCOUNTERED_EOF
+ * w przeciwnym przypadku.
+ */
+static io_error_t refill_from_uring(input_buffer_t *in) {
+    uring_input_t *backend = in->backend;
+    if (in->tied_output != NULL) {
+        output_buffer_flush(in->tied_output);
+    }
+    if (backend->eof) {
+        return ENCOUNTERED_EOF;
+    }
+    if (backend->current != NO_SLOT) {
+        submit_read(in, backend->current);
+        backend->current = NO_SLOT;
+    }
+
+    unsigned slot = backend->next;
+    wait_for_slot(backend, slot);
+    int32_t result = backend->results[slot];
+    if (result <= 0) {
+        backend->eof = true;
+        return ENCOUNTERED_EOF;
+    }
+    if ((size_t)result < in->capacity) {
+        resynchronize_reads(in, slot);
+    }
+
+    in->data = backend->slots[slot];
+    in->position = 0;
+    in->length = (size_t)result;
+    backend->current = slot;
+    backend->next = (slot + 1) % URING_READ_AHEAD;
+    return NO_ERROR;
+}
+
+/** @brief Czeka na odczyty w toku i zwalnia zasoby wejścia.
+ * @param[in,out] in      – wskaźnik na strukturę wejścia.
+ */
+static void release_uring_input(input_buffer_t *in) {
+    uring_input_t *backend = in->backend;
+    for (unsigned i = 0; i < URING_READ_AHEAD; i++) {
+        if (backend->current != i) {
+            wait_for_slot(backend, i);
+        }
+        free(backend->slots[i]);
+    }
+    uring_close(&backend->ring);
+    free(backend);
+    in->backend = NULL;
+}
+
+io_error_t input_buffer_init_uring(input_buffer_t *in, int fd, size_t capacity) {
+    struct stat file_status;
+    off_t start = lseek(fd, 0, SEEK_CUR);
+    if (fstat(fd, &file_status) != 0 || !S_ISREG(file_status.st_mode) || start < 0) {
+        return input_buffer_init_fd(in, fd, capacity);
+    }
+
+    uring_input_t *backend = calloc(1, sizeof(uring_input_t));
+    if (backend == NULL) {
+        return MEMORY_ERROR;
+    }
+    if (!uring_setup(&backend->ring)) {
+        free(backend);
+        return input_buffer_init_fd(in, fd, capacity);
+    }
+    for (unsigned i = 0; i < URING_READ_AHEAD; i++) {
+        backend->slots[i] = malloc(capacity);
+        if (backend->slots[i] == NULL) {
+            while (i-- > 0) {
+                free(backend->slots[i]);
+            }
+            uring_close(&backend->ring);
+            free(backend);
+            return MEMORY_ERROR;
+        }
+    }
+
+    in->data = NULL;
+    in->position = 0;
+    in->length = 0;
+    in->capacity = capacity;
+    in->fd = fd;
+    in->tied_output = NULL;
+    in->refill = refill_from_uring;
+    in->release = release_uring_input;
+    in->backend = backend;
+
+    backend->current = NO_SLOT;
+    backend->next = 0;
+    backend->next_offset = (uint64_t)start;
+    for (unsigned i = 0; i < URING_READ_AHEAD; i++) {
+        submit_read(in, i);
+    }
+    return NO_ERROR;
+}
+
+/** @brief Czeka na zakończenie trwającego zapisu.
+ * Jeżeli zapis był krótki, dopisuje resztę danych synchronicznie.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p SYSTEM_ERROR
+ * jeżeli zapis się nie powiódł.
+ */
+static io_error_t wait_for_write(output_buffer_t *out) {
+    uring_output_t *backend = out->backend;
+    if (!backend->write_in_flight) {
+        return NO_ERROR;
+    }
+    backend->write_in_flight = false;
+
+    uint64_t user_data;
+    int32_t result;
+    if (!uring_wait(&backend->ring, &user_data, &result) || result < 0) {
+        return SYSTEM_ERROR;
+    }
+
+    size_t written = (size_t)result;
+    while (written < backend->in_flight_length) {
+        ssize_t part = write(out->fd, backend->spare + written,
+                             backend->in_flight_length - written);
+        if (part < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return SYSTEM_ERROR;
+        }
+        written += (size_t)part;
+    }
+    return NO_ERROR;
+}
+
+/** @brief Zleca zapis zawartości bufora i udostępnia drugi bufor.
+ * W toku jest co najwyżej jeden zapis, więc kolejność danych jest zachowana
+ * także dla potoków i plików otwartych w trybie dopisywania.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p SYSTEM_ERROR
+ * jeżeli zapis się nie powiódł.
+ */
+static io_error_t flush_to_uring(output_buffer_t *out) {
+    uring_output_t *backend = out->backend;
+    io_error_t error = wait_for_write(out);
+    if (error != NO_ERROR) {
+        out->length = 0;
+        return error;
+    }
+
+    char *data = out->data;
+    size_t capacity = out->capacity;
+    if (!uring_submit(&backend->ring, IORING_OP_WRITE, out->fd, data, out->length,
+                      CURRENT_POSITION, 0)) {
+        out->length = 0;
+        return SYSTEM_ERROR;
+    }
+    backend->write_in_flight = true;
+    backend->in_flight_length = out->length;
+
+    out->data = backend->spare;
+    out->capacity = backend->spare_capacity;
+    out->length = 0;
+    backend->spare = data;
+    backend->spare_capacity = capacity;
+    return NO_ERROR;
+}
+
+/** @brief Czeka na trwający zapis i zwalnia zasoby wyjścia.
+ * @param[in,out] out     – wskaźnik na strukturę wyjścia.
+ */
+static void release_uring_output(output_buffer_t *out) {
+    uring_output_t *backend = out->backend;
+    wait_for_write(out);
+    free(backend->spare);
+    uring_close(&backend->ring);
+    free(backend);
+    out->backend = NULL;
+}
+
+io_error_t output_buffer_init_uring(output_buffer_t *out, int fd, size_t capacity) {
+    uring_output_t *backend = calloc(1, sizeof(uring_output_t));
+    if (backend == NULL) {
+        return MEMORY_ERROR;
+    }
+    if (!uring_setup(&backend->ring)) {
+        free(backend);
+        return output_buffer_init_fd(out, fd, capacity);
+    }
+    if (!(backend->ring.features & IORING_FEAT_RW_CUR_POS)) {
+        uring_close(&backend->ring);
+        free(backend);
+        return output_buffer_init_fd(out, fd, capacity);
+    }
+
+    io_error_t error = output_buffer_init_fd(out, fd, capacity);
+    backend->spare = malloc(capacity);
+    backend->spare_capacity = capacity;
+    if (error != NO_ERROR || backend->spare == NULL) {
+        if (error == NO_ERROR) {
+            output_buffer_free(out);
+        }
+        uring_close(&backend->ring);
+        free(backend->spare);
+        free(backend);
+        return MEMORY_ERROR;
+    }
+
+    out->flush = flush_to_uring;
+    out->release = release_uring_output;
+    out->backend = backend;
+    return NO_ERROR;
+}
+
+#else /* GAMMA_IO_URING */
+
+io_error_t input_buffer_init_uring(input_buffer_t *in, int fd, size_t capacity) {
+    return input_buffer_init_fd(in, fd, capacity);
+}
+
+io_error_t output_buffer_init_uring(output_buffer_t *out, int fd, size_t capacity) {
+    return output_buffer_init_fd(out, fd, capacity);
+}
+
+#endif /* GAMMA_IO_URING */
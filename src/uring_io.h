@@ -0,0 +1,38 @@
+/** @file
+ * Interfejs implementacji buforowanego wejścia i wyjścia opartej na io_uring.
+ *
+ * @author Jakub Moliński <jm419502@students.mimuw.edu.pl>
+ * @copyright Uniwersytet Warszawski
+ * @date 16.10.2026
+ */
+
+#ifndef URING_IO_H
+#define URING_IO_H
+
+#include "buffered_io.h"
+
+/** @brief Inicjuje buforowane wejście czytające z deskryptora przez io_uring.
+ * Kilka odczytów kolejnych fragmentów pliku jest w toku jednocześnie, zanim
+ * parser ich zażąda. Jeżeli io_uring jest niedostępny lub deskryptor nie wskazuje
+ * na zwykły plik, inicjuje zwykłe wejście jak @ref input_buffer_init_fd.
+ * @param[out] in         – wskaźnik na inicjowaną strukturę,
+ * @param[in] fd          – deskryptor pliku,
+ * @param[in] capacity    – rozmiar jednego bufora odczytu.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci.
+ */
+io_error_t input_buffer_init_uring(input_buffer_t *in, int fd, size_t capacity);
+
+/** @brief Inicjuje buforowane wyjście zapisujące do deskryptora przez io_uring.
+ * Opróżnienie bufora zleca zapis i nie czeka na jego zakończenie - dalsze dane
+ * trafiają do drugiego bufora. Jeżeli io_uring jest niedostępny, inicjuje zwykłe
+ * wyjście jak @ref output_buffer_init_fd.
+ * @param[out] out        – wskaźnik na inicjowaną strukturę,
+ * @param[in] fd          – deskryptor pliku,
+ * @param[in] capacity    – rozmiar bufora.
+ * @return Kod @p NO_ERROR jeżeli operacja przebiegła poprawnie, @p MEMORY_ERROR
+ * jeżeli nie udało się zaalokować pamięci.
+ */
+io_error_t output_buffer_init_uring(output_buffer_t *out, int fd, size_t capacity);
+
+#endif /* URING_IO_H */